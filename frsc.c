@@ -5,29 +5,66 @@ frsc.c: S.W. Ellingson, Virginia Tech, 2014 Jan 26
 COMPILE: (see makefile)
 ---
 COMMAND LINE SYNTAX, INPUT, OUTPUT: 
-  frsc <job_file> 
+  frsc <job_file> [<job_file> ...] [--resume]
   <job_file>:   ASCII file defining what we're supposed to do. See ra_read_jobfile() for format.
+                With more than one, the jobs share one pass over the (same) data file (see ra_fan.c)
+  --resume:     continue from the last checkpoint, if any (see ra_ckpt.c)
 
 See end of this file for history.
 
 ============================================================================*/
 #define RA_H_RA_VERSION 1
+#define _GNU_SOURCE    /* sched_setaffinity(), CPU_SET(); see ra_arena.c */
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h> /* for struct timeval, malloc() */
 #include <time.h>
 #include <math.h>
+#include <float.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h> /* SSE2 intrinsics; ra_deinterleave() */
+#endif
+
+#define RA_MAX_FILENAME_LENGTH 1024
 
 #include "ra_aux.c"            /* auxilliary (support) code, put here to avoid cluttering up this file */
 #include "ra_format.c"         /* output format definition */
 #include "ra_format_defines.h" /* macro defines for field values in ra_format.c */
+#include "ra_prof.c"           /* per-stage profiling */
+#include "ra_arena.c"          /* working memory, allocated once */
+#include "ra_moments.c"        /* exact, mergeable moment accumulators */
+#include "ra_kernels.c"        /* specialized time-domain analysis kernels */
+#include "ra_compress.c"       /* compression of the report stream */
+#include "ra_columns.c"        /* columnar statistics store */
+#include "ra_stream.c"         /* publishing reports on a socket */
+#include "ra_shm.c"            /* publishing reports in shared memory */
+#include "ra_suppress.c"       /* change-triggered suppression of reports */
+#include "ra_output.c"         /* where reports go */
 #include "ra_read_jobfile.c"   /* code that reads jobfile */
 #include "ra_guppi_file.c"     /* code that reads GUPPI raw data file */
+#include "ra_slide.c"          /* sliding windows */
+#include "ra_plan.c"           /* which channels get analyzed, and where their data are */
+#include "ra_lag.c"            /* real-time deadline monitor, and graceful degradation */
+#include "ra_mem.c"            /* RAM budget, and bounded-memory streaming */
 #include "ra_analyze.c"        /* analysis; called from ra_swallow() */
 #include "ra_swallow.c"        /* copies data from raw sample blocks into rate-T0 and -T1 buffers, launches analysis as needed */
-
-#define RA_MAX_FILENAME_LENGTH 1024
+#include "ra_ckpt.c"           /* checkpoints, and resuming */
+#include "ra_par.c"            /* parallel processing of one file, by block ranges */
+#include "ra_fan.c"            /* several jobs in one pass over the file */
 
 /*************************************************************************/
 /*** main() **************************************************************/
@@ -45,8 +82,9 @@ main ( int narg, char *argv[] ) {
   
   struct ra_header_struct header0; /* output report header; contains parameters that define operation; prototype for all headers created later */
   char infile[RA_MAX_FILENAME_LENGTH]; /* name of input data file (used when raw data file mode selected) */
+  struct ra_opt_struct opt;            /* operating options from jobfile */
 
-  FILE *fp_out;
+  struct ra_out_struct out;            /* where reports go */
   FILE *fp_in;             
 
   char rg_header[RG_MAX_HEADER_LENGTH];
@@ -64,6 +102,7 @@ main ( int narg, char *argv[] ) {
   double time1 = 0;   /* [s] accumulated time spent duing Activity 1 */
   struct timeval tv2; 
   double time2 = 0;   /* [s] accumulated time spent duing Activity 2 */
+  long int tp;        /* [ns] per-stage profiling; see ra_prof.c */
 
   int overlap=0;
   float obsfreq;            /* OBSFREQ */
@@ -72,20 +111,32 @@ main ( int narg, char *argv[] ) {
   int obsnchan;             /* OBSNCHAN */
   double fs;                /* 1/TBIN */
 
+  struct ra_plan_struct plan;  /* channels to be analyzed */
+  struct ra_slide_struct slide; /* sliding windows, if HOP */
+  long int nWin = 0;            /* hops per T0, if HOP */
+  struct ra_lag_struct lag;     /* real-time deadline monitor, if LAG_BUDGET */
+  struct ra_mem_struct mem;     /* RAM budget; pieces and tiles, if MAX_MEMORY */
+  struct ra_work_struct work;   /* working memory (see ra_arena.c) */
+  struct ra_ckpt_struct ckpt;   /* checkpoint (see ra_ckpt.c) */
+  int bResume = 0;              /* --resume */
+  long int tCkpt = 0;           /* [ns] when the next checkpoint is due */
+  struct ra_fan_struct *fan = NULL; /* jobs after the first (see ra_fan.c) */
+  int nFan = 0;
+  long int nAvail;              /* samples per channel in a block, excluding overlap */
+  long int pos0;                /* ftell() at the start of a block's data; if read in pieces */
+  long int n0, n;               /* piece */
   signed char *blk0; /* allocated below */
   long int nT0;
   long int blk0_ptr;
   double fstart0 = 0; 
 
-  signed char *blk1; /* allocated below */
   long int nT1;
-  long int blk1_ptr;
-  double fstart1 = 0; 
 
   /* scratch variables */
   int eStatus; /* used for returned error codes */
   long int l;
   long int m;
+  int i;
   //signed char x_temp;      
 
   /*=====================*/
@@ -107,6 +158,7 @@ main ( int narg, char *argv[] ) {
   memset(jobfile,'\0',RA_MAX_FILENAME_LENGTH);  /* just in case */
   if (narg>=2) {
       sscanf( argv[1], "%s", jobfile );
+      for (i=2;i<narg;i++) if (strcmp(argv[i],"--resume")==0) { bResume = 1; } else { nFan++; }
     } else {
       printf("FATAL: main(): <jobfile> not specified\n");
       return;
@@ -114,21 +166,79 @@ main ( int narg, char *argv[] ) {
   printf("<jobfile>='%s'\n",jobfile);
 
   /* read the jobfile, initialize header */
-  if ( eStatus = ra_read_jobfile( jobfile, &header0, infile ) ) {
+  if ( eStatus = ra_read_jobfile( jobfile, &header0, infile, &opt ) ) {
     printf("FATAL: main(): ra_read_jobfile() failed with code %d\n",eStatus);
     return;
     }
 
   printf("Here are some things I learned from the jobfile:\n");
   printf("  header0.esource = %d\n",header0.eSource);
+  printf("  opt.outfile = '%s', opt.eOutFormat = %d\n",opt.outfile,opt.eOutFormat);
+
+  /* more job files: each is a chain, fed the blocks read for this one (see ra_fan.c) */
+  if (nFan) {
+    if (nFan+1>RA_FAN_MAX_JOBS) {
+      printf("FATAL: main(): at most %d job files\n",RA_FAN_MAX_JOBS);
+      return;
+      }
+    if ( (opt.nWorkers>1) || (opt.checkpoint>0) || bResume ) {
+      printf("WARNING: main(): WORKERS, CHECKPOINT, and --resume are ignored with more than one job file\n");
+      opt.nWorkers = 0;
+      opt.checkpoint = 0;
+      bResume = 0;
+      }
+    if ((fan = malloc( nFan*sizeof(struct ra_fan_struct) ))==NULL) {
+      printf("FATAL: main(): malloc() failed\n");
+      return;
+      }
+    for (i=0,m=2;m<narg;m++) {
+      if (strcmp(argv[m],"--resume")==0) continue;
+      if (ra_fan_open( fan, i++, argv[m], infile, &opt )) return;
+      }
+    }
+  if ( (opt.nWorkers>1) && (opt.profile>0) ) {
+    printf("WARNING: main(): PROFILE reports aren't written with WORKERS (PROFILE_FILE is)\n");
+    opt.profile = 0;
+    }
+  ra_prof_start( opt.profile, opt.profileFile );
 
   /*==================*/
   /*=== Initialize ===*/
   /*==================*/
 
-  /* open output file */
-  system("rm out.dat"); /* just in case */
-  fp_out = fopen("out.dat","wb");
+  /* resuming? (see ra_ckpt.c) */
+  if (bResume) {
+    if (access( opt.ckptFile, F_OK )) {
+        printf("main(): no checkpoint ('%s'); starting from the beginning\n",opt.ckptFile);
+        bResume = 0;
+      } else if (ra_ckpt_read( opt.ckptFile, &ckpt )) {
+        return;
+      }
+    }
+
+  /* open output file (if resuming, what's there is truncated to what the checkpoint accounts for) */
+  if (ra_out_open( &out, opt.outfile, opt.eOutFormat, opt.nColChunk, bResume ? ckpt.offset : -1 )) {
+    printf("FATAL: main(): ra_out_open() failed\n");
+    return;
+    }
+  if (opt.stream[0]) {
+    if (ra_out_stream( &out, opt.stream, opt.nStreamQueue, opt.eStreamPolicy )) {
+      printf("FATAL: main(): ra_out_stream() failed\n");
+      return;
+      }
+    }
+  if (opt.shm[0]) {
+    if (ra_out_shm( &out, opt.shm, opt.nShmSize )) {
+      printf("FATAL: main(): ra_out_shm() failed\n");
+      return;
+      }
+    }
+  if (opt.bSuppress) {
+    if (ra_out_suppress( &out, opt.rSuppressPower, opt.dSuppressKurt, opt.dSuppressClips, opt.heartbeat )) {
+      printf("FATAL: main(): ra_out_suppress() failed\n");
+      return;
+      }
+    }
  
   /* attempt to open input file */
   if (!(fp_in = fopen(infile,"rb"))) {
@@ -136,13 +246,8 @@ main ( int narg, char *argv[] ) {
     return;
     }
 
-  /* allocate memory for the input raw data block */
-  if ( (blk = malloc( RG_BLK_SIZE * sizeof(*blk) ) ) == NULL ) {
-    printf("FATAL: main(): malloc() of blk failed\n"); 
-    return;
-    }
-
   /* read GUPPI header */
+  tp = ra_prof_now();
   rg_read_header(fp_in,&fpos,rg_header);
   //printf("Header is %d bytes\n",(int)strlen(rg_header));
   //printf("End of header is at byte %ld (counting from 1)\n",fpos);
@@ -154,6 +259,7 @@ main ( int narg, char *argv[] ) {
     printf("%s\n",rg_header);
     return;
     }
+  RA_PROF_ADD(RA_PROF_HEADER,tp);
 
   printf("Here is what I learned from the header:\n");
   printf("  rg_analyze_header() says OVERLAP = %d samples\n",overlap);
@@ -171,8 +277,8 @@ main ( int narg, char *argv[] ) {
   header0.fc  = obsfreq*(1.0e+6);  /* [Hz] Center frequency for "full bandwidth" = OBSFREQ*(1e+6) */
   header0.fs  = fs;                /* [Hz] Sample rate per-channel = 1/TBIN */
 
-  /* Write a header and flush stream */
-  fwrite( &header0, sizeof(struct ra_header_struct), 1, fp_out ); fflush(fp_out);
+  /* Write a header (unless resuming: it's already there) */
+  if (!bResume) ra_out_write( &out, &header0, NULL );
 
   ///* DIAGNOSTIC: Checking channel bits */
   //for (l=1;l<=obsnchan;l++) { /* note..starting from 1 here! */
@@ -183,24 +289,95 @@ main ( int narg, char *argv[] ) {
   /* Allocating sample buffer memory */
   nT0 = ( header0.T0 * header0.fs );          /* number of samples/channel in time T0 */
   header0.T0 = (((double) nT0)) / header0.fs; /* recompute T0 so that it is an integer number of samples */
-  printf("nT0 = %ld; header0.T0 recomputed, now %le. blk0 (buffer) is %f MB\n",nT0,header0.T0,((double)nT0*obsnchan*RG_NPOL)/(1024.0*1024.0)); 
-  if ( (blk0 = malloc( nT0 * obsnchan * RG_NPOL * sizeof(*blk0) ) ) == NULL ) { /* a single block of length nT0 for all channels and both pols */
-    printf("FATAL: main(): malloc() of blk0 failed\n"); 
-    return;
+  if ( (opt.hop>0) && (opt.hop<header0.T0) ) { /* sliding windows: analysis is done every hop, so the buffer is one hop */
+    nT0 = ( opt.hop * header0.fs );
+    nWin = floor( header0.T0 * header0.fs / nT0 + 0.5 );
+    header0.T0 = (((double) nT0*nWin)) / header0.fs; /* a whole number of hops */
+    printf("HOP %le: %ld samples/channel; T0 recomputed, now %le (%ld hops)\n",opt.hop,nT0,header0.T0,nWin);
     }
+  if (ra_plan_compile( &plan, &header0, nT0, opt.eStats, opt.bExact )) return;
+
+  /* RAM budget; if over MAX_MEMORY, blocks are read in pieces, and T0 windows maybe analyzed in tiles (see ra_mem.c) */
+  /* (with WORKERS, the budget is per worker) */
+  nAvail = ra_swallow_avail( obsnchan, overlap );
+  if (ra_mem_plan( &mem, (opt.nWorkers>1) ? opt.maxMemory/opt.nWorkers : opt.maxMemory,
+                   plan.nCh, nAvail, nT0, nWin, ra_out_mem( &out, obsnchan ) )) return;
+  if (mem.nTiles) { /* as with HOP, the T0 buffer is one tile */
+    nWin = mem.nTiles;
+    nT0  = mem.nTile;
+    header0.T0 = (((double) nT0*nWin)) / header0.fs; /* a whole number of tiles */
+    printf("MAX_MEMORY: %ld samples/channel per tile; T0 recomputed, now %le (%ld tiles)\n",nT0,header0.T0,nWin);
+    if (ra_plan_compile( &plan, &header0, nT0, opt.eStats, opt.bExact )) return;
+    }
+  if (opt.nWorkers>1) ra_par_mem( &mem, plan.nCh, nAvail ); /* workers always read in pieces (see ra_par.c) */
+  if (nFan) ra_fan_whole( &mem );                            /* chains share the block (see ra_fan.c) */
+  if (mem.nPiece) ra_plan_pieces( &plan, mem.nPiece );
+
+  memset( &work, 0, sizeof(struct ra_work_struct) );
+  if (opt.nWorkers>1) {
+
+    /* parallel: the file is divided into ranges, which workers analyze, each with its own working memory; */
+    /* their reports are merged here, in order (see ra_par.c).  Then there's nothing left for the main loop. */
+    if (opt.lagBudget>0) printf("WARNING: main(): LAG_BUDGET is ignored with WORKERS\n");
+    printf("nT0 = %ld; header0.T0 recomputed, now %le. blk0 (buffer) is %f MB per worker\n",nT0,header0.T0,((double)nT0*plan.nCh*RG_NPOL)/(1024.0*1024.0)); 
+    if ( bResume && ra_ckpt_restore( opt.ckptFile, &ckpt, &header0, nT0, plan.nCh, nWin, opt.eOutFormat, opt.nColChunk,
+                                     opt.nWorkers, &out, NULL, NULL, NULL ) ) return;
+    if (ra_par_run( opt.nWorkers, infile, fp_in, fpos, &header0, &plan, &mem, &(opt.place), obsnchan, chan_bw,
+                    nAvail, nT0, nWin, opt.outfile, &out, opt.checkpoint, opt.ckptFile, bResume ? &ckpt : NULL )) return;
+    bDone = 1;
 
-  nT1 = ( header0.T1 * header0.fs );          /* number of samples/channel in time T1 */
-  header0.T1 = (((double) nT1)) / header0.fs; /* recompute T1 so that it is an integer number of samples */
-  printf("nT1 = %ld; header0.T1 recomputed, now %le. blk1 (buffer) is %f MB\n",nT1,header0.T1,((double)nT1*obsnchan*RG_NPOL)/(1024.0*1024.0)); 
-  if ( (blk1 = malloc( nT1 * obsnchan * RG_NPOL * sizeof(*blk1) ) ) == NULL ) { /* a single block of length nT1 for all channels and both pols */
-    printf("FATAL: main(): malloc() of blk1 failed\n"); 
-    return;
+    } else {
+
+  /* all working memory is taken from here (see ra_arena.c) */
+  if (ra_work_init( &work, ra_mem_arena( &mem ), &(opt.place) )) return;
+  ra_work_thread( &work );
+
+  if (nWin>1) {
+    if (ra_slide_init( &slide, nWin, plan.nCh, mem.nTiles>0, &(work.arena) )) return;
+    plan.slide = &slide;
+    }
+  if (opt.lagBudget>0) {
+    if (plan.slide) {
+      printf("WARNING: main(): LAG_BUDGET is ignored with HOP, or T0 in tiles (MAX_MEMORY)\n");
+      } else {
+      if (ra_lag_init( &lag, &plan, &header0, opt.bExact, opt.lagBudget, opt.lagLadder, opt.nLagSub,
+                       opt.bLagPriority ? opt.bChLagPriority : NULL )) return;
+      plan.lag = &lag;
+      }
     }
+  /* allocate memory for the input raw data block (or a piece of it) */
+  if ( (blk = ra_arena_alloc( &(work.arena), mem.nBlk * sizeof(*blk), "blk" ) ) == NULL ) return;
 
+  printf("nT0 = %ld; header0.T0 recomputed, now %le. blk0 (buffer) is %f MB\n",nT0,header0.T0,((double)nT0*plan.nCh*RG_NPOL)/(1024.0*1024.0)); 
+  /* the start of a T0 window that crosses into the next block; nT0 samples for each analyzed channel */
+  if ( (blk0 = ra_arena_alloc( &(work.arena), nT0 * plan.nCh * RG_NPOL * sizeof(*blk0), "blk0" ) ) == NULL ) return;
   bDone = 0;
+
+  /* the other jobs, each with its own header, plan, working memory, and output (see ra_fan.c) */
+  for (i=0;i<nFan;i++) if (ra_fan_init( &(fan[i]), overlap, obsfreq, obsbw, obsnchan, fs )) return;
+
+    } /* if (opt.nWorkers>1) */
+
+  nT1 = ( header0.T1 * header0.fs );          /* number of samples/channel in time T1 */
+  header0.T1 = (((double) nT1)) / header0.fs; /* recompute T1 so that it is an integer number of samples */
+  printf("nT1 = %ld; header0.T1 recomputed, now %le\n",nT1,header0.T1); 
+  /* T1-rate processing isn't implemented (see below), so there's no T1 buffer (blk1: nT1*obsnchan*RG_NPOL bytes) */
+
   nblock = 0;
   blk0_ptr = 0;
 
+  /* resuming: pick up at the block after the checkpoint, with the window that crosses into it (see ra_ckpt.c) */
+  if ( bResume && (opt.nWorkers<=1) ) {
+    if (ra_ckpt_restore( opt.ckptFile, &ckpt, &header0, nT0, plan.nCh, nWin, opt.eOutFormat, opt.nColChunk,
+                         0, &out, &plan, blk0, plan.slide )) return;
+    fpos     = ckpt.fpos;
+    nblock   = ckpt.nblock;
+    blk0_ptr = ckpt.blk0_ptr;
+    fstart0  = ckpt.fstart0;
+    fseek( fp_in, fpos, SEEK_SET );
+    if ( (rg_read_header(fp_in,&fpos,rg_header)>0) || feof(fp_in) ) bDone = 1;
+    }
+
   /*****************/
   /*** Main Loop ***/
   /*****************/
@@ -208,9 +385,32 @@ main ( int narg, char *argv[] ) {
 
   while (!bDone) {
 
+    if (mem.nPiece) { /* bounded memory: the block is read and swallowed a piece at a time (see ra_mem.c) */
+
+      pos0 = ftell(fp_in);
+      for (n0=0;n0<nAvail;n0+=n) {
+        n = (nAvail-n0<mem.nPiece) ? nAvail-n0 : mem.nPiece;
+        gettimeofday(&tv1,NULL);            /* PROFILING */
+        tp = ra_prof_now();
+          ra_prof_thr[ra_prof_id].nBytes += ra_mem_read( fp_in, pos0, &plan, obsnchan, n0, n, blk );
+        RA_PROF_ADD(RA_PROF_READ,tp);
+          time1 += ra_timer(tv1);           /* PROFILING */
+        gettimeofday(&tv2,NULL);  /* PROFILING */
+          ra_swallow( blk, &header0, &plan, blk0, &blk0_ptr, nT0, n, chan_bw, &out, &fstart0 );
+          time2 += ra_timer(tv2); /* PROFILING */
+        }
+      fseek( fp_in, pos0 + RG_BLK_SIZE, SEEK_SET );
+      fpos += RG_BLK_SIZE;
+      nblock++;  
+
+      } else {
+
     /* read sample block */
     gettimeofday(&tv1,NULL);            /* PROFILING */
+    tp = ra_prof_now();
       fread( blk, RG_BLK_SIZE, 1, fp_in);
+    RA_PROF_ADD(RA_PROF_READ,tp);
+    ra_prof_thr[ra_prof_id].nBytes += RG_BLK_SIZE;
       time1 += ra_timer(tv1);           /* PROFILING */
     fpos += RG_BLK_SIZE;
     nblock++;  
@@ -220,15 +420,30 @@ main ( int narg, char *argv[] ) {
     gettimeofday(&tv2,NULL);  /* PROFILING */
       ra_swallow(blk,                        /* the data */
                  &header0,                   /* the instructions */
+                 &plan,                      /* channels to be analyzed */
                  blk0,                       /* the current T0 buffer */
                  &blk0_ptr,                  /* pointer within current T0 buffer */  
                  nT0,                        /* the length of the T0 buffer in samples (1 sample = RG_NPOL bytes) */
-                 obsnchan, chan_bw, overlap, /* stuff learned from GUPPI header */ 
-                 fp_out,                     /* where output should go */
+                 nAvail,                     /* samples per channel in blk, excluding overlap */
+                 chan_bw,                    /* stuff learned from GUPPI header */ 
+                 &out,                       /* where output should go */
                  &fstart0                    /* keeping track of absolute time relative to start of run */
                 );
+      if (nFan) ra_fan_swallow( fan, nFan, blk, nAvail, chan_bw, &work ); /* the same block, for the other jobs */
       time2 += ra_timer(tv2); /* PROFILING */
 
+      } /* if (mem.nPiece) */
+
+    /* every CHECKPOINT seconds, save where we are (see ra_ckpt.c) */
+    if (ra_ckpt_due( opt.checkpoint, &tCkpt )) {
+      ra_ckpt_init( &ckpt, &header0, nT0, plan.nCh, nWin, &out, 0 );
+      ckpt.fpos     = fpos;
+      ckpt.nblock   = nblock;
+      ckpt.blk0_ptr = blk0_ptr;
+      ckpt.fstart0  = fstart0;
+      ra_ckpt_write( opt.ckptFile, &ckpt, &out, &plan, blk0, plan.slide );
+      }
+
     ///* swallow -- T1-rate processing */
     //gettimeofday(&tv2,NULL);  /* PROFILING */
     //  ra_swallow(blk,                        /* the data */
@@ -237,12 +452,14 @@ main ( int narg, char *argv[] ) {
     //             &blk1_ptr,                  /* pointer within current T1 buffer */  
     //             nT1,                        /* the length of the T1 buffer in samples (1 sample = RG_NPOL bytes) */
     //             obsnchan, chan_bw, overlap, /* stuff learned from GUPPI header */
-    //             fp_out                      /* where output should go */
+    //             &out                        /* where output should go */
     //           );
     //  time2 += ra_timer(tv2); /* PROFILING */
 
     /* read header of next block */
+    tp = ra_prof_now();
     eStatus = rg_read_header(fp_in,&fpos,rg_header);
+    RA_PROF_ADD(RA_PROF_HEADER,tp);
     if (eStatus>0) {
       printf("rg_read_header() returned 1... end-of-file garbage? Setting bDone=1\n");
       bDone=1;
@@ -268,27 +485,17 @@ main ( int narg, char *argv[] ) {
   /*=== Winding Down ===*/
   /*====================*/
 
-  /* close files */
-  fclose(fp_out);
+  /* close files; the run is complete, so a checkpoint is no longer of use */
+  ra_out_close(&out);
+  ra_fan_close( fan, nFan );
   fclose(fp_in);
+  if ( (opt.checkpoint>0) || bResume ) remove( opt.ckptFile );
 
-  /* free data block memory */
-  free(blk);  blk  = NULL;
-  free(blk0); blk0 = NULL;
-  free(blk1); blk1 = NULL;
-
-  /* free block memory (allocated in ra_analyze.c) */
-  if (raa_bAllocSS) {
-    free(raa_xi); raa_xi = NULL;
-    free(raa_xq); raa_xq = NULL;
-    free(raa_yi); raa_yi = NULL;
-    free(raa_yq); raa_yq = NULL;
-    free(raa_xx); raa_xx = NULL;
-    free(raa_yy); raa_yy = NULL;
-    free(raa_xyi); raa_xyi = NULL; 
-    free(raa_xyq); raa_xyq = NULL; 
-    raa_bAllocSS = 0;
-    }
+  /* free working memory: data block, T0 buffer, sliding windows, and analysis scratch (workers' are already freed) */
+  if (work.arena.base) printf("Working memory: %.1f of %.1f MB used\n",(double) work.arena.high/RA_MEM_MB,(double) work.arena.size/RA_MEM_MB);
+  ra_work_free( &work );
+  blk = NULL; blk0 = NULL;
+  if (fan) free(fan);
 
   printf("Program execution began: UTC %s",asctime(gmtime(&pe1_tv.tv_sec))); 
   gettimeofday( &pe2_tv, NULL );
@@ -298,6 +505,8 @@ main ( int narg, char *argv[] ) {
   /* PROFILING */
   printf("Elapsed time spent on Activity 1 (reading file) = %lf s\n",time1);
   printf("Elapsed time spent on Activity 2 (swallow())    = %lf s\n",time2);
+  ra_prof_print( header0.fs );
+  if (plan.lag) ra_lag_print( plan.lag );
 
   printf("Bye.\n"); 
 
@@ -307,6 +516,47 @@ main ( int narg, char *argv[] ) {
 //==================================================================================
 //=== HISTORY ======================================================================
 //==================================================================================
+// frsc.c: 2026 Oct 19
+// -- blk1, blk1_ptr, fstart1 (unused) removed
+// frsc.c: 2026 Oct 19
+// -- several job files in one pass over the data file (ra_fan.c)
+// frsc.c: 2026 Oct 19
+// -- checkpoints (CHECKPOINT, CHECKPOINT_FILE), and --resume (ra_ckpt.c)
+// frsc.c: 2026 Oct 19
+// -- parallel processing of the file by WORKERS threads, reports merged in order (ra_par.c)
+// frsc.c: 2026 Oct 19
+// -- huge pages, pinning, and NUMA placement of working memory (HUGEPAGES, CPUS, NUMA_NODE; ra_arena.c)
+// frsc.c: 2026 Oct 19
+// -- working memory is one arena (ra_arena.c), allocated once; frees it instead of blk, blk0, raa_tm, raa_th
+// frsc.c: 2026 Oct 19
+// -- RAM budget (ra_mem.c; MAX_MEMORY): blocks may be read in pieces, and T0 windows analyzed in tiles;
+//    blk is allocated after the plan, and blk1 (unused) isn't allocated
+// frsc.c: 2026 Oct 19
+// -- real-time deadline monitor (ra_lag.c; LAG_BUDGET, LAG_LADDER, LAG_SUBSAMPLE, LAG_PRIORITY)
+// frsc.c: 2026 Oct 19
+// -- per-stage profiling (ra_prof.c; PROFILE, PROFILE_FILE)
+// frsc.c: 2026 Oct 19
+// -- frees raa_th (eType 8)
+// frsc.c: 2026 Oct 19
+// -- EXACT selects exact (integer) kernels
+// frsc.c: 2026 Oct 19
+// -- sliding windows (HOP; ra_slide.c)
+// frsc.c: 2026 Oct 19
+// -- emmintrin.h, for ra_deinterleave()
+// frsc.c: 2026 Oct 19
+// -- STATS selects the analysis kernel (ra_kernels.c)
+// frsc.c: 2026 Oct 19
+// -- channel plan (ra_plan.c); blk0 is sized for the analyzed channels only
+// frsc.c: 2026 Oct 19
+// -- change-triggered suppression of eType 1 reports (SUPPRESS, HEARTBEAT; ra_suppress.c)
+// frsc.c: 2026 Oct 19
+// -- reports can also be published in shared memory (SHM; ra_shm.c)
+// frsc.c: 2026 Oct 19
+// -- reports can also be published on a socket (STREAM; ra_stream.c)
+// frsc.c: 2026 Oct 19
+// -- includes ra_moments.c (eType 7 reports)
+// frsc.c: 2026 Oct 19
+// -- output goes through ra_output.c; OUTFILE and OUTFORMAT (compressed frames, columnar store) job file keywords
 // frsc.c: S.W. Ellingson, Virginia Tech, 2014 Jan 26
 // -- some diagnostic printf's commented out
 // frsc.c: S.W. Ellingson, Virginia Tech, 2014 Jan 25
@@ -0,0 +1,702 @@
+/*============================================================================
+frsc_bench.c: 2026 Oct 19
+Benchmarks (and checks) the parts of frsc that take the time, and compares with a baseline
+---
+COMPILE: (see makefile; "make bench" builds and runs it)
+---
+COMMAND LINE SYNTAX, INPUT, OUTPUT:
+  frsc_bench [options]
+  options:
+    -o <file>  write results to <file> as JSON (default bench.json)
+    -b <file>  compare with the results in <file> (e.g. bench_baseline.json).  If <file> doesn't exist,
+               the results are written there too, and become the baseline.
+    -x <pct>   a result more than <pct> percent worse than the baseline is a regression (default 10)
+    -e         also end-to-end runs: frsc over files written by frsc_gen (both must be in the current
+               directory), for several numbers of channels and T0.  Files are written once and kept.
+               Then the EXACT checks (below), which are end-to-end too.
+    -d <dir>   where the end-to-end runs keep their files (default /tmp)
+    -t <s>     each measurement takes at least about <s> seconds (default 0.05)
+    -q         only report failures, regressions, and the summary
+  Exit status is 0 if every check passed and nothing regressed, 1 otherwise.
+---
+Measurements (every result is a time per unit of work, so smaller is better; each is the best of
+RB_TRIALS trials):
+  header.parse                     rg_read_header() and rg_analyze_header() of a 17-card header [ns/header]
+  swallow.deinterleave             ra_deinterleave() (saving the start of a window; ra_swallow.c) [ns/sample]
+  swallow.deinterleave.scalar      ...without SSE2 (ra_deinterleave_scalar()) [ns/sample]
+  kernel.s<S>.<float|exact>[.h].n<N>
+                                   each analysis kernel (ra_kernels.c): STATS bits <S>, float or EXACT, with or
+                                   without ADC health (.h), over one channel of <N> samples [ns/sample]
+  write.<plain|framed|columns>     ra_out_write() of an eType 1 report of 32 channels, per OUTFORMAT,
+                                   including ra_out_open() and ra_out_close() [us/report]
+  e2e.c<nch>.t<T0>                 frsc, end to end, over one block [ns/byte of GUPPI data]
+Checks: every kernel's output (statistics, clip counts, and ADC health) is compared with that of the
+reference path, ra_tm_channel() and ra_kernel_td() (exact moments, finalized in long double; the path of
+HOP and of eType 7 reports), for one span and for two (as for a window crossing blocks).  The exact
+kernels must agree bit for bit, and the float kernels to within RB_TOL (relative) per RB_TOL_N samples
+(their float sums lose precision as the window gets longer); max and clip counts are integers, and must
+agree exactly.  ra_deinterleave() must agree with ra_deinterleave_scalar() (the path of a build without
+SSE2), byte for byte, for lengths that aren't multiples of 16 and sources that aren't aligned.
+With -e, the EXACT checks: frsc, with EXACT 1 and TFLAGS 98 (statistics, moments, ADC health), over the
+32-channel file, sequentially and with WORKERS, must write the same OUTFILE, byte for byte:
+  exact.workers                    T0 windows; WORKERS 1 and RB_EXACT_WORKERS
+  exact.hop                        HOP; WORKERS 1 and RB_EXACT_WORKERS
+  exact.tiles                      T0 in tiles (MAX_MEMORY); sequentially, and with 2 workers and twice the
+                                   MAX_MEMORY (so the same tiles; see ra_par.c)
+The JSON is one result per line, in the order above, so that it's easy to diff and to read back.
+---
+REQUIRES
+  Nothing special
+
+See end of this file for history.
+============================================================================*/
+#define RA_H_RA_VERSION 1
+#define _GNU_SOURCE    /* sched_setaffinity(), CPU_SET(); see ra_arena.c */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include <float.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sched.h>
+#include <sys/stat.h>
+
+#include <emmintrin.h> /* SSE2 intrinsics; ra_deinterleave() */
+
+#define RA_MAX_FILENAME_LENGTH 1024
+
+#include "ra_aux.c"            /* auxilliary (support) code */
+#include "ra_format.c"         /* output format definition */
+#include "ra_format_defines.h" /* macro defines for field values in ra_format.c */
+#include "ra_prof.c"           /* ra_prof_now() */
+#include "ra_arena.c"
+#include "ra_moments.c"        /* the reference: ra_tm_channel() */
+#include "ra_kernels.c"        /* the kernels */
+#include "ra_compress.c"
+#include "ra_columns.c"
+#include "ra_stream.c"
+#include "ra_shm.c"
+#include "ra_suppress.c"
+#include "ra_output.c"         /* ra_out_write() */
+#include "ra_read_jobfile.c"
+#include "ra_guppi_file.c"     /* rg_read_header(), rg_analyze_header() */
+#include "ra_slide.c"
+#include "ra_plan.c"
+#include "ra_lag.c"
+#include "ra_analyze.c"
+#include "ra_swallow.c"        /* ra_deinterleave() */
+
+#define RB_MAX_RESULTS 512
+#define RB_TRIALS 5
+#define RB_NMAX (1L<<20)       /* samples; the most a kernel is given */
+#define RB_TOL 1.0e-3          /* float kernels vs. the reference; relative (or absolute, for values less than 1)... */
+#define RB_TOL_N 65536         /* ...per this many samples (or fewer) */
+#define RB_REPORTS 1000        /* reports written per write.* trial */
+#define RB_EXACT_WORKERS 4     /* WORKERS, for the EXACT checks */
+
+struct rb_result_struct {
+  char name[64];
+  double value;
+  char unit[16];
+  };
+
+struct rb_result_struct rb_result[RB_MAX_RESULTS];
+int rb_nResults = 0;
+int rb_bQuiet = 0;
+long int rb_nChecks = 0;
+long int rb_nFailed = 0;
+
+/*==============================================================*/
+/*=== rb_add() =================================================*/
+/*==============================================================*/
+
+void rb_add( char *name, double value, char *unit ) {
+  if (rb_nResults>=RB_MAX_RESULTS) return;
+  strncpy( rb_result[rb_nResults].name, name, 63 );
+  rb_result[rb_nResults].value = value;
+  strncpy( rb_result[rb_nResults].unit, unit, 15 );
+  rb_nResults++;
+  if (!rb_bQuiet) { printf("  %-36s %12.4f %s\n",name,value,unit); fflush(stdout); }
+  }
+
+/*==============================================================*/
+/*=== rb_time() ================================================*/
+/*==============================================================*/
+/* [ns] per call of f(arg); best of RB_TRIALS trials, each of enough calls to take about tmin/RB_TRIALS */
+
+double rb_time( void (*f)( void * ), void *arg, double tmin ) {
+  long int nRep = 1;
+  long int i, t;
+  double best;
+  int j;
+
+  for (;;) { /* also warms up */
+    t = ra_prof_now();
+    for (i=0;i<nRep;i++) f(arg);
+    t = ra_prof_now() - t;
+    if ( (t >= tmin*1e+9/RB_TRIALS) || (nRep >= (1L<<30)) ) break;
+    nRep *= 2;
+    }
+  best = (double) t / nRep;
+  for (j=1;j<RB_TRIALS;j++) {
+    t = ra_prof_now();
+    for (i=0;i<nRep;i++) f(arg);
+    t = ra_prof_now() - t;
+    if ((double) t / nRep < best) best = (double) t / nRep;
+    }
+
+  return best;
+  }
+
+/*==============================================================*/
+/*=== header.parse =============================================*/
+/*==============================================================*/
+
+struct rb_header_arg { FILE *fp; char header[RG_MAX_HEADER_LENGTH]; };
+
+void rb_header( void *arg ) {
+  struct rb_header_arg *a = arg;
+  long int fpos = 0;
+  int overlap, obsnchan;
+  float obsfreq, obsbw, chan_bw;
+  double fs;
+  rewind( a->fp );
+  rg_read_header( a->fp, &fpos, a->header );
+  rg_analyze_header( a->header, &overlap, &obsfreq, &obsbw, &chan_bw, &obsnchan, &fs );
+  }
+
+/*==============================================================*/
+/*=== swallow.deinterleave =====================================*/
+/*==============================================================*/
+
+struct rb_deint_arg { signed char *src; signed char *planes; long int n; };
+
+void rb_deint( void *arg ) {
+  struct rb_deint_arg *a = arg;
+  ra_deinterleave( a->planes, a->planes+a->n, a->planes+2*a->n, a->planes+3*a->n, a->src, a->n );
+  }
+
+void rb_deint_scalar( void *arg ) {
+  struct rb_deint_arg *a = arg;
+  ra_deinterleave_scalar( a->planes, a->planes+a->n, a->planes+2*a->n, a->planes+3*a->n, a->src, a->n );
+  }
+
+/*==============================================================*/
+/*=== kernel.* =================================================*/
+/*==============================================================*/
+
+struct rb_kernel_arg {
+  ra_kernel_t kernel;
+  struct ra_span_struct span[RA_MAX_SPANS];
+  int nSpan;
+  long int mev2;
+  struct DAPstruct d;
+  struct clips_struct clips;
+  struct HPstruct h;
+  };
+
+void rb_kernel( void *arg ) {
+  struct rb_kernel_arg *a = arg;
+  a->kernel( a->span, a->nSpan, a->mev2, &(a->d), &(a->clips), &(a->h) );
+  }
+
+/*==============================================================*/
+/*=== rb_check() ===============================================*/
+/*==============================================================*/
+/* compares a kernel's output with the reference's; returns 0 if they agree, 1 if not (and says why) */
+
+int rb_check( char *name, struct rb_kernel_arg *a, long int n, struct DAPstruct *dr, struct clips_struct *cr, struct HPstruct *hr,
+              int bExact, int bHealth ) {
+  static char *q[8] = { "xi", "xq", "yi", "yq", "xm2", "ym2", "u", "v" };
+  static char *f[5] = { "mean", "max", "rms", "s", "k" };
+  float *pk = (float *) &(a->d);
+  float *pr = (float *) dr;
+  double tol = RB_TOL * ( n>RB_TOL_N ? (double) n/RB_TOL_N : 1.0 );
+  int i;
+
+  rb_nChecks++;
+  if ( (a->clips.x!=cr->x) || (a->clips.y!=cr->y) ) {
+    printf("CHECK FAILED: %s: clips %ld,%ld; reference %ld,%ld\n",name,a->clips.x,a->clips.y,cr->x,cr->y);
+    return 1;
+    }
+  for (i=0;i<8*5;i++) {
+    if ( (bExact || (i%5==1)) ? (pk[i]!=pr[i]) : (fabs(pk[i]-pr[i]) > tol*( fabs(pr[i])>1 ? fabs(pr[i]) : 1 )) ) {
+      printf("CHECK FAILED: %s: %s.%s %.9g; reference %.9g\n",name,q[i/5],f[i%5],pk[i],pr[i]);
+      return 1;
+      }
+    }
+  if ( bHealth && memcmp( &(a->h), hr, sizeof(struct HPstruct) ) ) {
+    printf("CHECK FAILED: %s: ADC health differs from reference\n",name);
+    return 1;
+    }
+
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== write.* ==================================================*/
+/*==============================================================*/
+
+struct rb_write_arg { char file[RA_MAX_FILENAME_LENGTH]; int eFormat; struct ra_header_struct header; struct ra_td *td; };
+
+void rb_write( void *arg ) {
+  struct rb_write_arg *a = arg;
+  struct ra_out_struct out;
+  struct ra_header_struct header;
+  long int r;
+
+  if (ra_out_open( &out, a->file, a->eFormat, RA_COL_CHUNK_DEFAULT, -1 )) return;
+  memcpy( &header, &(a->header), sizeof(struct ra_header_struct) );
+  header.eType = RA_H_ETYPE_NULL; /* first, as frsc does; this defines the columnar store */
+  ra_out_write( &out, &header, NULL );
+  header.eType = RA_H_ETYPE_TF0;
+  for (r=0;r<RB_REPORTS;r++) {
+    header.iSeqNo = r;
+    header.fStart = r*header.T0;
+    a->td->tdac[r%32].xi.mean += 0.001; /* (so that reports aren't all the same) */
+    ra_out_write( &out, &header, a->td );
+    }
+  ra_out_close( &out );
+  }
+
+/*==============================================================*/
+/*=== rb_raw() =================================================*/
+/*==============================================================*/
+/* name of the generated file of nch channels, into raw; it's written first, if necessary. */
+/* returns 0 if OK, 1 otherwise */
+
+int rb_raw( char *dir, int nch, char *raw ) {
+  char cmd[2*RA_MAX_FILENAME_LENGTH];
+
+  sprintf(raw,"%s/frsc_bench_c%d.raw",dir,nch);
+  if (access(raw,R_OK)) {
+    sprintf(cmd,"./frsc_gen %s -c %d -q -j %ld -t 0,1e+5,10 -k 0,1e-4",raw,nch,sysconf(_SC_NPROCESSORS_ONLN));
+    if (!rb_bQuiet) printf("  (%s)\n",cmd);
+    if (system(cmd) || access(raw,R_OK)) { printf("FATAL: rb_raw(): '%s' failed\n",cmd); return 1; }
+    }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== rb_e2e() =================================================*/
+/*==============================================================*/
+/* frsc over a generated file of nch channels (written first, if necessary), with T0; */
+/* returns [ns/byte] from frsc's PROFILE_FILE, or -1 if something went wrong */
+
+double rb_e2e( char *dir, int nch, double T0 ) {
+  char raw[RA_MAX_FILENAME_LENGTH], job[RA_MAX_FILENAME_LENGTH], prof[RA_MAX_FILENAME_LENGTH], cmd[4*RA_MAX_FILENAME_LENGTH];
+  char line[256];
+  double mbps = -1;
+  FILE *fp;
+
+  sprintf(job,"%s/frsc_bench.job",dir);
+  sprintf(prof,"%s/frsc_bench_prof.json",dir);
+  if (rb_raw( dir, nch, raw )) return -1;
+
+  if (!(fp = fopen(job,"w"))) { printf("FATAL: rb_e2e(): couldn't write '%s'\n",job); return -1; }
+  fprintf(fp,"SOURCE 1\nINFILE %s\nTFLAGS 2\nT0 %g\nT1 0\nT2 0\nOUTFILE %s/frsc_bench_e2e.dat\nPROFILE_FILE %s\n",raw,T0,dir,prof);
+  fclose(fp);
+  remove(prof);
+  sprintf(cmd,"./frsc %s > %s/frsc_bench_e2e.log",job,dir);
+  system(cmd); /* (frsc's exit status doesn't mean anything) */
+
+  if (!(fp = fopen(prof,"r"))) { printf("FATAL: rb_e2e(): '%s' wrote no '%s'; see %s/frsc_bench_e2e.log\n",cmd,prof,dir); return -1; }
+  while (fgets(line,sizeof(line),fp)) sscanf(line," \"mb_per_s\": %lf",&mbps);
+  fclose(fp);
+
+  return (mbps>0) ? 1.0e+3/mbps : -1;
+  }
+
+/*==============================================================*/
+/*=== rb_frsc() ================================================*/
+/*==============================================================*/
+/* frsc with job file job, holding the options common to a check and then more; the log is job's, with */
+/* ".log".  returns 0 if OK, 1 if the log doesn't say so (it must include expect, unless that's NULL) */
+
+int rb_frsc( char *job, char *common, char *more, char *outfile, char *expect ) {
+  char cmd[4*RA_MAX_FILENAME_LENGTH], log[RA_MAX_FILENAME_LENGTH+8], line[1024];
+  int bBye = 0, bExpect = (expect==NULL);
+  FILE *fp;
+
+  if (!(fp = fopen(job,"w"))) { printf("FATAL: rb_frsc(): couldn't write '%s'\n",job); return 1; }
+  fprintf(fp,"%s%sOUTFILE %s\n",common,more,outfile);
+  fclose(fp);
+  sprintf(log,"%s.log",job);
+  sprintf(cmd,"./frsc %s > %s",job,log);
+  system(cmd); /* (frsc's exit status doesn't mean anything) */
+
+  if (!(fp = fopen(log,"r"))) { printf("FATAL: rb_frsc(): '%s' wrote no log\n",cmd); return 1; }
+  while (fgets(line,sizeof(line),fp)) {
+    if (strncmp(line,"Bye.",4)==0) bBye = 1;
+    if ( expect && strstr(line,expect) ) bExpect = 1;
+    }
+  fclose(fp);
+  if (!bBye)    { printf("FATAL: rb_frsc(): '%s' didn't finish; see %s\n",cmd,log); return 1; }
+  if (!bExpect) { printf("FATAL: rb_frsc(): '%s' didn't say '%s'; see %s\n",cmd,expect,log); return 1; }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== rb_exact() ===============================================*/
+/*==============================================================*/
+/* the EXACT checks (see above): one file from each of two runs, which must be the same.  Both runs use */
+/* the same job file, since its name is in every report (sInfo).  returns 0 if they agree, 1 if not */
+
+int rb_exact( char *dir, char *name, char *opts, char *more1, char *more2, char *expect ) {
+  char raw[RA_MAX_FILENAME_LENGTH], job[RA_MAX_FILENAME_LENGTH], out1[RA_MAX_FILENAME_LENGTH], out2[RA_MAX_FILENAME_LENGTH];
+  char common[2*RA_MAX_FILENAME_LENGTH];
+  FILE *fp1, *fp2;
+  long int i = 0;
+  int c1, c2;
+
+  rb_nChecks++;
+  if (rb_raw( dir, 32, raw )) return 1;
+  sprintf(job,"%s/frsc_bench_exact.job",dir);
+  sprintf(out1,"%s/frsc_bench_exact1.dat",dir);
+  sprintf(out2,"%s/frsc_bench_exact2.dat",dir);
+  sprintf(common,"SOURCE 1\nINFILE %s\nTFLAGS 98\nEXACT 1\nT1 0\nT2 0\n%s",raw,opts);
+  if ( rb_frsc( job, common, more1, out1, expect ) || rb_frsc( job, common, more2, out2, "ra_par_ranges()" ) ) {
+    printf("CHECK FAILED: %s: frsc failed\n",name);
+    return 1;
+    }
+
+  if ( !(fp1 = fopen(out1,"rb")) || !(fp2 = fopen(out2,"rb")) ) {
+    printf("CHECK FAILED: %s: no OUTFILE\n",name);
+    if (fp1) fclose(fp1);
+    return 1;
+    }
+  do {
+    c1 = fgetc(fp1);
+    c2 = fgetc(fp2);
+    i++;
+    } while ( (c1==c2) && (c1!=EOF) );
+  fclose(fp1);
+  fclose(fp2);
+  if (c1!=c2) {
+    printf("CHECK FAILED: %s: '%s' and '%s' differ at byte %ld\n",name,out1,out2,i);
+    return 1;
+    }
+  if (i<=1+sizeof(struct ra_header_struct)) {
+    printf("CHECK FAILED: %s: no reports\n",name);
+    return 1;
+    }
+  if (!rb_bQuiet) printf("  %-36s %12ld bytes, the same\n",name,i-1);
+  remove(out1);
+  remove(out2);
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== rb_write_json() ==========================================*/
+/*==============================================================*/
+/* returns 0 if OK, 1 otherwise */
+
+int rb_write_json( char *file, double tmin ) {
+  FILE *fp;
+  char host[256];
+  char date[64];
+  time_t t = time(NULL);
+  int i;
+
+  if (!(fp = fopen(file,"w"))) {
+    printf("FATAL: rb_write_json(): couldn't write '%s'\n",file);
+    return 1;
+    }
+  if (gethostname(host,sizeof(host))) strcpy(host,"unknown");
+  strftime(date,sizeof(date),"%Y-%m-%dT%H:%M:%SZ",gmtime(&t));
+  fprintf(fp,"{\n");
+  fprintf(fp,"  \"format\": \"frsc_bench 1\",\n");
+  fprintf(fp,"  \"host\": \"%s\",\n",host);
+  fprintf(fp,"  \"date\": \"%s\",\n",date);
+  fprintf(fp,"  \"tmin_s\": %g,\n",tmin);
+  fprintf(fp,"  \"results\": [\n");
+  for (i=0;i<rb_nResults;i++) {
+    fprintf(fp,"    { \"name\": \"%s\", \"value\": %.6e, \"unit\": \"%s\" }%s\n",
+            rb_result[i].name,rb_result[i].value,rb_result[i].unit,(i<rb_nResults-1)?",":"");
+    }
+  fprintf(fp,"  ],\n");
+  fprintf(fp,"  \"checks\": { \"run\": %ld, \"failed\": %ld }\n",rb_nChecks,rb_nFailed);
+  fprintf(fp,"}\n");
+  fclose(fp);
+
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== rb_compare() =============================================*/
+/*==============================================================*/
+/* compares the results with those in baseline; returns the number of regressions */
+
+int rb_compare( char *baseline, double pct ) {
+  FILE *fp;
+  char line[512];
+  char name[64];
+  double value;
+  int nRegress = 0, nCompared = 0;
+  int i;
+
+  if (!(fp = fopen(baseline,"r"))) return 0;
+  printf("Compared with %s (threshold %g%%):\n",baseline,pct);
+  while (fgets(line,sizeof(line),fp)) {
+    if (sscanf(line," { \"name\": \"%63[^\"]\", \"value\": %lf",name,&value)!=2) continue;
+    for (i=0;i<rb_nResults;i++) if (strcmp(rb_result[i].name,name)==0) break;
+    if ( (i==rb_nResults) || (value<=0) ) continue;
+    nCompared++;
+    if (rb_result[i].value > value*(1+pct/100)) {
+        printf("  REGRESSION: %-36s %12.4f %s; baseline %.4f (%+.1f%%)\n",name,rb_result[i].value,rb_result[i].unit,value,100*(rb_result[i].value/value-1));
+        nRegress++;
+      } else if ( (!rb_bQuiet) && (rb_result[i].value < value/(1+pct/100)) ) {
+        printf("  faster:     %-36s %12.4f %s; baseline %.4f (%+.1f%%)\n",name,rb_result[i].value,rb_result[i].unit,value,100*(rb_result[i].value/value-1));
+      }
+    }
+  fclose(fp);
+  printf("  %d results compared, %d regressions\n",nCompared,nRegress);
+
+  return nRegress;
+  }
+
+/*************************************************************************/
+/*** main() **************************************************************/
+/*************************************************************************/
+
+main ( int narg, char *argv[] ) {
+
+  char outfile[RA_MAX_FILENAME_LENGTH];
+  char baseline[RA_MAX_FILENAME_LENGTH];
+  char dir[RA_MAX_FILENAME_LENGTH];
+  char name[64], value[72];
+  double pct = 10.0;
+  double tmin = 0.05;
+  int bE2E = 0;
+  int nRegress = 0;
+
+  static long int nSizes[3] = { 4096, 62500, RB_NMAX }; /* 62500: T0 = 10 ms at 6.25 MHz */
+  static struct { int nch; double T0; } e2e[4] = { {32,0.001}, {32,0.01}, {32,0.1}, {1024,0.01} };
+  static char *sFormat[3] = { "plain", "framed", "columns" };
+  static long int nDeint[7] = { 1, 15, 16, 17, 63, 1000, RB_NMAX/3+5 };  /* ra_deinterleave() vs. _scalar() */
+  char sWorkers[64];
+
+  signed char *data, *planes, *planes2;
+  struct rb_header_arg ha;
+  struct rb_deint_arg da;
+  struct rb_kernel_arg ka;
+  struct rb_write_arg wa;
+  struct MAPstruct m;
+  struct DAPstruct dr;
+  struct clips_struct cr;
+  struct HPstruct hr;
+  long int (*hist)[256];
+  static char hsrc[RG_MAX_HEADER_LENGTH+16];             /* a GUPPI header and the start of a block, as a file */
+  unsigned long int xs = 88172645463325252UL;
+  long int mev2;
+  long int n, n1, i;
+  int eStats, bExact, bHealth, iSize, nSpan, j, c;
+  int fdNull, fdOut;
+  double t;
+
+  strcpy(outfile,"bench.json");
+  baseline[0] = '\0';
+  strcpy(dir,"/tmp");
+  for (i=1;i<narg;i++) {
+    if      ( (strcmp(argv[i],"-o")==0) && (i+1<narg) ) { strcpy(outfile,argv[++i]); }
+    else if ( (strcmp(argv[i],"-b")==0) && (i+1<narg) ) { strcpy(baseline,argv[++i]); }
+    else if ( (strcmp(argv[i],"-x")==0) && (i+1<narg) ) { pct = atof(argv[++i]); }
+    else if ( (strcmp(argv[i],"-d")==0) && (i+1<narg) ) { strcpy(dir,argv[++i]); }
+    else if ( (strcmp(argv[i],"-t")==0) && (i+1<narg) ) { tmin = atof(argv[++i]); }
+    else if (strcmp(argv[i],"-e")==0)                   { bE2E = 1; }
+    else if (strcmp(argv[i],"-q")==0)                   { rb_bQuiet = 1; }
+    else {
+      printf("Usage: frsc_bench [-o <file>] [-b <baseline>] [-x <pct>] [-e] [-d <dir>] [-t <s>] [-q]\n");
+      exit(1);
+      }
+    }
+
+  /* test data: roughly Gaussian (sum of 4 uniform deviates; rms about 37), with one sample in 1000 at full scale */
+  data   = malloc( RB_NMAX*RG_NPOL );
+  planes = malloc( RB_NMAX*RG_NPOL );
+  planes2 = malloc( RB_NMAX*RG_NPOL );
+  hist   = malloc( 4*256*sizeof(long int) );
+  if ( (data==NULL) || (planes==NULL) || (planes2==NULL) || (hist==NULL) ) { printf("FATAL: main(): malloc() failed\n"); exit(1); }
+  for (i=0;i<RB_NMAX*RG_NPOL;i++) {
+    xs ^= xs<<13; xs ^= xs>>7; xs ^= xs<<17;
+    data[i] = (signed char) ( (long int) (xs&63) + ((xs>>8)&63) + ((xs>>16)&63) + ((xs>>24)&63) - 126 );
+    if ( ((xs>>32)%1000)==0 ) data[i] = ((xs>>42)&1) ? 127 : -128;
+    }
+  ra_kernel_select( RA_STATS_ALL, 0, 0, RA_H_ESOURCE_GUPPI_FILE, &mev2 );
+  ra_prof_start( 0, "" );
+
+  /* header.parse */
+  memset(ha.header,'\0',RG_MAX_HEADER_LENGTH);
+  rg_header_card(ha.header,"BACKEND","GUPPI",1);    rg_header_card(ha.header,"PKTFMT","1SFA",1);
+  rg_header_card(ha.header,"FD_POLN","LIN",1);      rg_header_card(ha.header,"SRC_NAME","FRSC_BENCH",1);
+  rg_header_card(ha.header,"NBITS","8",0);          rg_header_card(ha.header,"NPOL","4",0);
+  sprintf(value,"%d",RG_BLK_SIZE);                  rg_header_card(ha.header,"BLOCSIZE",value,0);
+  rg_header_card(ha.header,"OBSFREQ","1400.0",0);   rg_header_card(ha.header,"OBSBW","200.0",0);
+  rg_header_card(ha.header,"CHAN_BW","6.25",0);     rg_header_card(ha.header,"OBSNCHAN","32",0);
+  rg_header_card(ha.header,"TBIN","1.6e-07",0);     rg_header_card(ha.header,"OVERLAP","512",0);
+  rg_header_card(ha.header,"DIRECTIO","0",0);       rg_header_card(ha.header,"PKTIDX","0",0);
+  rg_header_card(ha.header,"PKTSIZE","8192",0);     rg_header_card(ha.header,"NPKT","131039",0);
+  strcat(ha.header,"END");
+  n = strlen(ha.header);
+  memset(&(ha.header[n]),' ',77);
+  memcpy(hsrc,ha.header,n+77);
+  memcpy(&(hsrc[n+77]),data,16); /* followed by some data */
+  if (!(ha.fp = fmemopen(hsrc,n+77+16,"r"))) { printf("FATAL: main(): fmemopen() failed\n"); exit(1); }
+  if (!rb_bQuiet) printf("Microbenchmarks:\n");
+  rb_add( "header.parse", rb_time( rb_header, &ha, tmin ), "ns/header" );
+  fclose(ha.fp);
+
+  /* swallow.deinterleave */
+  da.src = data; da.planes = planes; da.n = RB_NMAX;
+  rb_add( "swallow.deinterleave", rb_time( rb_deint, &da, tmin )/RB_NMAX, "ns/sample" );
+  rb_add( "swallow.deinterleave.scalar", rb_time( rb_deint_scalar, &da, tmin )/RB_NMAX, "ns/sample" );
+
+  /* ...which must be the same, with or without SSE2; from a source one sample off, so not aligned */
+  for (j=0;j<7;j++) {
+    n = nDeint[j];
+    rb_nChecks++;
+    memset( planes, 0, 4*n ); memset( planes2, 0, 4*n );
+    ra_deinterleave( planes, planes+n, planes+2*n, planes+3*n, data+RG_NPOL, n );
+    ra_deinterleave_scalar( planes2, planes2+n, planes2+2*n, planes2+3*n, data+RG_NPOL, n );
+    if (memcmp( planes, planes2, 4*n )) {
+      printf("CHECK FAILED: swallow.deinterleave: SSE2 and scalar paths differ for %ld samples\n",n);
+      rb_nFailed++;
+      }
+    }
+
+  /* kernel.*: check against the reference, then time */
+  for (eStats=1;eStats<=RA_STATS_ALL;eStats++) {
+    if (ra_kernels[0][eStats]==NULL) continue;
+    for (bExact=0;bExact<2;bExact++) {
+      for (bHealth=0;bHealth<2;bHealth++) {
+        ka.kernel = ra_kernel_select( eStats, bExact, bHealth, RA_H_ESOURCE_GUPPI_FILE, &(ka.mev2) );
+        for (iSize=0;iSize<3;iSize++) {
+          n = nSizes[iSize];
+          sprintf(name,"kernel.s%d.%s%s.n%ld",eStats,bExact?"exact":"float",bHealth?".h":"",n);
+
+          /* reference */
+          ra_tm_clear( &m );
+          memset( hist, 0, 4*256*sizeof(long int) );
+          ra_tm_channel( data, n, RG_NPOL, 1, ka.mev2, &m, bHealth ? hist : NULL );
+          ra_kernel_td( &m, eStats, &dr, &cr );
+          if (bHealth) ra_th_finish( hist, n, &cr, &hr );
+
+          /* one span (interleaved, in the block); and two (the first third as planes, as saved by ra_swallow()) */
+          for (nSpan=1;nSpan<=2;nSpan++) {
+            ka.nSpan = nSpan;
+            if (nSpan==1) {
+                ka.span[0].x = data; ka.span[0].n = n; ka.span[0].dS = RG_NPOL; ka.span[0].dC = 1;
+              } else {
+                n1 = n/3;
+                ra_deinterleave( planes, planes+n1, planes+2*n1, planes+3*n1, data, n1 );
+                ka.span[0].x = planes;            ka.span[0].n = n1;   ka.span[0].dS = 1;       ka.span[0].dC = n1;
+                ka.span[1].x = data + n1*RG_NPOL; ka.span[1].n = n-n1; ka.span[1].dS = RG_NPOL; ka.span[1].dC = 1;
+              }
+            rb_kernel( &ka );
+            if (rb_check( name, &ka, n, &dr, &cr, &hr, bExact, bHealth )) rb_nFailed++;
+            }
+
+          ka.nSpan = 1;
+          ka.span[0].x = data; ka.span[0].n = n; ka.span[0].dS = RG_NPOL; ka.span[0].dC = 1;
+          rb_add( name, rb_time( rb_kernel, &ka, tmin )/n, "ns/sample" );
+          }
+        }
+      }
+    }
+
+  /* write.*: eType 1 reports of 32 channels, with realistic statistics (from the kernel, over 32 stretches of the data) */
+  memset( &(wa.header), 0, sizeof(struct ra_header_struct) );
+  wa.header.eType  = RA_H_ETYPE_TF0;
+  wa.header.eSource = RA_H_ESOURCE_GUPPI_FILE;
+  wa.header.nCh    = 32;
+  wa.header.fs     = 6.25e+6;
+  wa.header.bw     = 200.0e+6;
+  wa.header.fc     = 1400.0e+6;
+  wa.header.tflags = RA_H_TFLAGS_TC;
+  wa.header.T0     = 0.01;
+  if ( (wa.td = calloc( 1, sizeof(struct ra_td) )) == NULL ) { printf("FATAL: main(): malloc() failed\n"); exit(1); }
+  ka.kernel = ra_kernel_select( RA_STATS_ALL, 0, 0, RA_H_ESOURCE_GUPPI_FILE, &(ka.mev2) );
+  for (c=0;c<32;c++) {
+    ka.nSpan = 1;
+    ka.span[0].x = data + c*(RB_NMAX/32)*RG_NPOL; ka.span[0].n = RB_NMAX/32; ka.span[0].dS = RG_NPOL; ka.span[0].dC = 1;
+    rb_kernel( &ka );
+    wa.td->tdac[c] = ka.d;
+    wa.td->clips.x += ka.clips.x;
+    wa.td->clips.y += ka.clips.y;
+    }
+  sprintf(wa.file,"%s/frsc_bench_out.dat",dir);
+  if ((fdNull = open("/dev/null",O_WRONLY))<0) { printf("FATAL: main(): couldn't open /dev/null\n"); exit(1); }
+  for (j=0;j<3;j++) {
+    wa.eFormat = j; /* RA_OUTFORMAT_PLAIN, _FRAMED, _COLUMNS */
+    sprintf(name,"write.%s",sFormat[j]);
+    fflush(stdout);
+    fdOut = dup(1); dup2(fdNull,1); /* (ra_out_close() says what it did, every time) */
+    t = rb_time( rb_write, &wa, tmin );
+    fflush(stdout);
+    dup2(fdOut,1); close(fdOut);
+    rb_add( name, t/RB_REPORTS*1.0e-3, "us/report" );
+    }
+  remove(wa.file);
+  close(fdNull);
+
+  /* e2e.* */
+  if (bE2E) {
+    if (!rb_bQuiet) printf("End-to-end (frsc over one block of frsc_gen output, all channels):\n");
+    for (j=0;j<4;j++) {
+      sprintf(name,"e2e.c%d.t%g",e2e[j].nch,e2e[j].T0);
+      t = rb_e2e( dir, e2e[j].nch, e2e[j].T0 );
+      if (t<0) { rb_nFailed++; continue; }
+      rb_add( name, t, "ns/byte" );
+      }
+
+    /* EXACT: the same, to the bit, however many threads (see above) */
+    if (!rb_bQuiet) printf("EXACT checks (frsc, sequentially and with WORKERS; the OUTFILEs must be the same):\n");
+    sprintf(sWorkers,"WORKERS %d\n",RB_EXACT_WORKERS);
+    if (rb_exact( dir, "exact.workers", "T0 0.01\n", "WORKERS 1\n", sWorkers, NULL )) rb_nFailed++;
+    if (rb_exact( dir, "exact.hop", "T0 0.03\nHOP 0.01\n", "WORKERS 1\n", sWorkers, "hops)" )) rb_nFailed++;
+    if (rb_exact( dir, "exact.tiles", "T0 0.1\n", "MAX_MEMORY 20\n", "WORKERS 2\nMAX_MEMORY 40\n", "tiles)" )) rb_nFailed++;
+    }
+
+  printf("%ld checks, %ld failed\n",rb_nChecks,rb_nFailed);
+
+  /* results, and comparison with the baseline */
+  if (rb_write_json( outfile, tmin )) exit(1);
+  printf("Results written to %s\n",outfile);
+  if (baseline[0]) {
+    if (access(baseline,R_OK)) {
+        if (rb_write_json( baseline, tmin )) exit(1);
+        printf("No baseline; results written to %s, which is now the baseline\n",baseline);
+      } else {
+        nRegress = rb_compare( baseline, pct );
+      }
+    }
+
+  free(data);
+  free(planes);
+  free(planes2);
+  free(hist);
+  free(wa.td);
+  exit( (rb_nFailed>0) || (nRegress>0) );
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// frsc_bench.c: 2026 Oct 19
+//   .6: EXACT checks (-e): frsc sequentially and with WORKERS, with HOP and tiles; SSE2 vs. scalar ra_deinterleave()
+//   .5: ra_out_open() takes an offset (ra_ckpt.c)
+//   .4: defines _GNU_SOURCE, for ra_arena.c
+//   .3: includes ra_arena.c (ra_analyze() and ra_slide.c use it)
+//   .2: includes ra_lag.c (ra_analyze() calls it)
+//   .1: initial version
@@ -0,0 +1,373 @@
+/*============================================================================
+frsc_gen.c: 2026 Oct 19
+Writes synthetic GUPPI raw data files, with RFI as specified, for testing and benchmarking frsc
+---
+COMPILE: (see makefile)
+---
+COMMAND LINE SYNTAX, INPUT, OUTPUT:
+  frsc_gen <file> [options]
+  <file>:    GUPPI raw data file to write (replaced if it exists)
+  options:
+    -c <nch>    OBSNCHAN; a power of 2 from 1 to 1024 (default 32)
+    -n <nblk>   number of blocks (default 1); each is RG_BLK_SIZE bytes of data plus a header
+    -b <bits>   ADC bits, 1..8 (default 8).  Samples are still written as 8-bit integers (NBITS = 8, which is all
+                frsc reads); with fewer bits, only the top <bits> bits are used, as by an ADC of <bits> bits whose
+                output is shifted into the top of a byte.
+    -r <rms>    noise: standard deviation of each of xi, xq, yi, yq, in LSBs of an 8-bit sample (default 16)
+    -T <tbin>   TBIN [s] (default 1.6e-7; i.e., 6.25 MHz channels).  CHAN_BW = 1/TBIN, OBSBW = OBSNCHAN*CHAN_BW.
+    -F <MHz>    OBSFREQ (default 1400)
+    -O <n>      OVERLAP, in samples (default 0).  The last <n> samples of each channel of a block are the first <n>
+                samples of the same channel in the next block, as GUPPI writes them.
+    -s <seed>   random number seed (default 1)
+    -j <n>      threads (default 1)
+    -q          don't report progress
+  RFI; each may be given up to RG_GEN_MAX_SIG times in all; <ch> is 1..nch, or 0 for all channels:
+    -t <ch>,<f>,<a>                  tone: frequency <f> [Hz] relative to the center of the channel (|f| < fs/2),
+                                     amplitude <a> (LSBs), in both polarizations
+    -p <ch>,<f>,<a>,<period>,<width> pulsed (radar): as -t, but only for the first <width> seconds of every
+                                     <period> seconds
+    -k <ch>,<p>                      clipping: each sample (all of xi, xq, yi, yq) is, with probability <p>, driven to
+                                     full scale with the sign it would otherwise have had
+  e.g. "frsc_gen test.raw -n 4 -j 8 -t 3,1e+5,10 -p 7,0,60,0.01,1e-4 -k 12,1e-3"
+---
+Every sample is a function only of the seed, the channel, and its time (its index from the start of the file,
+counting overlapping samples once), so the file is the same for any number of threads, and overlapping
+samples really are the same in both blocks.  Noise is Gaussian (Marsaglia's polar method, from a
+counter-based hash), which is what spends the time; blocks are generated by the threads in pieces of
+RG_GEN_PIECE samples of one channel, while the previous block is being written.  Memory used is two blocks.
+---
+REQUIRES
+  Nothing special
+
+See end of this file for history.
+============================================================================*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "ra_aux.c"            /* auxilliary (support) code */
+#include "ra_format.c"         /* RA_MAX_CH_DIV64 */
+#include "ra_guppi_file.c"     /* RG_BLK_SIZE, RG_NPOL; rg_header_card(), rg_analyze_header() */
+
+#define RA_MAX_FILENAME_LENGTH 1024
+
+#define RG_GEN_MAX_SIG 64         /* maximum number of -t, -p, and -k options, in all */
+#define RG_GEN_MAX_THREADS 256
+#define RG_GEN_PIECE (1L<<20)     /* samples; unit of work for a thread */
+
+#define RG_GEN_TONE  1
+#define RG_GEN_PULSE 2
+#define RG_GEN_CLIP  3
+
+struct rg_gen_sig_struct {
+  int eType;                      /* RG_GEN_* */
+  int ch;                         /* 1..nch; 0 = all */
+  double f;                       /* [Hz] */
+  double a;                       /* [LSB] */
+  double period;                  /* [s] */
+  double width;                   /* [s] */
+  double p;                       /* probability of clipping */
+  };
+
+struct rg_gen_struct {
+  long int nCh;                   /* OBSNCHAN */
+  long int nDim;                  /* samples per channel per block */
+  int overlap;                    /* OVERLAP */
+  int bits;                       /* ADC bits */
+  double rms;                     /* [LSB] */
+  double tbin;                    /* [s] */
+  unsigned long int seed;
+  int nSig;
+  struct rg_gen_sig_struct sig[RG_GEN_MAX_SIG];
+  /* the block being generated: */
+  signed char *blk;
+  long int iBlk;
+  long int nPieces;               /* per channel */
+  long int iNext;                 /* next piece to be claimed; atomic */
+  };
+
+/*==============================================================*/
+/*=== rg_gen_mix() =============================================*/
+/*==============================================================*/
+/* 64-bit hash (the splitmix64 finalizer); rg_gen_mix(key+i), i=0,1,2,... are independent uniform deviates */
+
+static inline unsigned long int rg_gen_mix( unsigned long int z ) {
+  z += 0x9e3779b97f4a7c15UL;
+  z = (z ^ (z>>30)) * 0xbf58476d1ce4e5b9UL;
+  z = (z ^ (z>>27)) * 0x94d049bb133111ebUL;
+  return z ^ (z>>31);
+  }
+
+/*==============================================================*/
+/*=== rg_gen_normal2() =========================================*/
+/*==============================================================*/
+/* two independent N(0,1) deviates, from rg_gen_mix(key), rg_gen_mix(key+1), ... (polar method) */
+
+static inline void rg_gen_normal2( unsigned long int key, double *z1, double *z2 ) {
+  unsigned long int h;
+  double u, v, w;
+  do {
+    h = rg_gen_mix(key++);
+    u = ((int) (h>>32))        * (1.0/2147483648.0); /* [-1,1) */
+    v = ((int) (h&0xffffffff)) * (1.0/2147483648.0);
+    w = u*u + v*v;
+    } while ( (w>=1.0) || (w==0.0) );
+  w = sqrt( -2.0*log(w)/w );
+  *z1 = u*w;
+  *z2 = v*w;
+  }
+
+/*==============================================================*/
+/*=== rg_gen_piece() ===========================================*/
+/*==============================================================*/
+/* generates samples n0..n0+n-1 of channel c (0-based) of the current block */
+
+void rg_gen_piece( struct rg_gen_struct *g, long int c, long int n0, long int n ) {
+  struct rg_gen_sig_struct *sig[RG_GEN_MAX_SIG];
+  signed char *x = g->blk + c*g->nDim*RG_NPOL + n0*RG_NPOL;
+  unsigned long int key  = rg_gen_mix( g->seed ^ ((unsigned long int) c << 48) ); /* per channel: noise */
+  unsigned long int keyK = rg_gen_mix( key ^ 0x5bd1e995UL );                        /*   ...and clipping */
+  long int step = 1L << (8-g->bits);
+  long int qmax = (1L << (g->bits-1)) - 1;   /* full scale, in steps */
+  long int s, q;
+  double v[RG_NPOL], t, ph, r;
+  int nSig = 0;
+  int j, i;
+
+  for (j=0;j<g->nSig;j++) if ( (g->sig[j].ch==0) || (g->sig[j].ch==c+1) ) sig[nSig++] = &(g->sig[j]);
+
+  for (s = g->iBlk*(g->nDim-g->overlap) + n0; n>0; n--, s++, x+=RG_NPOL) { /* s: time, in samples */
+
+    /* noise; each sample has 64 hash values of its own (in practice, the polar method uses fewer than 3 per pair) */
+    rg_gen_normal2( key + (s<<6),      &(v[0]), &(v[1]) );
+    rg_gen_normal2( key + (s<<6) + 32, &(v[2]), &(v[3]) );
+    for (i=0;i<RG_NPOL;i++) v[i] *= g->rms;
+
+    t = s*g->tbin;
+    for (j=0;j<nSig;j++) {
+      switch (sig[j]->eType) {
+        case RG_GEN_PULSE:
+          if (fmod(t,sig[j]->period) >= sig[j]->width) break;
+          /* fall through */
+        case RG_GEN_TONE:
+          ph = 2*M_PI*fmod( sig[j]->f*t, 1.0 );
+          v[0] += sig[j]->a*cos(ph); v[1] += sig[j]->a*sin(ph);
+          v[2] += sig[j]->a*cos(ph); v[3] += sig[j]->a*sin(ph);
+          break;
+        case RG_GEN_CLIP:
+          r = (rg_gen_mix( keyK + s*RG_GEN_MAX_SIG + j ) >> 11) * (1.0/9007199254740992.0); /* [0,1) */
+          if (r < sig[j]->p) for (i=0;i<RG_NPOL;i++) v[i] = (v[i]<0) ? -1.0e+6 : +1.0e+6;
+          break;
+        }
+      }
+
+    /* quantize: <bits> bits, in the top of the byte */
+    for (i=0;i<RG_NPOL;i++) {
+      q = (long int) floor( v[i]/step + 0.5 );
+      if (q >  qmax  ) q =  qmax;
+      if (q < -qmax-1) q = -qmax-1;
+      x[i] = (signed char) (q*step);
+      }
+    }
+
+  return;
+  }
+
+/*==============================================================*/
+/*=== rg_gen_thread() ==========================================*/
+/*==============================================================*/
+/* claims and generates pieces of the current block until there are none left */
+
+void *rg_gen_thread( void *arg ) {
+  struct rg_gen_struct *g = arg;
+  long int i, c, n0;
+
+  while ( (i = __sync_fetch_and_add( &(g->iNext), 1 )) < g->nCh*g->nPieces ) {
+    c  = i / g->nPieces;
+    n0 = (i % g->nPieces) * RG_GEN_PIECE;
+    rg_gen_piece( g, c, n0, (n0+RG_GEN_PIECE <= g->nDim) ? RG_GEN_PIECE : g->nDim-n0 );
+    }
+
+  return NULL;
+  }
+
+/*************************************************************************/
+/*** main() **************************************************************/
+/*************************************************************************/
+
+main ( int narg, char *argv[] ) {
+
+  char outfile[RA_MAX_FILENAME_LENGTH];
+  struct rg_gen_struct g;
+  long int nBlk = 1;
+  int nThreads = 1;
+  int bProgress = 1;
+  double obsfreq = 1400.0;
+
+  char header[RG_MAX_HEADER_LENGTH];
+  char value[72];
+  long int nHeader;
+  signed char *buf[2];
+  pthread_t thread[RG_GEN_MAX_THREADS];
+  struct rg_gen_sig_struct *sig;
+  FILE *fp;
+  struct timespec ts0, ts1;
+  double dt;
+  long int b;
+  int i, k;
+
+  int overlap, obsnchan;       /* as read back by rg_analyze_header() */
+  float obsfreq_, obsbw_, chan_bw_;
+  double fs_;
+
+  if (narg<2) {
+    printf("Usage: frsc_gen <file> [-c <nch>] [-n <nblk>] [-b <bits>] [-r <rms>] [-T <tbin>] [-F <MHz>] [-O <n>] [-s <seed>] [-j <n>] [-q]\n");
+    printf("                [-t <ch>,<f>,<a>] [-p <ch>,<f>,<a>,<period>,<width>] [-k <ch>,<p>] ...\n");
+    return;
+    }
+  strcpy(outfile,argv[1]);
+
+  memset(&g,0,sizeof(g));
+  g.nCh     = 32;
+  g.overlap = 0;
+  g.bits    = 8;
+  g.rms     = 16.0;
+  g.tbin    = 1.6e-7;
+  g.seed    = 1;
+  for (i=2;i<narg;i++) {
+    if      ( (strcmp(argv[i],"-c")==0) && (i+1<narg) ) { g.nCh = atol(argv[++i]); }
+    else if ( (strcmp(argv[i],"-n")==0) && (i+1<narg) ) { nBlk = atol(argv[++i]); }
+    else if ( (strcmp(argv[i],"-b")==0) && (i+1<narg) ) { g.bits = atoi(argv[++i]); }
+    else if ( (strcmp(argv[i],"-r")==0) && (i+1<narg) ) { g.rms = atof(argv[++i]); }
+    else if ( (strcmp(argv[i],"-T")==0) && (i+1<narg) ) { g.tbin = atof(argv[++i]); }
+    else if ( (strcmp(argv[i],"-F")==0) && (i+1<narg) ) { obsfreq = atof(argv[++i]); }
+    else if ( (strcmp(argv[i],"-O")==0) && (i+1<narg) ) { g.overlap = atoi(argv[++i]); }
+    else if ( (strcmp(argv[i],"-s")==0) && (i+1<narg) ) { g.seed = strtoul(argv[++i],NULL,0); }
+    else if ( (strcmp(argv[i],"-j")==0) && (i+1<narg) ) { nThreads = atoi(argv[++i]); }
+    else if (strcmp(argv[i],"-q")==0)                   { bProgress = 0; }
+    else if ( ( (strcmp(argv[i],"-t")==0) || (strcmp(argv[i],"-p")==0) || (strcmp(argv[i],"-k")==0) ) && (i+1<narg) ) {
+      if (g.nSig>=RG_GEN_MAX_SIG) {
+        printf("FATAL: main(): more than RG_GEN_MAX_SIG=%d of -t, -p, -k\n",RG_GEN_MAX_SIG);
+        return;
+        }
+      sig = &(g.sig[g.nSig]);
+      switch (argv[i][1]) {
+        case 't': sig->eType = RG_GEN_TONE;  k = (sscanf(argv[i+1],"%d,%lf,%lf",&(sig->ch),&(sig->f),&(sig->a))!=3); break;
+        case 'p': sig->eType = RG_GEN_PULSE; k = (sscanf(argv[i+1],"%d,%lf,%lf,%lf,%lf",&(sig->ch),&(sig->f),&(sig->a),&(sig->period),&(sig->width))!=5) || (sig->period<=0); break;
+        case 'k': sig->eType = RG_GEN_CLIP;  k = (sscanf(argv[i+1],"%d,%lf",&(sig->ch),&(sig->p))!=2); break;
+        }
+      if (k) {
+        printf("FATAL: main(): couldn't make sense of '%s %s'\n",argv[i],argv[i+1]);
+        return;
+        }
+      g.nSig++;
+      i++;
+      }
+    else {
+      printf("FATAL: main(): option '%s' not recognized\n",argv[i]);
+      return;
+      }
+    }
+
+  /* sanity checks */
+  if ( (g.nCh<1) || (g.nCh>RA_MAX_CH_DIV64*64) || (RG_BLK_SIZE % (g.nCh*RG_NPOL)) ) {
+    printf("FATAL: main(): -c %ld; must be a power of 2, 1..%d\n",g.nCh,RA_MAX_CH_DIV64*64);
+    return;
+    }
+  g.nDim = RG_BLK_SIZE/(g.nCh*RG_NPOL);
+  if ( (g.bits<1) || (g.bits>8) ) { printf("FATAL: main(): -b %d; must be 1..8\n",g.bits); return; }
+  if ( (g.overlap<0) || (g.overlap>=g.nDim) ) { printf("FATAL: main(): -O %d; must be 0..%ld\n",g.overlap,g.nDim-1); return; }
+  if (g.tbin<=0) { printf("FATAL: main(): -T %g\n",g.tbin); return; }
+  if (nBlk<1) { printf("FATAL: main(): -n %ld\n",nBlk); return; }
+  if ( (nThreads<1) || (nThreads>RG_GEN_MAX_THREADS) ) { printf("FATAL: main(): -j %d; must be 1..%d\n",nThreads,RG_GEN_MAX_THREADS); return; }
+  for (k=0;k<g.nSig;k++) {
+    if ( (g.sig[k].ch<0) || (g.sig[k].ch>g.nCh) ) { printf("FATAL: main(): channel %d; must be 0..%ld\n",g.sig[k].ch,g.nCh); return; }
+    }
+  g.nPieces = (g.nDim + RG_GEN_PIECE - 1) / RG_GEN_PIECE;
+
+  /* header; the same for every block */
+  memset(header,'\0',RG_MAX_HEADER_LENGTH);
+  rg_header_card(header,"BACKEND", "GUPPI",1);
+  rg_header_card(header,"PKTFMT",  "1SFA",1);
+  rg_header_card(header,"FD_POLN", "LIN",1);
+  rg_header_card(header,"SRC_NAME","FRSC_GEN",1);
+  sprintf(value,"%d",8);                              rg_header_card(header,"NBITS",value,0);
+  sprintf(value,"%d",RG_NPOL);                        rg_header_card(header,"NPOL",value,0);
+  sprintf(value,"%d",RG_BLK_SIZE);                    rg_header_card(header,"BLOCSIZE",value,0);
+  sprintf(value,"%.6f",obsfreq);                      rg_header_card(header,"OBSFREQ",value,0);
+  sprintf(value,"%.6f",g.nCh*1.0e-6/g.tbin);          rg_header_card(header,"OBSBW",value,0);
+  sprintf(value,"%.6f",1.0e-6/g.tbin);                rg_header_card(header,"CHAN_BW",value,0);
+  sprintf(value,"%ld",g.nCh);                         rg_header_card(header,"OBSNCHAN",value,0);
+  sprintf(value,"%.10e",g.tbin);                      rg_header_card(header,"TBIN",value,0);
+  sprintf(value,"%d",g.overlap);                      rg_header_card(header,"OVERLAP",value,0);
+  sprintf(value,"%d",0);                              rg_header_card(header,"DIRECTIO",value,0);
+  sprintf(value,"%d",g.bits);                         rg_header_card(header,"ADCBITS",value,0);
+  sprintf(value,"%lu",g.seed);                        rg_header_card(header,"GENSEED",value,0);
+  strcat(header,"END");
+  nHeader = strlen(header);
+  memset(&(header[nHeader]),' ',80-3);
+  nHeader += 80-3;
+
+  /* check it the way frsc will */
+  if (rg_analyze_header(header,&overlap,&obsfreq_,&obsbw_,&chan_bw_,&obsnchan,&fs_)) return;
+
+  if ( ( (buf[0] = malloc(RG_BLK_SIZE)) == NULL ) || ( (buf[1] = malloc(RG_BLK_SIZE)) == NULL ) ) {
+    printf("FATAL: main(): couldn't malloc() two blocks (%d bytes each)\n",RG_BLK_SIZE);
+    return;
+    }
+  if (!(fp = fopen(outfile,"wb"))) {
+    printf("FATAL: main(): couldn't open '%s'\n",outfile);
+    return;
+    }
+  if (bProgress) {
+    printf("frsc_gen: %ld blocks of %ld channels, %ld samples/channel (OVERLAP %d), fs %.6e Hz, %d-bit, rms %g; %d signals; %d threads\n",
+           nBlk,g.nCh,g.nDim,g.overlap,fs_,g.bits,g.rms,g.nSig,nThreads);
+    }
+
+  /* block b is generated in buf[b%2] while block b-1 is written from the other */
+  clock_gettime(CLOCK_MONOTONIC,&ts0);
+  for (b=0;b<=nBlk;b++) {
+    if (b<nBlk) {
+      g.blk   = buf[b%2];
+      g.iBlk  = b;
+      g.iNext = 0;
+      for (k=0;k<nThreads;k++) {
+        if (pthread_create( &(thread[k]), NULL, rg_gen_thread, &g )) {
+          printf("FATAL: main(): pthread_create() failed\n");
+          return;
+          }
+        }
+      }
+    if (b>0) {
+      if ( (fwrite(header,nHeader,1,fp)!=1) || (fwrite(buf[(b-1)%2],RG_BLK_SIZE,1,fp)!=1) ) {
+        printf("FATAL: main(): couldn't write block %ld to '%s'\n",b-1,outfile);
+        return;
+        }
+      if (bProgress) {
+        clock_gettime(CLOCK_MONOTONIC,&ts1);
+        dt = (ts1.tv_sec-ts0.tv_sec) + (ts1.tv_nsec-ts0.tv_nsec)*1e-9;
+        printf("frsc_gen: block %ld of %ld written; %.1f MB/s\n",b,nBlk,b*(nHeader+(double)RG_BLK_SIZE)/dt/1.0e+6);
+        fflush(stdout);
+        }
+      }
+    if (b<nBlk) for (k=0;k<nThreads;k++) pthread_join( thread[k], NULL );
+    }
+
+  fclose(fp);
+  free(buf[0]);
+  free(buf[1]);
+  return;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// frsc_gen.c: 2026 Oct 19
+//   .2: header cards written by rg_header_card() (ra_guppi_file.c)
+// frsc_gen.c: 2026 Oct 19
+//   .1: initial version
@@ -4,15 +4,52 @@ Show output of frsc when written to file
 ---
 COMPILE: (see makefile)
 ---
-COMMAND LINE SYNTAX, INPUT, OUTPUT: 
-  ra_show_file <infile> <ch>
-  <infile>:  path/name of a frsc output file
+COMMAND LINE SYNTAX, INPUT, OUTPUT:
+  frsc_read <infile> [<ch>] [options]
+  <infile>:  path/name of a frsc output file (uncompressed, compressed, or columnar; i.e., OUTFORMAT 0, 1, or 2)
+             or "shm:<name>" to attach to the shared memory in which frsc is publishing reports (SHM <name> in
+             the job file; see ra_shm.c).  Reports are then handled as they are published, in place, until frsc
+             is done.  Reports missed because frsc_read fell too far behind are counted and noted on stdout.
+             Options -j and -f don't apply.
   <ch>:      if specified, info specific to channel <ch> contained in eType=1 reports is written to "frsc_read.dat"
              valid values are [1..nCh]; values of 0 or less are ignored
+  options:
+    -c <list>    channels to extract, e.g. "30" or "1-4,30,31" (may be used instead of, or in addition to, <ch>)
+    -s <list>    statistics to extract, e.g. "xm2.mean,ym2.mean" or "xm2,u.max".  A component name alone means
+                 all five of its statistics.  Components: xi xq yi yq xm2 ym2 u v.  Statistics: mean max rms s k.
+                 Default is all 40, in that order.
+    -t <t1>:<t2> only reports with t1 <= fStart <= t2 [s]; either may be omitted, e.g. "-t 10:"
+    -n <n1>:<n2> only reports with n1 <= iSeqNo <= n2; either may be omitted
+    -q           don't write the one-line-per-report summary to stdout
+    -j <n>       number of threads (default: number of CPUs)
+    -o <file>    write extracted statistics to <file> instead of "frsc_read.dat"; "-" means stdout, in which
+                 case everything else frsc_read writes (including the summary) goes to stderr
+    -f           follow: after reading what's in the file, wait for frsc to append more, and process new reports
+                 as they become complete (for OUTFORMAT 1 and 2: each time a frame or chunk is completed).
+                 Continues until the file is deleted or renamed, or frsc_read is interrupted.
+    -r <dt>      rebin: instead of one line per eType=1,2 report, write one line per <dt> seconds, computed
+                 from the eType=7 (moments) reports in that interval.  Moments are merged exactly, so this is
+                 the same as running frsc with T0=<dt>, except that max is the true maximum (see ra_moments.c).
+                 With -r, statistic "min" (e.g. "xm2.min") is also available, for min/max envelopes; the
+                 default is all 40 statistics followed by the 8 minima.  Requires frsc to have been run with
+                 tflags b5 set (e.g., "TFLAGS 34").
+    -a           ADC health: instead of statistics, write one line per eType=8 report: iSeqNo, fStart, then for
+                 each channel clips.x, clips.y, and for each of xi, xq, yi, yq, the effective bits and the
+                 fraction of samples with each bit set (b0=LSB .. b7=sign).  Requires frsc to have been run with
+                 tflags b6 set (e.g., "TFLAGS 66").  Not with -s or -r; not for columnar stores (OUTFORMAT 2).
+  frsc_read.dat has one line per eType=1,2 report: iSeqNo, fStart, clips.x, clips.y, then for each channel
+  (in the order given) each statistic (in the order given).  With one channel and the default statistics
+  this is the same 44-column layout as always.  Otherwise the column assignments are printed to stdout.
+  With -r, iSeqNo is that of the first report in the interval, fStart is the start of the interval, and
+  clips are summed over all channels and the interval.
 ---
 REQUIRES
   Nothing special
 
+The file is mmap()'ed and indexed (see ra_reader.c), so a query touches only the reports (and for
+OUTFORMAT 2, only the columns) that it needs.  The reports are divided among threads in contiguous runs,
+and each thread's output is written out in order, so output doesn't depend on the number of threads.
+
 See end of this file for history.
 
 Ideas for Future Feature-adds:
@@ -23,11 +60,656 @@ Ideas for Future Feature-adds:
 #include <string.h>
 #include <stdlib.h> /* for struct timeval, malloc() */
 #include <time.h>
+#include <float.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <signal.h>
+
+#define RA_MAX_FILENAME_LENGTH 1024
 
+#include "ra_aux.c"            /* auxilliary (support) code */
 #include "ra_format.c"         /* output format definition */
 #include "ra_format_defines.h" /* macro defines for field values in ra_format.c */
+#include "ra_moments.c"        /* merging of moments (eType 7) */
+#include "ra_compress.c"       /* decompression of compressed report streams */
+#include "ra_columns.c"        /* columnar statistics store */
+#include "ra_reader.c"         /* mmap'ed, indexed access to report files */
+#include "ra_shm.c"            /* shared memory ring */
+
+#define RQ_MAX_THREADS 256
+#define RQ_FOLLOW_POLL_MS 1000 /* [ms] in follow mode, check the file at least this often, even if no inotify events */
+#define RQ_SHM_POLL_US 1000    /* [us] when attached to shared memory, check for new reports this often */
+#define RQ_MAX_STAT (RA_COL_NPERCH+8) /* the 40 statistics of struct DAPstruct, then (rebinning only) the 8 minima */
+
+/* A query: what to extract from the file */
+struct rq_struct {
+  int nCh;                          /* number of channels to extract */
+  int ch[RA_MAX_CH_DIV64*64];       /* channels, 1..nCh */
+  int nStat;                        /* number of statistics per channel */
+  int stat[RQ_MAX_STAT];            /* statistics; <RA_COL_NPERCH: index into struct DAPstruct viewed as floats */
+                                    /* >=RA_COL_NPERCH: minimum of quantity stat-RA_COL_NPERCH */
+  double t1, t2;                    /* [s] fStart window */
+  long int n1, n2;                  /* iSeqNo window */
+  int bSummary;                     /* write one line per report to stdout? */
+  double dt;                        /* [s] rebinning interval; 0 means don't rebin */
+  int bHealth;                      /* ADC health (eType 8) instead of statistics? */
+  };
+
+/* An interval being rebinned */
+struct rb_struct {
+  long int iBin;                    /* interval is iBin*dt .. (iBin+1)*dt */
+  long int nRep;                    /* number of eType=7 reports merged so far; 0 means empty */
+  long int iSeqNo;                  /* iSeqNo of first of those */
+  struct clips_struct clips;        /* summed over all channels */
+  struct MAPstruct *m;              /* [rq->nCh] merged moments for each channel in the query */
+  };
+
+/* A thread's share of a query: index entries e0..e1-1 */
+struct rw_struct {
+  struct rf_struct *rf;
+  struct rq_struct *rq;
+  long int e0, e1;
+  char *sum;  size_t nSum;          /* summary lines (stdout) */
+  char *dat;  size_t nDat;          /* frsc_read.dat lines */
+  FILE *fsum, *fdat;                /* memory streams for the above */
+  struct rb_struct head;            /* rebinning: first interval seen, which may continue from previous thread */
+  struct rb_struct cur;             /* rebinning: interval in progress; at end, may continue in next thread */
+  int bHead;                        /* has head been set? */
+  pthread_t thread;
+  };
+
+char *rq_comp_names[8] = { "xi", "xq", "yi", "yq", "xm2", "ym2", "u", "v" };
+char *rq_stat_names[6] = { "mean", "max", "rms", "s", "k", "min" };
+
+/*==============================================================*/
+/*=== show_header() ============================================*/
+/*==============================================================*/
+
+void show_header( struct ra_header_struct *header ) {
+  int i;
+  printf("Contents of first report's header:\n");
+  printf("  header.eType=%d\n",header->eType);
+  printf("  header.err=%ld\n",header->err);
+  printf("  header.iReportVersion=%hd\n",header->iReportVersion);
+  printf("  header.iRAVersion=%hd\n",header->iRAVersion);
+  printf("  header.eSource=%d\n",header->eSource);
+  printf("  header.sInfo='%s'\n",header->sInfo);
+  printf("  header.tvStart: UTC %s",asctime(gmtime(&(header->tvStart.tv_sec))));
+  printf("  header.nCh=%ld\n",header->nCh);
+  printf("  header.bw=%lf\n",header->bw);
+  printf("  header.fc=%lf\n",header->fc);
+  printf("  header.fs=%lf\n",header->fs);
+  printf("  header.tflags=0x%02x\n",(0xFF) & header->tflags);
+  printf("  header.fflags=0x%02x\n",(0xFF) & header->fflags);
+  printf("  header.T0=%lf\n",header->T0);
+  printf("  header.T1=%lf\n",header->T1);
+  printf("  header.T2=%lf\n",header->T2);
+  printf("  header.bChIn:   ");
+    for (i=RA_MAX_CH_DIV64-1;i>=0;i--) { printf("0x%016lx ", header->bChIn[i]); }
+  printf("\n");
+  printf("  header.bChInCh: ");
+    for (i=RA_MAX_CH_DIV64-1;i>=0;i--) { printf("0x%016lx ", header->bChInCh[i]); }
+  printf("\n");
+  printf("  header.nSubCh=%ld\n",header->nSubCh);
+  printf("  header.eSubChMethod=%d\n",header->eSubChMethod);
+  printf("  header.eTBL_Method=%d\n",header->eTBL_Method);
+  printf("  header.nTBL_Order=%d\n",header->nTBL_Order);
+  printf("  header.eTBL_Units=%d\n",header->eTBL_Units);
+  printf("  header.nfft=%d\n",header->nfft);
+  printf("  header.nfch=%d\n",header->nfch);
+  printf("  header.eFBL_Method=%d\n",header->eFBL_Method);
+  printf("  header.nFBL_Order=%d\n",header->nFBL_Order);
+  printf("  header.eFBL_Units=%d\n",header->eFBL_Units);
+  printf("  header.iSeqNo=%ld\n",header->iSeqNo);
+  printf("  header.fStart=%lf\n",header->fStart);
+
+  }
+
+/*==============================================================*/
+/*=== rq_parse_channels() ======================================*/
+/*==============================================================*/
+/* parses e.g. "1-4,30,31" into rq->ch[].  returns 0 if OK, 1 otherwise */
+
+int rq_parse_channels( char *s, struct rq_struct *rq ) {
+  int a, b, l;
+  char *p = s;
+  while (*p) {
+    if (sscanf(p,"%d-%d",&a,&b)!=2) {
+      if (sscanf(p,"%d",&a)!=1) return 1;
+      b = a;
+      }
+    if ( (a<1) || (b<a) || (b>RA_MAX_CH_DIV64*64) ) return 1;
+    for (l=a;l<=b;l++) {
+      if (rq->nCh>=RA_MAX_CH_DIV64*64) return 1;
+      rq->ch[rq->nCh++] = l;
+      }
+    while ( (*p) && (*p!=',') ) p++;
+    if (*p==',') p++;
+    }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== rq_parse_stats() =========================================*/
+/*==============================================================*/
+/* parses e.g. "xm2.mean,ym2,u.max" into rq->stat[].  returns 0 if OK, 1 otherwise */
+
+int rq_parse_stats( char *s, struct rq_struct *rq ) {
+  char item[64];
+  char *p = s;
+  char *dot;
+  int n, c, j;
+  int bFound;
+  while (*p) {
+    n = 0;
+    while ( (*p) && (*p!=',') && (n<63) ) { item[n++] = *p++; }
+    item[n] = '\0';
+    if (*p==',') p++;
+    dot = strchr(item,'.');
+    if (dot!=NULL) { *dot = '\0'; dot++; }
+    bFound = 0;
+    for (c=0;c<8;c++) {
+      if (strcmp(item,rq_comp_names[c])) continue;
+      for (j=0;j<6;j++) {
+        if ( (dot!=NULL) && strcmp(dot,rq_stat_names[j]) ) continue;
+        if ( (dot==NULL) && (j==5) ) continue; /* "min" only if asked for */
+        if (rq->nStat>=RQ_MAX_STAT) return 1;
+        rq->stat[rq->nStat++] = (j<5) ? 5*c + j : RA_COL_NPERCH + c;
+        bFound = 1;
+        }
+      }
+    if (!bFound) return 1;
+    }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== rq_want() ================================================*/
+/*==============================================================*/
+/* is this report within the query's window? */
+
+int rq_want( struct rq_struct *rq, long int iSeqNo, double fStart ) {
+  return (iSeqNo>=rq->n1) && (iSeqNo<=rq->n2) && (fStart>=rq->t1) && (fStart<=rq->t2);
+  }
+
+/*==============================================================*/
+/*=== rq_summary() =============================================*/
+/*==============================================================*/
+/* one line per report, for stdout */
+
+void rq_summary( FILE *fp, int eType, long int err, long int iSeqNo, double fStart ) {
+  fprintf(fp,"  header.eType=%d header.err=%ld header.iSeqNo=%ld header.fStart=%lf\n",eType,err,iSeqNo,fStart);
+  }
+
+/*==============================================================*/
+/*=== rq_row_td() ==============================================*/
+/*==============================================================*/
+/* writes one line of frsc_read.dat from an eType=1,2 report */
+
+void rq_row_td( FILE *fp, struct rq_struct *rq, struct ra_header_struct *header, struct ra_td *td ) {
+  int i, j;
+  float *f;
+  fprintf(fp, "%ld", header->iSeqNo);                   // col 1
+  fprintf(fp, " %lf", header->fStart);                  // col 2
+  fprintf(fp, " %ld %ld",td->clips.x,td->clips.y);      // col 3..4
+  for (i=0;i<rq->nCh;i++) {                             // col 5..: for each channel, each statistic
+    f = (float *) &(td->tdac[rq->ch[i]-1]);
+    for (j=0;j<rq->nStat;j++) { fprintf(fp, " %f", f[rq->stat[j]]); }
+    }
+  fprintf(fp,"\n");
+  }
+
+/*==============================================================*/
+/*=== rq_row_th() ==============================================*/
+/*==============================================================*/
+/* writes one line of frsc_read.dat from an eType=8 report */
+
+void rq_row_th( FILE *fp, struct rq_struct *rq, struct ra_header_struct *header, struct ra_th *th ) {
+  struct HPstruct *h;
+  struct HAstruct *ha;
+  long int k;
+  int i, c, b;
+  fprintf(fp, "%ld", header->iSeqNo);                   // col 1
+  fprintf(fp, " %lf", header->fStart);                  // col 2
+  for (i=0;i<rq->nCh;i++) {                             // col 3..: for each channel, 38 columns
+    k = ra_tm_find( header, rq->ch[i] );
+    if ( (k<0) || (k>=th->nChStored) ) {
+      for (c=0;c<2+4*9;c++) { fprintf(fp, " 0"); }
+      continue;
+      }
+    h = &(th->thc[k]);
+    ha = &(h->xi);
+    fprintf(fp, " %ld %ld",h->clips.x,h->clips.y);
+    for (c=0;c<4;c++) {
+      fprintf(fp, " %f",ha[c].bits);
+      for (b=0;b<8;b++) { fprintf(fp, " %f",ha[c].occ[b]); }
+      }
+    }
+  fprintf(fp,"\n");
+  }
+
+/*==============================================================*/
+/*=== rb_alloc(), rb_clear() ===================================*/
+/*==============================================================*/
+
+int rb_alloc( struct rq_struct *rq, struct rb_struct *rb ) {
+  memset( rb, 0, sizeof(struct rb_struct) );
+  if ( (rb->m = malloc( (rq->nCh+1)*sizeof(struct MAPstruct) )) == NULL ) { /* (+1 so never 0) */
+    printf("FATAL: rb_alloc(): malloc() failed\n");
+    return 1;
+    }
+  return 0;
+  }
 
-#define RA_MAX_FILENAME_LENGTH 1024
+void rb_clear( struct rq_struct *rq, struct rb_struct *rb ) {
+  int i;
+  rb->nRep = 0;
+  rb->clips.x = 0;
+  rb->clips.y = 0;
+  for (i=0;i<rq->nCh;i++) { ra_tm_clear( &(rb->m[i]) ); }
+  }
+
+/*==============================================================*/
+/*=== rb_swap() ================================================*/
+/*==============================================================*/
+
+void rb_swap( struct rb_struct *a, struct rb_struct *b ) {
+  struct rb_struct t;
+  t = *a; *a = *b; *b = t;
+  }
+
+/*==============================================================*/
+/*=== rb_merge() ===============================================*/
+/*==============================================================*/
+/* a = a combined with b; b follows a in time */
+
+void rb_merge( struct rq_struct *rq, struct rb_struct *a, struct rb_struct *b ) {
+  int i;
+  if (b->nRep==0) return;
+  if (a->nRep==0) { a->iBin = b->iBin; a->iSeqNo = b->iSeqNo; }
+  a->nRep    += b->nRep;
+  a->clips.x += b->clips.x;
+  a->clips.y += b->clips.y;
+  for (i=0;i<rq->nCh;i++) { ra_tm_merge( &(a->m[i]), &(b->m[i]) ); }
+  }
+
+/*==============================================================*/
+/*=== rb_row() =================================================*/
+/*==============================================================*/
+/* writes one line of frsc_read.dat for a completed interval */
+
+void rb_row( FILE *fp, struct rq_struct *rq, struct rb_struct *rb ) {
+  struct DAPstruct d;
+  float mins[8];
+  int i, j;
+  fprintf(fp, "%ld", rb->iSeqNo);                       // col 1
+  fprintf(fp, " %lf", rb->iBin*rq->dt);                 // col 2
+  fprintf(fp, " %ld %ld",rb->clips.x,rb->clips.y);      // col 3..4
+  for (i=0;i<rq->nCh;i++) {                             // col 5..: for each channel, each statistic
+    ra_tm_finalize( &(rb->m[i]), &d, mins );
+    for (j=0;j<rq->nStat;j++) {
+      fprintf(fp, " %f", (rq->stat[j]<RA_COL_NPERCH) ? ((float *) &d)[rq->stat[j]] : mins[rq->stat[j]-RA_COL_NPERCH] );
+      }
+    }
+  fprintf(fp,"\n");
+  }
+
+/*==============================================================*/
+/*=== rb_report() ==============================================*/
+/*==============================================================*/
+/* merges an eType=7 report into the interval in progress, first finishing that interval if this report is past it */
+
+void rb_report( struct rw_struct *rw, struct ra_header_struct *h, struct ra_tm *tm ) {
+  struct rq_struct *rq = rw->rq;
+  struct rb_struct *rb = &(rw->cur);
+  long int iBin = floor( h->fStart/rq->dt + 1e-6 ); /* (tolerance for fStart being a sum of T0's) */
+  long int k;
+  int i;
+
+  if ( (rb->nRep>0) && (iBin!=rb->iBin) ) {
+    if (!rw->bHead) { /* first interval seen by this thread may have started in the previous thread's share */
+        rb_swap( &(rw->head), rb );
+        rw->bHead = 1;
+      } else {
+        rb_row( rw->fdat, rq, rb );
+      }
+    rb_clear( rq, rb );
+    }
+
+  if (rb->nRep==0) { rb->iBin = iBin; rb->iSeqNo = h->iSeqNo; }
+  rb->nRep++;
+  rb->clips.x += tm->clips.x;
+  rb->clips.y += tm->clips.y;
+  for (i=0;i<rq->nCh;i++) {
+    k = ra_tm_find( h, rq->ch[i] );
+    if ( (k>=0) && (k<tm->nChStored) ) { ra_tm_merge( &(rb->m[i]), &(tm->tmc[k]) ); }
+    }
+  }
+
+/*==============================================================*/
+/*=== rq_report() ==============================================*/
+/*==============================================================*/
+/* handles one report, laid out as in an OUTFORMAT 0 file (header followed by body) */
+
+void rq_report( struct rw_struct *rw, unsigned char *p ) {
+  struct rq_struct *rq = rw->rq;
+  struct ra_header_struct *h = (struct ra_header_struct *) p;
+  if (!rq_want(rq,h->iSeqNo,h->fStart)) return;
+  if (rq->bSummary) { rq_summary( rw->fsum, h->eType, h->err, h->iSeqNo, h->fStart ); }
+  switch (h->eType) {
+    case RA_H_ETYPE_NULL:
+      if ( rq->bSummary && (h->err & (RA_H_ERR_PROFILE|RA_H_ERR_LAG)) ) { fprintf(rw->fsum,"    %s\n",h->sInfo); } /* see ra_prof.c, ra_lag.c */
+      break;
+    case RA_H_ETYPE_TF0:
+    case RA_H_ETYPE_TF1:
+      if ( (rq->nCh>0) && (rq->dt<=0) && !rq->bHealth ) { rq_row_td( rw->fdat, rq, h, (struct ra_td *) (p+sizeof(struct ra_header_struct)) ); }
+      break;
+    case RA_H_ETYPE_TM0:
+      if ( (rq->nCh>0) && (rq->dt>0) ) { rb_report( rw, h, (struct ra_tm *) (p+sizeof(struct ra_header_struct)) ); }
+      break;
+    case RA_H_ETYPE_TH0:
+      if ( (rq->nCh>0) && rq->bHealth ) { rq_row_th( rw->fdat, rq, h, (struct ra_th *) (p+sizeof(struct ra_header_struct)) ); }
+      break;
+    default:
+      /* TODO */
+      break;
+    }
+  }
+
+/*==============================================================*/
+/*=== rq_chunk() ===============================================*/
+/*==============================================================*/
+/* handles one chunk of a columnar store (OUTFORMAT 2).  Only the columns needed are touched. */
+
+void rq_chunk( struct rw_struct *rw, long int e ) {
+  struct rq_struct *rq = rw->rq;
+  struct rf_struct *rf = rw->rf;
+  FILE *fsum = rw->fsum;
+  FILE *fdat = rw->fdat;
+  struct ra_col_chunk_struct *chunk = (struct ra_col_chunk_struct *) &(rf->p[rf->entry[e].offset]);
+  unsigned char *col = ((unsigned char *) chunk) + sizeof(struct ra_col_chunk_struct);
+  int nRec = chunk->nRec;
+  long int *iSeqNo  = (long int *) &(col[ra_col_base_offset(nRec,0)]);
+  double   *fStart  = (double *)   &(col[ra_col_base_offset(nRec,1)]);
+  long int *eType   = (long int *) &(col[ra_col_base_offset(nRec,2)]);
+  long int *err     = (long int *) &(col[ra_col_base_offset(nRec,3)]);
+  long int *clips_x = (long int *) &(col[ra_col_base_offset(nRec,4)]);
+  long int *clips_y = (long int *) &(col[ra_col_base_offset(nRec,5)]);
+  long int kch[RA_MAX_CH_DIV64*64]; /* position of each requested channel among stored channels; -1 if not stored */
+  long int k;
+  int i, j, r;
+
+  for (i=0;i<rq->nCh;i++) {
+    kch[i] = -1;
+    for (k=0;k<rf->colfile->nChStored;k++) { if (rf->colfile->iCh[k]==rq->ch[i]) kch[i] = k; }
+    }
+
+  for (r=0;r<nRec;r++) {
+    if (!rq_want(rq,iSeqNo[r],fStart[r])) continue;
+    if (rq->bSummary) { rq_summary( fsum, eType[r], err[r], iSeqNo[r], fStart[r] ); }
+    if ( (rq->nCh==0) || (rq->dt>0) || rq->bHealth ) continue; /* eType=7,8 reports aren't kept in columnar stores */
+    fprintf(fdat, "%ld", iSeqNo[r]);                    // col 1
+    fprintf(fdat, " %lf", fStart[r]);                   // col 2
+    fprintf(fdat, " %ld %ld",clips_x[r],clips_y[r]);    // col 3..4
+    for (i=0;i<rq->nCh;i++) {                           // col 5..
+      for (j=0;j<rq->nStat;j++) {
+        fprintf(fdat, " %f", (kch[i]<0) ? 0.0 : ((float *) &(col[ra_col_ch_offset(nRec,kch[i],rq->stat[j])]))[r] );
+        }
+      }
+    fprintf(fdat,"\n");
+    }
+  }
+
+/*==============================================================*/
+/*=== rw_run() =================================================*/
+/*==============================================================*/
+/* thread: handles index entries e0..e1-1, writing into its own memory buffers */
+
+void *rw_run( void *arg ) {
+  struct rw_struct *rw = (struct rw_struct *) arg;
+  struct rf_struct *rf = rw->rf;
+  unsigned char *plain = NULL; /* decompressed frame */
+  unsigned char *raw = NULL;   /* scratch */
+  long int nMax = 0;
+  long int nPlain;
+  long int pos;
+  long int e;
+
+  rw->fsum = open_memstream( &(rw->sum), &(rw->nSum) );
+  rw->fdat = open_memstream( &(rw->dat), &(rw->nDat) );
+
+  for (e=rw->e0;e<rw->e1;e++) {
+    switch (rf->eKind) {
+      case RF_PLAIN:
+        rq_report( rw, &(rf->p[rf->entry[e].offset]) );
+        break;
+      case RF_FRAMED:
+        if ( (nPlain = rf_decode_frame( rf, e, &plain, &raw, &nMax )) < 0 ) {
+          fprintf(rw->fsum,"ERROR: rw_run(): corrupt frame at byte %ld\n",rf->entry[e].offset);
+          break;
+          }
+        for (pos=0;pos<nPlain;pos+=sizeof(struct ra_header_struct)+ra_body_size((struct ra_header_struct *) &(plain[pos]))) {
+          rq_report( rw, &(plain[pos]) );
+          }
+        break;
+      case RF_COLUMNS:
+        rq_chunk( rw, e );
+        break;
+      }
+    }
+
+  /* rebinning: if only one interval was seen, it's the head (it may continue from the previous thread) */
+  if ( (!rw->bHead) && (rw->cur.nRep>0) ) {
+    rb_swap( &(rw->head), &(rw->cur) );
+    rw->bHead = 1;
+    }
+
+  fclose(rw->fsum);
+  fclose(rw->fdat);
+  free(plain);
+  free(raw);
+  return NULL;
+  }
+
+/*==============================================================*/
+/*=== rq_run() =================================================*/
+/*==============================================================*/
+/* runs a query over index entries e0..e1-1 using up to nThreads threads, and writes the results in order */
+
+void rq_run(
+             struct rf_struct *rf,    /* [in] the file */
+             struct rq_struct *rq,    /* [in] the query */
+             long int e0,             /* [in] first index entry */
+             long int e1,             /* [in] last index entry + 1 */
+             int nThreads,            /* [in] */
+             FILE *fpo,               /* [in] frsc_read.dat, or NULL */
+             struct rb_struct *carry, /* [in/out] rebinning: interval which may continue past e1 (or into the next thread's share) */
+             int bFinal               /* [in] =1 if there is nothing past e1, so carry is complete */
+             ) {
+  struct rw_struct *rw;
+  int bRebin = (rq->nCh>0) && (rq->dt>0);
+  long int nPer;
+  int t;
+
+  if (e1<=e0) {
+    if ( bRebin && bFinal && (carry->nRep>0) ) { rb_row( fpo, rq, carry ); rb_clear( rq, carry ); }
+    return;
+    }
+  if (nThreads>e1-e0) nThreads = e1-e0;
+  rw = calloc( nThreads, sizeof(struct rw_struct) );
+  nPer = (e1-e0+nThreads-1)/nThreads;
+  for (t=0;t<nThreads;t++) {
+    rw[t].rf = rf;
+    rw[t].rq = rq;
+    if (bRebin) {
+      if ( rb_alloc( rq, &(rw[t].head) ) || rb_alloc( rq, &(rw[t].cur) ) ) return;
+      rb_clear( rq, &(rw[t].head) );
+      rb_clear( rq, &(rw[t].cur) );
+      }
+    rw[t].e0 = e0 + t*nPer;                   if (rw[t].e0>e1) rw[t].e0 = e1;
+    rw[t].e1 = e0 + (t+1)*nPer;               if (rw[t].e1>e1) rw[t].e1 = e1;
+    if (t>0) { pthread_create( &(rw[t].thread), NULL, rw_run, &(rw[t]) ); }
+    }
+  rw_run( &(rw[0]) ); /* this thread does the first share */
+
+  for (t=0;t<nThreads;t++) {
+    if (t>0) { pthread_join( rw[t].thread, NULL ); }
+    fwrite( rw[t].sum, 1, rw[t].nSum, stdout );
+    if (bRebin) { 
+        /* stitch intervals which straddle threads' shares: a thread's rows are preceded by its head, and followed by cur */
+        if (rw[t].bHead) {
+          if ( (carry->nRep>0) && (carry->iBin!=rw[t].head.iBin) ) { rb_row( fpo, rq, carry ); rb_clear( rq, carry ); }
+          rb_merge( rq, carry, &(rw[t].head) );
+          }
+        if ( (rw[t].nDat>0) || (rw[t].cur.nRep>0) ) { /* carry is complete */
+          if (carry->nRep>0) { rb_row( fpo, rq, carry ); rb_clear( rq, carry ); }
+          fwrite( rw[t].dat, 1, rw[t].nDat, fpo );
+          rb_swap( carry, &(rw[t].cur) );
+          }
+        free(rw[t].head.m);
+        free(rw[t].cur.m);
+      } else {
+        if (fpo!=NULL) { fwrite( rw[t].dat, 1, rw[t].nDat, fpo ); }
+      }
+    free(rw[t].sum);
+    free(rw[t].dat);
+    }
+  if ( bRebin && bFinal && (carry->nRep>0) ) { rb_row( fpo, rq, carry ); rb_clear( rq, carry ); }
+  free(rw);
+  }
+
+/*==============================================================*/
+/*=== rq_follow() ==============================================*/
+/*==============================================================*/
+/* follow mode: waits for the file to grow, then runs the query on units which have been completed since. */
+/* Uses inotify to wake up as soon as the file is written; also checks every RQ_FOLLOW_POLL_MS in case inotify */
+/* doesn't see the writes (e.g., file on a network file system). Returns when the file is deleted or renamed. */
+
+void rq_follow(
+                struct rf_struct *rf,    /* [in/out] the file, already indexed */
+                char *infile,            /* [in] its name */
+                struct rq_struct *rq,    /* [in] the query */
+                int nThreads,            /* [in] */
+                FILE *fpo,               /* [in] frsc_read.dat, or NULL */
+                struct rb_struct *carry  /* [in/out] rebinning: interval in progress */
+                ) {
+
+  struct pollfd pfd;
+  struct stat st;
+  char ev[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  struct inotify_event *pev;
+  long int n, i;
+  long int e0;
+  int bGone = 0;
+
+  pfd.fd = inotify_init1(IN_NONBLOCK);
+  pfd.events = POLLIN;
+  if ( (pfd.fd<0) || (inotify_add_watch( pfd.fd, infile, IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF ) < 0) ) {
+    printf("WARNING: rq_follow(): inotify not available; checking every %d ms\n",RQ_FOLLOW_POLL_MS);
+    if (pfd.fd>=0) { close(pfd.fd); }
+    pfd.fd = -1; /* poll() ignores this */
+    }
+
+  while (!bGone) {
+
+    poll( &pfd, 1, RQ_FOLLOW_POLL_MS );
+    if (pfd.fd>=0) {
+      while ( (n = read( pfd.fd, ev, sizeof(ev) )) > 0 ) {
+        for (i=0;i<n;i+=sizeof(struct inotify_event)+pev->len) {
+          pev = (struct inotify_event *) &(ev[i]);
+          if (pev->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) bGone = 1;
+          }
+        }
+      }
+
+    fstat( rf->fd, &st );
+    if (st.st_nlink==0) bGone = 1; /* deleted; we don't get IN_DELETE_SELF while we have it open */
+    if (st.st_size<rf->nBytesIndexed) { /* e.g., frsc was restarted, which truncates the file */
+      printf("NOTE: rq_follow(): '%s' got shorter; starting over\n",infile);
+      rf->nEntries = 0;
+      rf->nBytesIndexed = 0;
+      }
+    e0 = rf->nEntries;
+    if ( (st.st_size!=rf->size) && !rf_map(rf) ) {
+      if (rf_index( rf, NULL )) return; /* not saving the .idx file here; it would be rewritten after every report */
+      }
+
+    rq_run( rf, rq, e0, rf->nEntries, nThreads, fpo, carry, bGone );
+    fflush(stdout);
+    if (fpo!=NULL) fflush(fpo);
+    }
+
+  if (pfd.fd>=0) { close(pfd.fd); }
+  }
+
+/*==============================================================*/
+/*=== rq_shm() =================================================*/
+/*==============================================================*/
+/* consumer of a shared memory ring: runs the query on each report as it is published, until frsc is done. */
+/* Reports are read where they are in the ring.  Output for a report is held back until ra_shm_done() says */
+/* it was intact, and discarded otherwise.  (Rebinning merges it regardless; with a reasonable SHM_SIZE, */
+/* that requires frsc_read to have stalled for seconds in the middle of one report.) */
+
+void rq_shm(
+             struct ra_shm_struct *shm, /* [in/out] attached */
+             struct rq_struct *rq,      /* [in] the query */
+             FILE *fpo                  /* [in] frsc_read.dat, or NULL */
+             ) {
+
+  struct rw_struct rw;
+  unsigned char *p;
+  long int nLost = 0;
+
+  memset(&rw,0,sizeof(rw));
+  rw.rq = rq;
+  rw.bHead = 1; /* there's nothing before us to stitch to, so intervals go straight out */
+  if (rb_alloc( rq, &(rw.cur) )) return;
+  rb_clear( rq, &(rw.cur) );
+  rw.fsum = open_memstream( &(rw.sum), &(rw.nSum) );
+  rw.fdat = open_memstream( &(rw.dat), &(rw.nDat) );
+
+  while (1) {
+
+    if ((p = ra_shm_next(shm))==NULL) {
+      if (ra_shm_finished(shm)) break;
+      fflush(stdout);
+      if (fpo!=NULL) fflush(fpo);
+      usleep(RQ_SHM_POLL_US);
+      continue;
+      }
+
+    rq_report( &rw, p );
+    fflush(rw.fsum);
+    fflush(rw.fdat);
+    if (!ra_shm_done(shm)) {
+      fwrite( rw.sum, 1, rw.nSum, stdout );
+      if (fpo!=NULL) { fwrite( rw.dat, 1, rw.nDat, fpo ); }
+      }
+    fseek( rw.fsum, 0, SEEK_SET );
+    fseek( rw.fdat, 0, SEEK_SET );
+
+    if (shm->nLost>nLost) {
+      printf("WARNING: rq_shm(): fell behind; %ld reports missed (%ld so far)\n",shm->nLost-nLost,shm->nLost);
+      nLost = shm->nLost;
+      }
+    }
+
+  if ( (rq->nCh>0) && (rq->dt>0) && (rw.cur.nRep>0) ) { rb_row( fpo, rq, &(rw.cur) ); }
+  printf("rq_shm(): frsc is done; %ld reports missed\n",shm->nLost);
+  fclose(rw.fsum);
+  fclose(rw.fdat);
+  free(rw.sum);
+  free(rw.dat);
+  free(rw.cur.m);
+  }
 
 /*************************************************************************/
 /*** main() **************************************************************/
@@ -39,169 +721,211 @@ main ( int narg, char *argv[] ) {
   /*=== Variables ===*/
   /*=================*/
 
-  /* command line parameters */ 
-  char infile[RA_MAX_FILENAME_LENGTH]; /* name of jobfile */
-
-  struct ra_header_struct header; /* output report header; contains parameters that define operation */
-  struct ra_td td;                /* this is what gets written as body of report */
-  FILE *fp;
-  FILE *fpo;
-
-  int i;
-  int n;
+  /* command line parameters */
+  char infile[RA_MAX_FILENAME_LENGTH];  /* name of report file */
+  char idxfile[RA_MAX_FILENAME_LENGTH+8]; /* name of its index file: "<infile>.idx" */
+  char outfile[RA_MAX_FILENAME_LENGTH]; /* name of output file */
+
+  struct rf_struct rf;            /* the report file */
+  struct ra_shm_struct shm;       /* ...or the shared memory ring */
+  struct ra_header_struct *header0;
+  struct rq_struct rq;            /* what we want from it */
+  FILE *fpo = NULL;
+  FILE *fpStd = NULL;             /* stdout, if "-o -"; then stdout itself is stderr */
+  struct rb_struct carry;         /* rebinning: interval in progress */
+  struct stat st;
+
+  int i, j;
   int ch;
-
-  int bFirst;
+  int nThreads;
+  long int e0, e1;
+  char *colon;
+  int bFollow = 0;
+  int bShm;
 
   /*======================================*/
   /*=== Acquire Command Line Arguments ===*/
   /*======================================*/
 
-  /* read <jobfile> */
+  memset(&rq,0,sizeof(rq));
+  rq.t1 = -DBL_MAX; rq.t2 = DBL_MAX;
+  rq.n1 = -1;       rq.n2 = 0x7FFFFFFFFFFFFFFFL;
+  rq.bSummary = 1;
+  nThreads = sysconf(_SC_NPROCESSORS_ONLN);
+  sprintf(outfile,"frsc_read.dat");
+
+  /* read <infile> */
   memset(infile,'\0',RA_MAX_FILENAME_LENGTH);  /* just in case */
   if (narg>=2) {
       sscanf( argv[1], "%s", infile );
     } else {
       printf("FATAL: main(): <infile> not specified\n");
       return;
-    } 
-  printf("<infile>='%s'\n",infile);
+    }
 
   ch=0;
-  if (narg>=3) {
+  i=2;
+  if ( (narg>=3) && (argv[2][0]!='-') ) {
     sscanf( argv[2], "%d", &ch );
-    } 
+    if (ch>0) { rq.ch[rq.nCh++] = ch; }
+    i=3;
+    }
+
+  for (;i<narg;i++) {
+    if (strcmp(argv[i],"-q")==0) { rq.bSummary = 0; continue; }
+    if (strcmp(argv[i],"-f")==0) { bFollow = 1; continue; }
+    if (strcmp(argv[i],"-a")==0) { rq.bHealth = 1; continue; }
+    if (i+1>=narg) {
+      printf("FATAL: main(): option '%s' needs a value\n",argv[i]);
+      return;
+      }
+    if (strcmp(argv[i],"-c")==0) {
+        if (rq_parse_channels(argv[++i],&rq)) { printf("FATAL: main(): bad channel list '%s'\n",argv[i]); return; }
+      } else if (strcmp(argv[i],"-s")==0) {
+        if (rq_parse_stats(argv[++i],&rq)) { printf("FATAL: main(): bad statistics list '%s'\n",argv[i]); return; }
+      } else if ( (strcmp(argv[i],"-t")==0) || (strcmp(argv[i],"-n")==0) ) {
+        colon = strchr(argv[i+1],':');
+        if (colon==NULL) { printf("FATAL: main(): '%s' needs <from>:<to>\n",argv[i]); return; }
+        if (argv[i][1]=='t') {
+            if (colon!=argv[i+1]) sscanf(argv[i+1],"%lf",&rq.t1);
+            if (*(colon+1))       sscanf(colon+1,"%lf",&rq.t2);
+          } else {
+            if (colon!=argv[i+1]) sscanf(argv[i+1],"%ld",&rq.n1);
+            if (*(colon+1))       sscanf(colon+1,"%ld",&rq.n2);
+          }
+        i++;
+      } else if (strcmp(argv[i],"-r")==0) {
+        sscanf(argv[++i],"%lf",&rq.dt);
+        if (rq.dt<=0) { printf("FATAL: main(): -r needs an interval > 0\n"); return; }
+      } else if (strcmp(argv[i],"-j")==0) {
+        sscanf(argv[++i],"%d",&nThreads);
+      } else if (strcmp(argv[i],"-o")==0) {
+        sscanf(argv[++i],"%s",outfile);
+      } else {
+        printf("FATAL: main(): option '%s' not recognized\n",argv[i]);
+        return;
+      }
+    }
+  if (nThreads<1) nThreads = 1;
+  if (nThreads>RQ_MAX_THREADS) nThreads = RQ_MAX_THREADS;
+
+  /* "-o -": the statistics get stdout to themselves, so they can be piped; the rest goes to stderr */
+  if ( (rq.nCh>0) && (strcmp(outfile,"-")==0) ) {
+    fflush(stdout);
+    if ( ((fpStd = fdopen( dup(STDOUT_FILENO), "w" ))==NULL) || (dup2( STDERR_FILENO, STDOUT_FILENO )<0) ) {
+      printf("FATAL: main(): couldn't separate stdout from stderr\n");
+      return;
+      }
+    }
+  printf("<infile>='%s'\n",infile);
   printf("<ch>=%d\n",ch);
+  if ( rq.bHealth && ( (rq.nStat>0) || (rq.dt>0) ) ) {
+    printf("FATAL: main(): -a can't be used with -s or -r\n");
+    return;
+    }
+  if (rq.nStat==0) { /* default: all statistics, in the order they appear in struct DAPstruct; then minima if rebinning */
+    for (i=0;i<RA_COL_NPERCH;i++) { rq.stat[rq.nStat++] = i; }
+    if (rq.dt>0) { for (i=0;i<8;i++) { rq.stat[rq.nStat++] = RA_COL_NPERCH+i; } }
+    }
+  for (i=0;i<rq.nStat;i++) {
+    if ( (rq.stat[i]>=RA_COL_NPERCH) && (rq.dt<=0) ) {
+      printf("FATAL: main(): minima are available only when rebinning (-r)\n");
+      return;
+      }
+    }
 
-  //return;
+  bShm = (strncmp(infile,"shm:",4)==0);
+  if (bShm) { /* attach to shared memory, waiting for frsc to create it and publish the first report if necessary */
+    while ( ra_shm_attach( &shm, &(infile[4]) ) ) { usleep(RQ_FOLLOW_POLL_MS*1000); }
+    while ( __atomic_load_n( &(shm.head->wpos), __ATOMIC_ACQUIRE ) == 0 ) { usleep(RQ_SHM_POLL_US); }
+    header0 = &(shm.head->header0);
+    printf("Attached to shared memory '%s'\n",&(infile[4]));
+    }
 
-  /* open the input file */
-  if (!(fp = fopen(infile,"rb"))) {
-    printf("FATAL: main(): infile='%s' not found\n",infile);
-    return;
+  /* open and index the input file */
+  if (!bShm) {
+    while ( bFollow && ( (stat(infile,&st)!=0) || (st.st_size<sizeof(struct ra_col_file_struct)) ) ) {
+      usleep(RQ_FOLLOW_POLL_MS*1000); /* wait for frsc to get started */
+      }
+    sprintf(idxfile,"%s.idx",infile);
+    if (rf_open( &rf, infile, idxfile )) {
+      printf("FATAL: main(): couldn't read infile='%s'\n",infile);
+      return;
+      }
+    if (rf.eKind==RF_FRAMED)  { printf("File is compressed (OUTFORMAT 1)\n"); }
+    if (rf.eKind==RF_COLUMNS) { printf("File is a columnar store (OUTFORMAT 2)\n"); }
+    header0 = &(rf.header0);
+    }
+  for (i=0;i<rq.nCh;i++) {
+    if (rq.ch[i]>header0->nCh) { printf("WARNING: main(): channel %d is not in this file\n",rq.ch[i]); }
     }
 
   /* open output file, if necessary */
-  if (ch>0) {
-    if (!(fpo = fopen("frsc_read.dat","w"))) {
+  if (rq.nCh>0) {
+    if (fpStd) {
+        fpo = fpStd;
+      } else if (!(fpo = fopen(outfile,"w"))) {
       printf("FATAL: main(): couldn't fopen() output file\n");
       return;
       }
-    }
-
-  /* read the header */
-  fread( &header, sizeof(struct ra_header_struct), 1, fp ); 
-
-  bFirst = 1;
-  while ( !feof(fp) ) {
-
-    /* if this is the first header we've seen, show it: */
-    if (bFirst) {
-      bFirst = 0;
-
-      printf("Contents of first report's header:\n");
-      printf("  header.eType=%d\n",header.eType);
-      printf("  header.err=%ld\n",header.err);
-      printf("  header.iReportVersion=%hd\n",header.iReportVersion);
-      printf("  header.iRAVersion=%hd\n",header.iRAVersion);
-      printf("  header.eSource=%d\n",header.eSource);
-      printf("  header.sInfo='%s'\n",header.sInfo);       
-      printf("  header.tvStart: UTC %s",asctime(gmtime(&(header.tvStart.tv_sec))));
-      printf("  header.nCh=%ld\n",header.nCh);
-      printf("  header.bw=%lf\n",header.bw);
-      printf("  header.fc=%lf\n",header.fc);
-      printf("  header.fs=%lf\n",header.fs);
-      printf("  header.tflags=0x%02x\n",(0xFF) & header.tflags);
-      printf("  header.fflags=0x%02x\n",(0xFF) & header.fflags);
-      printf("  header.T0=%lf\n",header.T0);
-      printf("  header.T1=%lf\n",header.T1);
-      printf("  header.T2=%lf\n",header.T2);
-      printf("  header.bChIn:   ");
-        for (i=RA_MAX_CH_DIV64-1;i>=0;i--) { printf("0x%016lx ", header.bChIn[i]); }
-      printf("\n");
-      printf("  header.bChInCh: ");
-        for (i=RA_MAX_CH_DIV64-1;i>=0;i--) { printf("0x%016lx ", header.bChInCh[i]); }
+    if (rq.bHealth) {
+        printf("Columns of '%s': 1=iSeqNo 2=fStart",outfile);
+        for (i=0;i<rq.nCh;i++) {
+          printf(" %d=ch%d.clips.x %d=ch%d.clips.y",3+38*i,rq.ch[i],4+38*i,rq.ch[i]);
+          for (j=0;j<4;j++) {
+            printf(" %d=ch%d.%s.bits %d..%d=ch%d.%s.b0..b7",5+38*i+9*j,rq.ch[i],rq_comp_names[j],6+38*i+9*j,13+38*i+9*j,rq.ch[i],rq_comp_names[j]);
+            }
+          }
+        printf("\n");
+      } else if ( (rq.nCh>1) || (rq.nStat!=RA_COL_NPERCH) ) {
+      printf("Columns of '%s': 1=iSeqNo 2=fStart 3=clips.x 4=clips.y",outfile);
+      for (i=0;i<rq.nCh*rq.nStat;i++) {
+        j = rq.stat[i%rq.nStat];
+        if (j<RA_COL_NPERCH) {
+            printf(" %d=ch%d.%s.%s",5+i,rq.ch[i/rq.nStat],rq_comp_names[j/5],rq_stat_names[j%5]);
+          } else {
+            printf(" %d=ch%d.%s.min",5+i,rq.ch[i/rq.nStat],rq_comp_names[j-RA_COL_NPERCH]);
+          }
+        }
       printf("\n");
-      printf("  header.nSubCh=%ld\n",header.nSubCh);
-      printf("  header.eSubChMethod=%d\n",header.eSubChMethod);
-      printf("  header.eTBL_Method=%d\n",header.eTBL_Method);
-      printf("  header.nTBL_Order=%d\n",header.nTBL_Order);
-      printf("  header.eTBL_Units=%d\n",header.eTBL_Units);
-      printf("  header.nfft=%d\n",header.nfft);
-      printf("  header.nfch=%d\n",header.nfch);
-      printf("  header.eFBL_Method=%d\n",header.eFBL_Method);
-      printf("  header.nFBL_Order=%d\n",header.nFBL_Order);
-      printf("  header.eFBL_Units=%d\n",header.eFBL_Units);
-      printf("  header.iSeqNo=%ld\n",header.iSeqNo);
-      printf("  header.fStart=%lf\n",header.fStart);
-
-      printf("Now summarizing all reports found, one line per report in order received:\n");
-
-      } /* if (bFirst) */
-
-    printf("  ");
-    printf("header.eType=%d ",header.eType);
-    printf("header.err=%ld ",header.err);
-    printf("header.iSeqNo=%ld ",header.iSeqNo);
-    printf("header.fStart=%lf",header.fStart);
-    printf("\n");
-
-    /* read rest of report */
-    switch (header.eType) {
-
-      case RA_H_ETYPE_NULL:
-        /* nothing else to do */
-        break;
+      }
+    if (rq.dt>0) { printf("Rebinning eType=7 reports to %lf s intervals\n",rq.dt); }
+    }
 
-      case RA_H_ETYPE_TF0:
-      case RA_H_ETYPE_TF1:
-
-        /* remaining data is in a "struct ra_td"; read that */
-        fread( &td, sizeof(struct ra_td), 1, fp );
-
-        /* save data to file */
-        fprintf(fpo, "%ld", header.iSeqNo);              // col 1
-        fprintf(fpo, " %lf", header.fStart);              // col 2
-        fprintf(fpo, " %ld %ld",td.clips.x,td.clips.y);  // col 3..4
-
-        if (ch>0) {
-          n = ch-1;
-
-          fprintf(fpo, " %f %f %f %f %f %f %f %f %f %f", // col 5..14
-            td.tdac[n].xi.mean, td.tdac[n].xi.max, td.tdac[n].xi.rms, td.tdac[n].xi.s, td.tdac[n].xi.k,
-            td.tdac[n].xq.mean, td.tdac[n].xq.max, td.tdac[n].xq.rms, td.tdac[n].xq.s, td.tdac[n].xq.k
-            );
-          fprintf(fpo, " %f %f %f %f %f %f %f %f %f %f", // col 15..24
-            td.tdac[n].yi.mean, td.tdac[n].yi.max, td.tdac[n].yi.rms, td.tdac[n].yi.s, td.tdac[n].yi.k,
-            td.tdac[n].yq.mean, td.tdac[n].yq.max, td.tdac[n].yq.rms, td.tdac[n].yq.s, td.tdac[n].yq.k
-            );
-          fprintf(fpo, " %f %f %f %f %f %f %f %f %f %f", // col 25..34
-            td.tdac[n].xm2.mean, td.tdac[n].xm2.max, td.tdac[n].xm2.rms, td.tdac[n].xm2.s, td.tdac[n].xm2.k,
-            td.tdac[n].ym2.mean, td.tdac[n].ym2.max, td.tdac[n].ym2.rms, td.tdac[n].ym2.s, td.tdac[n].ym2.k
-            );
-          fprintf(fpo, " %f %f %f %f %f %f %f %f %f %f", // col 35..44
-            td.tdac[n].u.mean, td.tdac[n].u.max, td.tdac[n].u.rms, td.tdac[n].u.s, td.tdac[n].u.k,
-            td.tdac[n].v.mean, td.tdac[n].v.max, td.tdac[n].v.rms, td.tdac[n].v.s, td.tdac[n].v.k
-            );
-          fprintf(fpo,"\n");        
-
-          } /* if (ch>0) */
+  show_header( header0 );
 
-        break;
+  if (bShm) {
+    if (rq.bSummary) { printf("Now summarizing all reports found, one line per report in order received:\n"); }
+    rq_shm( &shm, &rq, fpo );
+    ra_shm_detach( &shm );
+    if ( (fpo!=NULL) && (fpo!=stdout) ) { fclose(fpo); }
+    return;
+    }
 
-      default:
-        /* TODO */
-        break;
+  /* find the part of the file that matters */
+  e0 = rf_lower_bound( &rf, rq.t1, rq.n1 );
+  e1 = rf_upper_bound( &rf, rq.t2, rq.n2 );
 
-      } /* switch (header.eType) */
+  if (rq.bSummary) {
+    printf("Now summarizing all reports found, one line per report in order received:\n");
+    if ( (rf.eKind==RF_COLUMNS) && rq_want(&rq,rf.header0.iSeqNo,rf.header0.fStart) ) { /* eType=0 report isn't in any chunk */
+      rq_summary( stdout, rf.header0.eType, rf.header0.err, rf.header0.iSeqNo, rf.header0.fStart );
+      }
+    }
+  fflush(stdout);
 
-    /* attempt to read the next header */
-    fread( &header, sizeof(struct ra_header_struct), 1, fp ); 
+  if (rb_alloc( &rq, &carry )) return;
+  rb_clear( &rq, &carry );
 
-    } /* while ( !feof(fp) ) */
+  rq_run( &rf, &rq, e0, e1, nThreads, fpo, &carry, !bFollow );
+  if (bFollow) {
+    if (fpo!=NULL) { fflush(fpo); }
+    rq_follow( &rf, infile, &rq, nThreads, fpo, &carry );
+    }
 
-  fclose(fp); 
-  if (ch>0) { fclose(fpo); }
+  rf_close(&rf);
+  free(carry.m);
+  if ( (fpo!=NULL) && (fpo!=stdout) ) { fclose(fpo); }
 
   return;
   } /* main() */
@@ -209,6 +933,16 @@ main ( int narg, char *argv[] ) {
 //==================================================================================
 //=== HISTORY ======================================================================
 //==================================================================================
+// frsc_read.c: 2026 Oct 19
+//   .9: shows lag (eType 0, RA_H_ERR_LAG) reports in the summary
+//   .8: ADC health (eType 8) reports (-a); shows profiling (eType 0) reports in the summary
+//   .7: attaches to shared memory ring as a consumer ("shm:<name>"; ra_shm.c)
+//   .6: follow mode (-f) using inotify; "-o -" for stdout (and then everything else to stderr)
+//   .5: rebinning of eType 7 (moments) reports to any longer interval (-r), with minima
+//   .4: file is mmap'ed and indexed (ra_reader.c); queries on any set of channels and statistics,
+//       fStart and iSeqNo windows, multithreaded, summary optional (-c -s -t -n -j -q -o)
+//   .3: reads columnar stores (mmap); show_header(), write_ch()
+//   .2: reads compressed (framed) report streams; rr_open(), rr_next()
 // frsc_read.c: S.W. Ellingson, Virginia Tech, 2014 Jan 25
 //   .1: changed name, making improvements
 // ra_show.c: S.W. Ellingson, Virginia Tech, 2013 Dec 14
@@ -0,0 +1,192 @@
+/*============================================================================
+frsc_sub.c: 2026 Oct 19
+Minimal subscriber to the reports published by frsc (STREAM in the job file; see ra_stream.c)
+---
+COMPILE: (see makefile)
+---
+COMMAND LINE SYNTAX, INPUT, OUTPUT:
+  frsc_sub <addr> [options]
+  <addr>:    where frsc is publishing: "unix:<path>" or "tcp:[<host>:]<port>" (host defaults to localhost)
+  options:
+    -o <file>  also write the reports, as received, to <file>.  This is an OUTFORMAT 0 file, so it can be
+               read with frsc_read, including while it's growing (frsc_read -f).
+    -q         don't write the one-line-per-report summary to stdout
+    -w         if frsc isn't publishing yet, keep trying to connect (10 times a second) instead of giving up
+  Runs until frsc closes the connection.
+---
+REQUIRES
+  Nothing special
+
+See end of this file for history.
+============================================================================*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <float.h>
+#include <math.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+
+#include "ra_aux.c"            /* auxilliary (support) code */
+#include "ra_format.c"         /* output format definition */
+#include "ra_format_defines.h" /* macro defines for field values in ra_format.c */
+#include "ra_moments.c"        /* eType 7 body size */
+#include "ra_compress.c"       /* ra_body_size() */
+
+#define RA_MAX_FILENAME_LENGTH 1024
+
+/*==============================================================*/
+/*=== rs_connect() =============================================*/
+/*==============================================================*/
+/* returns a connected socket, or -1 */
+
+int rs_connect( char *addr ) {
+
+  struct sockaddr_un saun;
+  struct sockaddr_in sain;
+  struct hostent *he;
+  char host[RA_MAX_FILENAME_LENGTH];
+  char *colon;
+  int fd;
+
+  if (strncmp(addr,"unix:",5)==0) {
+    memset(&saun,0,sizeof(saun));
+    saun.sun_family = AF_UNIX;
+    strncpy(saun.sun_path,&(addr[5]),sizeof(saun.sun_path)-1);
+    if ((fd = socket(AF_UNIX,SOCK_STREAM,0))<0) return -1;
+    if (connect(fd,(struct sockaddr *) &saun,sizeof(saun))<0) { close(fd); return -1; }
+    return fd;
+    }
+
+  if (strncmp(addr,"tcp:",4)==0) {
+    memset(&sain,0,sizeof(sain));
+    sain.sin_family = AF_INET;
+    strcpy(host,"localhost");
+    if ((colon = strrchr(&(addr[4]),':'))!=NULL) {
+        strncpy(host,&(addr[4]),colon-&(addr[4]));
+        host[colon-&(addr[4])] = '\0';
+        sain.sin_port = htons(atoi(colon+1));
+      } else {
+        sain.sin_port = htons(atoi(&(addr[4])));
+      }
+    if ((he = gethostbyname(host))==NULL) return -1;
+    memcpy(&(sain.sin_addr),he->h_addr_list[0],sizeof(sain.sin_addr));
+    if ((fd = socket(AF_INET,SOCK_STREAM,0))<0) return -1;
+    if (connect(fd,(struct sockaddr *) &sain,sizeof(sain))<0) { close(fd); return -1; }
+    return fd;
+    }
+
+  return -1;
+  }
+
+/*==============================================================*/
+/*=== rs_read() ================================================*/
+/*==============================================================*/
+/* reads exactly n bytes.  returns 0 if OK, 1 if the connection closed first */
+
+int rs_read( int fd, void *buf, long int n ) {
+  long int k;
+  while (n>0) {
+    k = read(fd,buf,n);
+    if (k<=0) return 1;
+    buf = (char *) buf + k;
+    n -= k;
+    }
+  return 0;
+  }
+
+/*************************************************************************/
+/*** main() **************************************************************/
+/*************************************************************************/
+
+main ( int narg, char *argv[] ) {
+
+  char addr[RA_MAX_FILENAME_LENGTH];
+  char outfile[RA_MAX_FILENAME_LENGTH];
+  int bSummary = 1;
+  int bWait = 0;
+
+  int fd;
+  FILE *fpo = NULL;
+  struct ra_header_struct header;
+  char *body;
+  long int nBody;
+  long int nBodyMax;
+  long int nReports = 0;
+  int i;
+
+  if (narg<2) {
+    printf("Usage: frsc_sub <addr> [-o <file>] [-q] [-w]\n");
+    return;
+    }
+  strcpy(addr,argv[1]);
+  outfile[0] = '\0';
+  for (i=2;i<narg;i++) {
+    if      ( (strcmp(argv[i],"-o")==0) && (i+1<narg) ) { strcpy(outfile,argv[++i]); }
+    else if (strcmp(argv[i],"-q")==0)                   { bSummary = 0; }
+    else if (strcmp(argv[i],"-w")==0)                   { bWait = 1; }
+    else {
+      printf("FATAL: main(): option '%s' not recognized\n",argv[i]);
+      return;
+      }
+    }
+
+  while ((fd = rs_connect(addr))<0) {
+    if (!bWait) {
+      printf("FATAL: main(): couldn't connect to '%s'\n",addr);
+      return;
+      }
+    usleep(100000);
+    }
+  fprintf(stderr,"frsc_sub: connected to '%s'\n",addr);
+
+  if (outfile[0]) {
+    if (!(fpo = fopen(outfile,"wb"))) {
+      printf("FATAL: main(): couldn't open '%s'\n",outfile);
+      return;
+      }
+    }
+
+  nBodyMax = sizeof(struct ra_td);
+  body = malloc(nBodyMax);
+
+  while (!rs_read(fd,&header,sizeof(header))) {
+    nBody = ra_body_size(&header);
+    if (nBody<0) {
+      printf("FATAL: main(): eType=%d not recognized; stream is corrupt\n",header.eType);
+      break;
+      }
+    if (nBody>nBodyMax) {
+      nBodyMax = nBody;
+      body = realloc(body,nBodyMax);
+      }
+    if ( (nBody>0) && rs_read(fd,body,nBody) ) break; /* partial report at end; discarded */
+    nReports++;
+    if (bSummary) {
+      printf("  header.eType=%d header.err=%ld header.iSeqNo=%ld header.fStart=%lf\n",header.eType,header.err,header.iSeqNo,header.fStart);
+      fflush(stdout);
+      }
+    if (fpo!=NULL) {
+      fwrite(&header,sizeof(header),1,fpo);
+      if (nBody>0) fwrite(body,nBody,1,fpo);
+      fflush(fpo);
+      }
+    }
+
+  fprintf(stderr,"frsc_sub: connection closed after %ld reports\n",nReports);
+  if (fpo!=NULL) fclose(fpo);
+  close(fd);
+  free(body);
+  return;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// frsc_sub.c: 2026 Oct 19
+//   .1: initial version
@@ -0,0 +1,297 @@
+/*===============================================================
+ra_arena.c: 2026 Oct 19
+arenas: working memory, allocated once, handed out in aligned slices
+---
+All of the memory frsc works in (the GUPPI block or piece, the T0 buffer, sliding windows, and the bodies
+of eType 1, 7, and 8 reports) comes from an arena, which is allocated once, at startup, and sized by the RAM
+budget (ra_mem_arena(); see ra_mem.c).  ra_arena_alloc() hands out slices, each aligned to
+RA_ARENA_ALIGN (64) bytes, a cache line, so SIMD loads of the start of a channel never straddle lines;
+an arena of RA_ARENA_HUGE (2 MB) or more is itself aligned to RA_ARENA_HUGE, the size of a huge page.
+Nothing is freed slice by slice: memory needed only while a window is being analyzed is taken after
+ra_arena_mark() and given back, all at once, by ra_arena_reset().  So once frsc is running, there is no
+malloc() or free() at all.
+
+Each thread that analyzes data has its own struct ra_work_struct: its arena, and the report bodies
+and scratch it fills (what were the raa_* globals of ra_analyze.c).  ra_work_thread() says which is the
+calling thread's, the way ra_prof_thread() does for profiling; ra_analyze() uses ra_work.
+
+Placement (struct ra_place_struct, from the job file):
+  HUGEPAGES <0|1|2>  0: ordinary 4 KB pages (default).  1: transparent huge pages; the arena is mmap()'ed
+                     on a 2 MB boundary and madvise(MADV_HUGEPAGE)'d, so the kernel backs it with 2 MB
+                     pages where it can (THP "madvise" or "always" mode).  2: explicit huge pages
+                     (MAP_HUGETLB), which must have been reserved (vm.nr_hugepages); if they can't be
+                     had, 1 is used instead.  A 1 GB block takes ~512 TLB entries in 2 MB pages, rather
+                     than ~262k in 4 KB pages.
+  CPUS <list>        the thread that creates a work struct is pinned (sched_setaffinity()) to these CPUs,
+                     e.g. "0-7,16"; in frsc, that's main(), which both reads and analyzes.
+  NUMA_NODE <n>      the thread is pinned to the CPUs of node <n> (those in CPUS, if also given; see
+                     /sys/devices/system/node), and then touches every page of its arena before using
+                     it; with Linux's default (local) policy, each page goes where it's first touched,
+                     so the memory is on node <n>, next to the CPUs which use it.  No libnuma needed.
+================================================================*/
+
+#define RA_ARENA_ALIGN 64                     /* [bytes] slices */
+#define RA_ARENA_HUGE  (2L*1024L*1024L)       /* [bytes] arenas at least this big */
+
+#define RA_HUGE_NONE 0                        /* HUGEPAGES */
+#define RA_HUGE_THP  1
+#define RA_HUGE_TLB  2
+
+/* n rounded up to a whole number of RA_ARENA_ALIGN */
+#define RA_ARENA_ROUND(n) ( ( (long int)(n) + RA_ARENA_ALIGN-1 ) & ~((long int) RA_ARENA_ALIGN-1) )
+
+struct ra_arena_struct {
+  char *base;                   /* NULL if not allocated */
+  long int size;                /* [bytes] */
+  long int used;                /* [bytes] handed out so far */
+  long int high;                /* [bytes] most ever handed out */
+  char *map;                    /* if mmap()'ed (HUGEPAGES), what to munmap(); else NULL */
+  long int nMap;                /* [bytes] */
+  int eHuge;                    /* RA_HUGE_..., as it turned out */
+  };
+
+struct ra_place_struct {        /* where a work struct's thread runs and its memory lives (see above) */
+  int eHuge;                    /* HUGEPAGES: RA_HUGE_... */
+  char cpus[RA_MAX_FILENAME_LENGTH]; /* CPUS; empty = any */
+  int node;                     /* NUMA_NODE; -1 = any */
+  };
+
+struct ra_work_struct {         /* one analysis thread's working memory */
+  struct ra_arena_struct arena;
+  struct ra_td *td;             /* body of eType 1 report */
+  struct ra_tm *tm;             /* body of eType 7 report (moments) */
+  struct ra_th *th;             /* body of eType 8 report (ADC health) */
+  };
+
+__thread struct ra_work_struct *ra_work = NULL; /* this thread's; see ra_work_thread() */
+
+/*==============================================================*/
+/*=== ra_arena_init() ==========================================*/
+/*==============================================================*/
+/* returns 0 if OK, 1 if the memory can't be had */
+
+int ra_arena_init(
+                   struct ra_arena_struct *a,   /* [out] */
+                   long int size,               /* [in] [bytes] */
+                   int eHuge                    /* [in] HUGEPAGES: RA_HUGE_... */
+                  ) {
+  long int off;
+
+  memset( a, 0, sizeof(struct ra_arena_struct) );
+  a->size = RA_ARENA_ROUND(size);
+
+  if (eHuge==RA_HUGE_TLB) { /* whole huge pages; already aligned */
+    a->nMap = (a->size + RA_ARENA_HUGE-1) & ~(RA_ARENA_HUGE-1);
+    a->map = mmap( NULL, a->nMap, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0 );
+    if (a->map!=MAP_FAILED) {
+      a->base = a->map;
+      a->eHuge = RA_HUGE_TLB;
+      return 0;
+      }
+    printf("WARNING: ra_arena_init(): MAP_HUGETLB failed for %ld bytes (are huge pages reserved?); using transparent huge pages\n",a->nMap);
+    eHuge = RA_HUGE_THP;
+    }
+
+  if (eHuge==RA_HUGE_THP) { /* one huge page more than needed, so that base can be on a huge page boundary */
+    a->nMap = a->size + RA_ARENA_HUGE;
+    a->map = mmap( NULL, a->nMap, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0 );
+    if (a->map==MAP_FAILED) {
+      printf("FATAL: ra_arena_init(): couldn't mmap() %ld bytes\n",a->nMap);
+      a->map = NULL;
+      return 1;
+      }
+    off = ( RA_ARENA_HUGE - ((unsigned long int) a->map & (RA_ARENA_HUGE-1)) ) & (RA_ARENA_HUGE-1);
+    a->base = a->map + off;
+    if (madvise( a->base, a->nMap-off, MADV_HUGEPAGE )) {
+      printf("WARNING: ra_arena_init(): madvise(MADV_HUGEPAGE) failed; is transparent huge page support disabled?\n");
+      }
+    a->eHuge = RA_HUGE_THP;
+    return 0;
+    }
+
+  if (posix_memalign( (void **) &(a->base), (a->size>=RA_ARENA_HUGE) ? RA_ARENA_HUGE : RA_ARENA_ALIGN, a->size )) {
+    printf("FATAL: ra_arena_init(): couldn't allocate %ld bytes\n",a->size);
+    a->base = NULL;
+    return 1;
+    }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_arena_touch() =========================================*/
+/*==============================================================*/
+/* writes every page, so that each is placed (first touched) now, by the calling thread */
+
+void ra_arena_touch( struct ra_arena_struct *a ) {
+  long int i;
+  for (i=0;i<a->size;i+=4096) a->base[i] = 0;
+  }
+
+/*==============================================================*/
+/*=== ra_arena_alloc() =========================================*/
+/*==============================================================*/
+/* a slice of n bytes, aligned to RA_ARENA_ALIGN; NULL (and says so) if there isn't room */
+
+void *ra_arena_alloc(
+                      struct ra_arena_struct *a,   /* [in/out] */
+                      long int n,                  /* [in] [bytes] */
+                      char *what                   /* [in] for the message, if there isn't room */
+                     ) {
+  char *p;
+  n = RA_ARENA_ROUND(n);
+  if (a->used+n > a->size) {
+    printf("FATAL: ra_arena_alloc(): no room for %s (%ld bytes; %ld of %ld used)\n",what,n,a->used,a->size);
+    return NULL;
+    }
+  p = a->base + a->used;
+  a->used += n;
+  if (a->used>a->high) a->high = a->used;
+  return p;
+  }
+
+/*==============================================================*/
+/*=== ra_arena_mark(), ra_arena_reset() ========================*/
+/*==============================================================*/
+/* "m = ra_arena_mark(a); ...ra_arena_alloc(a,...)...; ra_arena_reset(a,m);" gives back what was taken in between */
+
+long int ra_arena_mark( struct ra_arena_struct *a ) {
+  return a->used;
+  }
+
+void ra_arena_reset( struct ra_arena_struct *a, long int mark ) {
+  a->used = mark;
+  }
+
+/*==============================================================*/
+/*=== ra_arena_free() ==========================================*/
+/*==============================================================*/
+
+void ra_arena_free( struct ra_arena_struct *a ) {
+  if (a->map) munmap( a->map, a->nMap ); else free(a->base);
+  memset( a, 0, sizeof(struct ra_arena_struct) );
+  }
+
+/*==============================================================*/
+/*=== ra_cpus_parse() ==========================================*/
+/*==============================================================*/
+/* adds the CPUs in a list such as "0-7,16" to set; returns 0 if OK, 1 on error */
+
+int ra_cpus_parse( char *s, cpu_set_t *set ) {
+  long int c1, c2, c;
+  char *p = s;
+  while (*p) {
+    c1 = strtol( p, &p, 10 );
+    c2 = c1;
+    if (*p=='-') c2 = strtol( p+1, &p, 10 );
+    if ( (c1<0) || (c2<c1) || (c2>=CPU_SETSIZE) || ((*p!=',') && (*p!='\0') && (*p!='\n')) ) {
+      printf("FATAL: ra_cpus_parse(): CPU list '%s' not recognized\n",s);
+      return 1;
+      }
+    for (c=c1;c<=c2;c++) CPU_SET( c, set );
+    if (*p) p++;
+    }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_place_thread() ========================================*/
+/*==============================================================*/
+/* pins the calling thread to place->cpus, and/or the CPUs of place->node; returns 0 if OK (or nothing */
+/* to do), 1 otherwise */
+
+int ra_place_thread( struct ra_place_struct *place ) {
+  cpu_set_t set, setNode;
+  char path[64], line[4096]; /* line: a cpulist, e.g. "0-15,32-47" */
+  FILE *fp;
+  int c;
+
+  if ( !place->cpus[0] && (place->node<0) ) return 0;
+  CPU_ZERO( &set );
+  if (place->cpus[0]) {
+      if (ra_cpus_parse( place->cpus, &set )) return 1;
+    } else {
+      for (c=0;c<CPU_SETSIZE;c++) CPU_SET( c, &set );
+    }
+  if (place->node>=0) {
+    sprintf(path,"/sys/devices/system/node/node%d/cpulist",place->node);
+    CPU_ZERO( &setNode );
+    if ( !(fp = fopen(path,"r")) || !fgets(line,sizeof(line),fp) || ra_cpus_parse( line, &setNode ) ) {
+      printf("FATAL: ra_place_thread(): couldn't read '%s'; is there a NUMA node %d?\n",path,place->node);
+      if (fp) fclose(fp);
+      return 1;
+      }
+    fclose(fp);
+    CPU_AND( &set, &set, &setNode );
+    }
+  if ( (CPU_COUNT(&set)==0) || sched_setaffinity( 0, sizeof(cpu_set_t), &set ) ) {
+    printf("FATAL: ra_place_thread(): couldn't pin to CPUS '%s', NUMA_NODE %d\n",place->cpus,place->node);
+    return 1;
+    }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_work_init() ===========================================*/
+/*==============================================================*/
+/* an arena of size bytes, from which the report bodies are taken at once; the rest is for the caller. */
+/* The calling thread is placed first (if place says so), since it is the thread that will use it. */
+/* returns 0 if OK, 1 otherwise */
+
+int ra_work_init(
+                  struct ra_work_struct *w,      /* [out] */
+                  long int size,                 /* [in] [bytes] including ra_work_size() */
+                  struct ra_place_struct *place  /* [in] HUGEPAGES, CPUS, NUMA_NODE; NULL = none */
+                 ) {
+  char *sHuge[3] = { "4 KB pages", "transparent huge pages", "huge pages (MAP_HUGETLB)" };
+
+  memset( w, 0, sizeof(struct ra_work_struct) );
+  if ( place && ra_place_thread( place ) ) return 1;
+  if (ra_arena_init( &(w->arena), size, place ? place->eHuge : RA_HUGE_NONE )) return 1;
+  if ( place && (place->node>=0) ) ra_arena_touch( &(w->arena) );
+  if (place) printf("ra_work_init(): %.1f MB, %s, CPUS '%s', NUMA_NODE %d\n",(double) w->arena.size/(1024.0*1024.0),
+                    sHuge[w->arena.eHuge],place->cpus,place->node);
+  if ( ( (w->td = ra_arena_alloc( &(w->arena), sizeof(struct ra_td), "eType 1 report" )) == NULL ) ||
+       ( (w->tm = ra_arena_alloc( &(w->arena), sizeof(struct ra_tm) + RA_MAX_CH_DIV64*64*sizeof(struct MAPstruct), "eType 7 report" )) == NULL ) ||
+       ( (w->th = ra_arena_alloc( &(w->arena), sizeof(struct ra_th) + RA_MAX_CH_DIV64*64*sizeof(struct HPstruct), "eType 8 report" )) == NULL ) ) return 1;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_work_size() ===========================================*/
+/*==============================================================*/
+/* [bytes] that ra_work_init() takes for itself, and ra_analyze() takes while analyzing a window */
+
+long int ra_work_size( void ) {
+  return RA_ARENA_ROUND( sizeof(struct ra_td) ) +
+         RA_ARENA_ROUND( sizeof(struct ra_tm) + RA_MAX_CH_DIV64*64*sizeof(struct MAPstruct) ) +
+         RA_ARENA_ROUND( sizeof(struct ra_th) + RA_MAX_CH_DIV64*64*sizeof(struct HPstruct) ) +
+         RA_ARENA_ROUND( 4*256*sizeof(long int) ); /* ra_analyze_tm() */
+  }
+
+/*==============================================================*/
+/*=== ra_work_thread() =========================================*/
+/*==============================================================*/
+/* called by a thread, before it analyzes anything, to say which is its own */
+
+void ra_work_thread( struct ra_work_struct *w ) {
+  ra_work = w;
+  }
+
+/*==============================================================*/
+/*=== ra_work_free() ===========================================*/
+/*==============================================================*/
+
+void ra_work_free( struct ra_work_struct *w ) {
+  ra_arena_free( &(w->arena) );
+  w->td = NULL;
+  w->tm = NULL;
+  w->th = NULL;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_arena.c: 2026 Oct 19
+// -- placement: huge pages (HUGEPAGES), pinning (CPUS), NUMA first touch (NUMA_NODE); ra_place_thread()
+// ra_arena.c: 2026 Oct 19
+// -- initial version
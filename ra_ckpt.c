@@ -0,0 +1,320 @@
+/*===============================================================
+ra_ckpt.c: 2026 Oct 19
+checkpoints, and resuming a run from the last one (CHECKPOINT, CHECKPOINT_FILE, --resume)
+---
+With "CHECKPOINT <s>" in the job file, frsc saves its state at least every <s> seconds (wall clock) to
+CHECKPOINT_FILE (default "<OUTFILE>.ckpt"), so that a run that crashes or is preempted can be picked up
+where it left off ("$ ./frsc <jobfile> --resume") rather than started over.  A checkpoint is taken between
+blocks (or, with WORKERS, between merged ranges; see ra_par.c), and holds:
+  where     the position in INFILE of the next block's header (main()'s fpos), and nblock
+  window    fStart, the start of the window that crosses into the next block (blk0_ptr, and that much of
+            each plane of the T0 buffer; see ra_swallow.c), and, with HOP or tiles, the sliding windows
+  reports   the prototype report header, with iSeqNo; OUTFILE's length (out->offset); and what ra_output.c
+            holds that isn't in OUTFILE yet: suppression state, reports waiting to be compressed, and the
+            frame index (OUTFORMAT 1), or reports waiting to be written as a chunk (OUTFORMAT 2)
+OUTFILE is fsync()'ed before the checkpoint is written, and the checkpoint is written to "<file>.tmp",
+fsync()'ed, and rename()'d, so the checkpoint on disk is always whole, and never ahead of OUTFILE.  With
+--resume, OUTFILE is truncated to the length in the checkpoint (dropping whatever was written after it), and
+the run continues from there; the result is the same, to the bit, as a run that wasn't interrupted.  The
+job file must be the same (this is checked, as far as the prototype report header and the sizes of things go).
+If there is no checkpoint, --resume starts from the beginning.  The checkpoint is removed when frsc finishes.
+What's published (STREAM, SHM) after the checkpoint and before the crash is published again on resuming,
+with the same iSeqNo's.  LAG_BUDGET and profiling start over.
+================================================================*/
+
+#define RA_CKPT_MAGIC   0x504b4352 /* "RCKP" */
+#define RA_CKPT_VERSION 1
+
+struct ra_ckpt_struct {                   /* the start of a checkpoint file; buffers follow (see ra_ckpt_write()) */
+  int magic;                              /* RA_CKPT_MAGIC */
+  int version;                            /* RA_CKPT_VERSION */
+  struct ra_header_struct header0;        /* prototype report header; iSeqNo of the last report */
+  long int nT0;                           /* samples per channel in the T0 buffer (window, hop, or tile) */
+  long int nCh;                           /* analyzed channels */
+  long int nWin;                          /* hops or tiles per T0; 0 if neither */
+  int eOutFormat;                         /* OUTFORMAT */
+  int nColChunk;                          /* COL_CHUNK */
+  int nWorkers;                           /* WORKERS; 0 = sequential */
+  long int nRange;                        /* WORKERS: samples per channel per range (ra_par.c) */
+  long int nMerged;                       /* WORKERS: ranges merged */
+  long int fpos;                          /* sequential: main()'s fpos (where the next block's header begins), */
+                                          /* nblock, blk0_ptr, and fstart0 */
+  long int nblock;
+  long int blk0_ptr;
+  double fstart0;
+  long int nHave;                         /* sliding windows (ra_slide.c), if any */
+  long int iNext;
+  long int offset;                        /* [bytes] of OUTFILE */
+  long int nBytesIn;
+  struct ra_supp_struct supp;             /* suppression (ref follows, if bOn) */
+  long int nPlain;                        /* OUTFORMAT 1: reports waiting to be compressed, and frames written */
+  int nReports;
+  long int nFrames;
+  int bColStarted;                        /* OUTFORMAT 2: file header written?  and reports waiting */
+  int nColRec;
+  struct ra_col_file_struct colFile;
+  };
+
+/*==============================================================*/
+/*=== ra_ckpt_due() ============================================*/
+/*==============================================================*/
+/* 1 if it's time for a checkpoint (and then the next is due period seconds from now), 0 if not */
+
+int ra_ckpt_due(
+                 double period,    /* [in] [s] CHECKPOINT; 0 = never */
+                 long int *tNext   /* [in/out] [ns] ra_prof_now() when the next is due; 0 = now */
+                ) {
+  long int t;
+  if (period<=0) return 0;
+  t = ra_prof_now();
+  if (t<*tNext) return 0;
+  *tNext = t + (long int) (period*1e+9);
+  return 1;
+  }
+
+/*==============================================================*/
+/*=== ra_ckpt_init() ===========================================*/
+/*==============================================================*/
+/* starts a checkpoint with what identifies the job; the caller fills in where it is */
+
+void ra_ckpt_init(
+                   struct ra_ckpt_struct *c,          /* [out] */
+                   struct ra_header_struct *header0,  /* [in] */
+                   long int nT0,                      /* [in] */
+                   long int nCh,                      /* [in] */
+                   long int nWin,                     /* [in] */
+                   struct ra_out_struct *out,         /* [in] OUTFORMAT, COL_CHUNK */
+                   int nWorkers                       /* [in] WORKERS; 0 = sequential */
+                  ) {
+  memset( c, 0, sizeof(struct ra_ckpt_struct) );
+  memcpy( &(c->header0), header0, sizeof(struct ra_header_struct) );
+  c->nT0        = nT0;
+  c->nCh        = nCh;
+  c->nWin       = nWin;
+  c->eOutFormat = out->eFormat;
+  c->nColChunk  = out->nColChunk;
+  c->nWorkers   = nWorkers;
+  }
+
+/*==============================================================*/
+/*=== ra_ckpt_io() =============================================*/
+/*==============================================================*/
+/* reads (bWrite=0) or writes n bytes; returns 0 if OK, 1 otherwise */
+
+int ra_ckpt_io( FILE *fp, void *p, long int n, int bWrite ) {
+  if (n<=0) return 0;
+  if (bWrite) return (fwrite( p, n, 1, fp )!=1);
+  return (fread( p, n, 1, fp )!=1);
+  }
+
+/*==============================================================*/
+/*=== ra_ckpt_buffers() ========================================*/
+/*==============================================================*/
+/* reads or writes what follows struct ra_ckpt_struct, per c; returns 0 if OK, 1 otherwise */
+
+int ra_ckpt_buffers(
+                     FILE *fp,
+                     struct ra_ckpt_struct *c,     /* [in] */
+                     struct ra_out_struct *out,    /* [in/out] */
+                     struct ra_plan_struct *plan,  /* [in] offBlk0[]; NULL with WORKERS */
+                     signed char *blk0,            /* [in/out] T0 buffer; NULL with WORKERS */
+                     struct ra_slide_struct *slide, /* [in/out] NULL if none */
+                     int bWrite                    /* [in] 1: write, 0: read */
+                    ) {
+  long int nSaved = c->blk0_ptr/RG_NPOL;
+  long int nMax = out->col.file.nChunkMax;
+  long int k;
+  int p, eStatus = 0;
+
+  /* the planes of the T0 buffer, as far as they're filled */
+  if (blk0) for (k=0;k<c->nCh;k++) for (p=0;p<RG_NPOL;p++) {
+    eStatus |= ra_ckpt_io( fp, &(blk0[ plan->offBlk0[k] + p*c->nT0 ]), nSaved, bWrite );
+    }
+  if (slide) {
+    if (!slide->bTumble) eStatus |= ra_ckpt_io( fp, slide->ring, slide->nWin*slide->nCh*sizeof(struct MAPstruct), bWrite );
+    eStatus |= ra_ckpt_io( fp, slide->sum,    slide->nCh*sizeof(struct MAPstruct), bWrite );
+    eStatus |= ra_ckpt_io( fp, slide->fStart, (slide->bTumble ? 1 : slide->nWin)*sizeof(double), bWrite );
+    }
+  if (c->supp.bOn) eStatus |= ra_ckpt_io( fp, out->supp.ref, sizeof(struct ra_td), bWrite );
+  if (c->eOutFormat==RA_OUTFORMAT_FRAMED) {
+    eStatus |= ra_ckpt_io( fp, out->plain, c->nPlain, bWrite );
+    eStatus |= ra_ckpt_io( fp, out->index, c->nFrames*sizeof(struct ra_frame_index_struct), bWrite );
+    }
+  if ( (c->eOutFormat==RA_OUTFORMAT_COLUMNS) && c->bColStarted ) {
+    eStatus |= ra_ckpt_io( fp, out->col.base, RA_COL_NBASE*nMax*sizeof(long int), bWrite );
+    eStatus |= ra_ckpt_io( fp, out->col.val,  out->col.file.nChStored*RA_COL_NPERCH*nMax*sizeof(float), bWrite );
+    }
+  return eStatus;
+  }
+
+/*==============================================================*/
+/*=== ra_ckpt_write() ==========================================*/
+/*==============================================================*/
+/* c is from ra_ckpt_init(), with the caller's place (fpos through fstart0, or nRange and nMerged) filled in; the */
+/* rest is filled in here.  returns 0 if OK, 1 otherwise */
+
+int ra_ckpt_write(
+                   char *file,                   /* [in] CHECKPOINT_FILE */
+                   struct ra_ckpt_struct *c,     /* [in/out] */
+                   struct ra_out_struct *out,    /* [in] */
+                   struct ra_plan_struct *plan,  /* [in] NULL with WORKERS */
+                   signed char *blk0,            /* [in] NULL with WORKERS */
+                   struct ra_slide_struct *slide /* [in] NULL if none */
+                  ) {
+  char tmp[RA_MAX_FILENAME_LENGTH+8];
+  long int t = ra_prof_now();
+  FILE *fp;
+  int eStatus;
+
+  c->magic    = RA_CKPT_MAGIC;
+  c->version  = RA_CKPT_VERSION;
+  c->nHave    = slide ? slide->nHave : 0;
+  c->iNext    = slide ? slide->iNext : 0;
+  c->offset   = out->offset;
+  c->nBytesIn = out->nBytesIn;
+  memcpy( &(c->supp), &(out->supp), sizeof(struct ra_supp_struct) );
+  c->nPlain   = out->nPlain;
+  c->nReports = out->nReports;
+  c->nFrames  = out->nFrames;
+  c->bColStarted = out->col.bStarted;
+  c->nColRec  = out->col.nRec;
+  memcpy( &(c->colFile), &(out->col.file), sizeof(struct ra_col_file_struct) );
+
+  /* OUTFILE first, so the checkpoint is never ahead of it */
+  fflush( out->fp );
+  fsync( fileno(out->fp) );
+
+  sprintf(tmp,"%s.tmp",file);
+  if (!(fp = fopen(tmp,"wb"))) {
+    printf("WARNING: ra_ckpt_write(): couldn't write '%s'\n",tmp);
+    return 1;
+    }
+  eStatus = ra_ckpt_io( fp, c, sizeof(struct ra_ckpt_struct), 1 ) || ra_ckpt_buffers( fp, c, out, plan, blk0, slide, 1 );
+  eStatus |= fflush(fp) || fsync( fileno(fp) );
+  fclose(fp);
+  if ( eStatus || rename(tmp,file) ) {
+    printf("WARNING: ra_ckpt_write(): couldn't write '%s'\n",file);
+    return 1;
+    }
+  printf("ra_ckpt_write(): iSeqNo %ld, fStart %lf s, OUTFILE %ld bytes (%.3f s)\n",c->header0.iSeqNo,c->fstart0,c->offset,(ra_prof_now()-t)*1e-9);
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_ckpt_read() ===========================================*/
+/*==============================================================*/
+/* reads the struct at the start of a checkpoint; returns 0 if OK, 1 otherwise */
+
+int ra_ckpt_read(
+                  char *file,                /* [in] CHECKPOINT_FILE */
+                  struct ra_ckpt_struct *c   /* [out] */
+                 ) {
+  FILE *fp;
+  int eStatus;
+
+  if (!(fp = fopen(file,"rb"))) {
+    printf("FATAL: ra_ckpt_read(): couldn't open '%s'\n",file);
+    return 1;
+    }
+  eStatus = ra_ckpt_io( fp, c, sizeof(struct ra_ckpt_struct), 0 );
+  fclose(fp);
+  if ( eStatus || (c->magic!=RA_CKPT_MAGIC) || (c->version!=RA_CKPT_VERSION) ) {
+    printf("FATAL: ra_ckpt_read(): '%s' isn't a checkpoint (of this version of frsc)\n",file);
+    return 1;
+    }
+  printf("ra_ckpt_read(): resuming after iSeqNo %ld, fStart %lf s, OUTFILE %ld bytes\n",c->header0.iSeqNo,c->fstart0,c->offset);
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_ckpt_restore() ========================================*/
+/*==============================================================*/
+/* checks that the checkpoint read by ra_ckpt_read() fits this run, and puts back what ra_ckpt_write() saved */
+/* into out, blk0, slide, and header0->iSeqNo.  Call once OUTFILE is open (ra_out_open() with c->offset), and */
+/* the T0 buffer and sliding windows are allocated.  returns 0 if OK, 1 otherwise */
+
+int ra_ckpt_restore(
+                     char *file,                        /* [in] CHECKPOINT_FILE */
+                     struct ra_ckpt_struct *c,          /* [in] */
+                     struct ra_header_struct *header0,  /* [in/out] */
+                     long int nT0,                      /* [in] */
+                     long int nCh,                      /* [in] */
+                     long int nWin,                     /* [in] */
+                     int eOutFormat,                    /* [in] */
+                     int nColChunk,                     /* [in] */
+                     int nWorkers,                      /* [in] WORKERS; 0 = sequential */
+                     struct ra_out_struct *out,         /* [in/out] */
+                     struct ra_plan_struct *plan,       /* [in] NULL with WORKERS */
+                     signed char *blk0,                 /* [out] NULL with WORKERS */
+                     struct ra_slide_struct *slide      /* [out] NULL if none */
+                    ) {
+  struct ra_ckpt_struct c1;
+  struct ra_header_struct h;
+  struct ra_td *ref = out->supp.ref;
+  FILE *fp;
+  long int n;
+  int eStatus;
+
+  memcpy( &h, header0, sizeof(struct ra_header_struct) );
+  h.iSeqNo = c->header0.iSeqNo;
+  if ( memcmp( &h, &(c->header0), sizeof(struct ra_header_struct) ) ||
+       (c->nT0!=nT0) || (c->nCh!=nCh) || (c->nWin!=nWin) || (c->eOutFormat!=eOutFormat) || (c->nColChunk!=nColChunk) ||
+       (c->nWorkers!=nWorkers) || (c->supp.bOn!=out->supp.bOn) || ( (nWorkers<=1) && ((slide!=NULL)!=(nWin>1)) ) ) {
+    printf("FATAL: ra_ckpt_restore(): '%s' isn't from this job (or the job file has changed)\n",file);
+    return 1;
+    }
+
+  /* what ra_output.c had */
+  out->offset   = c->offset;
+  out->nBytesIn = c->nBytesIn;
+  memcpy( &(out->supp), &(c->supp), sizeof(struct ra_supp_struct) );
+  out->supp.ref = ref;
+  if (eOutFormat==RA_OUTFORMAT_FRAMED) {
+    out->nPlain   = c->nPlain;
+    out->nReports = c->nReports;
+    out->nFrames  = c->nFrames;
+    if (out->nFrames>out->nFramesMax) {
+      out->nFramesMax = 2*out->nFrames;
+      if ( (out->index = realloc( out->index, out->nFramesMax*sizeof(struct ra_frame_index_struct) ))==NULL ) {
+        printf("FATAL: ra_ckpt_restore(): realloc() of frame index failed\n");
+        return 1;
+        }
+      }
+    }
+  if ( (eOutFormat==RA_OUTFORMAT_COLUMNS) && c->bColStarted ) {
+    memcpy( &(out->col.file), &(c->colFile), sizeof(struct ra_col_file_struct) );
+    n = out->col.file.nChunkMax;
+    out->col.base = malloc( RA_COL_NBASE * n * sizeof(long int) );
+    out->col.val  = malloc( out->col.file.nChStored * RA_COL_NPERCH * n * sizeof(float) );
+    if ( (out->col.base==NULL) || (out->col.val==NULL) ) {
+      printf("FATAL: ra_ckpt_restore(): malloc() of chunk buffer failed\n");
+      return 1;
+      }
+    out->col.bStarted = 1;
+    out->col.nRec = c->nColRec;
+    }
+  if (slide) {
+    slide->nHave = c->nHave;
+    slide->iNext = c->iNext;
+    }
+  header0->iSeqNo = c->header0.iSeqNo;
+
+  /* and the buffers */
+  if (!(fp = fopen(file,"rb"))) {
+    printf("FATAL: ra_ckpt_restore(): couldn't open '%s'\n",file);
+    return 1;
+    }
+  eStatus = ra_ckpt_io( fp, &c1, sizeof(struct ra_ckpt_struct), 0 ) || ra_ckpt_buffers( fp, c, out, plan, blk0, slide, 0 );
+  fclose(fp);
+  if (eStatus) {
+    printf("FATAL: ra_ckpt_restore(): '%s' is short\n",file);
+    return 1;
+    }
+  return 0;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_ckpt.c: 2026 Oct 19
+// -- initial version
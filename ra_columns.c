@@ -0,0 +1,167 @@
+/*===============================================================
+ra_columns.c: 2026 Oct 19
+columnar statistics store (OUTFORMAT 2); see ra_format.c
+---
+Used by ra_output.c (writing) and frsc_read.c (reading).  Reports are collected in memory
+until nChunkMax of them have been seen, then appended to the file as one chunk.
+================================================================*/
+
+#define RA_COL_CHUNK_DEFAULT 4096 /* default number of reports per chunk */
+
+/* state for writing a columnar store */
+struct ra_col_struct {
+  struct ra_col_file_struct file; /* file header; valid once bStarted */
+  int bStarted;                   /* has the file header been written? */
+  int nRec;                       /* number of reports waiting in buf */
+  long int *base;                 /* [RA_COL_NBASE][nChunkMax] */
+  float *val;                     /* [nChStored*RA_COL_NPERCH][nChunkMax] */
+  };
+
+/*==============================================================*/
+/*=== ra_col_base_offset() =====================================*/
+/*==============================================================*/
+/* [bytes] position of base column b (0..RA_COL_NBASE-1) within the columns of a chunk holding nRec reports */
+
+long int ra_col_base_offset( int nRec, int b ) {
+  return ((long int) b) * 8 * nRec;
+  }
+
+/*==============================================================*/
+/*=== ra_col_ch_offset() =======================================*/
+/*==============================================================*/
+/* [bytes] position of column j (0..RA_COL_NPERCH-1) of the k'th stored channel (0-based) within a chunk holding nRec reports */
+/* j = 5*(member of struct DAPstruct, 0=xi .. 7=v) + (member of struct DAstruct, 0=mean .. 4=k) */
+
+long int ra_col_ch_offset( int nRec, long int k, int j ) {
+  return ((long int) RA_COL_NBASE) * 8 * nRec + ( k*RA_COL_NPERCH + j ) * 4 * ((long int) nRec);
+  }
+
+/*==============================================================*/
+/*=== ra_col_chunk_bytes() =====================================*/
+/*==============================================================*/
+/* [bytes] of columns in a chunk */
+
+long int ra_col_chunk_bytes( int nRec, long int nChStored ) {
+  return ra_col_ch_offset( nRec, nChStored, 0 );
+  }
+
+/*==============================================================*/
+/*=== ra_col_start() ===========================================*/
+/*==============================================================*/
+/* writes the file header, using the eType=0 report header to decide which channels are stored.  returns 0 if OK, 1 otherwise */
+
+int ra_col_start(
+                  struct ra_col_struct *col,       /* [out] */
+                  struct ra_header_struct *header, /* [in] the eType=0 report header */
+                  int nChunkMax,                   /* [in] reports per chunk */
+                  FILE *fp                         /* [in] output file */
+                  ) {
+
+  long int l;
+
+  memset(col,0,sizeof(struct ra_col_struct));
+  col->file.magic = RA_COL_MAGIC;
+  col->file.nChunkMax = nChunkMax;
+  for (l=1;l<=header->nCh;l++) { /* note..starting from 1 here! */
+    if (!ra_isChBitSet(header->bChIn,l)) { /* if channel bit is not set, this channel gets analyzed */
+      col->file.iCh[col->file.nChStored] = l;
+      col->file.nChStored++;
+      }
+    }
+  memcpy( &(col->file.header), header, sizeof(struct ra_header_struct) );
+
+  col->base = malloc( RA_COL_NBASE * nChunkMax * sizeof(long int) );
+  col->val  = malloc( col->file.nChStored * RA_COL_NPERCH * nChunkMax * sizeof(float) );
+  if ( (col->base==NULL) || (col->val==NULL) ) {
+    printf("FATAL: ra_col_start(): malloc() of chunk buffer failed\n");
+    return 1;
+    }
+
+  fwrite( &(col->file), sizeof(struct ra_col_file_struct), 1, fp );
+  col->bStarted = 1;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_col_flush() ===========================================*/
+/*==============================================================*/
+/* appends reports waiting in memory to the file as a chunk.  returns [bytes] written */
+
+long int ra_col_flush( struct ra_col_struct *col, FILE *fp ) {
+
+  struct ra_col_chunk_struct chunk;
+  long int j;
+
+  if (col->nRec==0) return 0;
+
+  chunk.magic  = RA_COL_CHUNK_MAGIC;
+  chunk.nRec   = col->nRec;
+  chunk.nBytes = ra_col_chunk_bytes( col->nRec, col->file.nChStored );
+  chunk.iSeqNo = col->base[0];
+  memcpy( &(chunk.fStart), &(col->base[col->file.nChunkMax]), sizeof(double) );
+
+  fwrite( &chunk, sizeof(struct ra_col_chunk_struct), 1, fp );
+  for (j=0;j<RA_COL_NBASE;j++) {
+    fwrite( &(col->base[j*col->file.nChunkMax]), sizeof(long int), col->nRec, fp );
+    }
+  for (j=0;j<col->file.nChStored*RA_COL_NPERCH;j++) {
+    fwrite( &(col->val[j*col->file.nChunkMax]), sizeof(float), col->nRec, fp );
+    }
+  fflush(fp);
+
+  col->nRec = 0;
+  return sizeof(struct ra_col_chunk_struct) + chunk.nBytes;
+  }
+
+/*==============================================================*/
+/*=== ra_col_add() =============================================*/
+/*==============================================================*/
+/* adds an eType=1,2 report; appends a chunk if this fills one.  returns [bytes] written to fp */
+
+long int ra_col_add(
+                     struct ra_col_struct *col,       /* [in/out] */
+                     struct ra_header_struct *header, /* [in] report header */
+                     struct ra_td *td,                /* [in] report body */
+                     FILE *fp                         /* [in] output file */
+                     ) {
+
+  long int k;
+  int j;
+  int n = col->nRec;
+  int nMax = col->file.nChunkMax;
+  float *f;
+
+  col->base[0*nMax+n] = header->iSeqNo;
+  memcpy( &(col->base[1*nMax+n]), &(header->fStart), sizeof(double) );
+  col->base[2*nMax+n] = header->eType;
+  col->base[3*nMax+n] = header->err;
+  col->base[4*nMax+n] = td->clips.x;
+  col->base[5*nMax+n] = td->clips.y;
+
+  for (k=0;k<col->file.nChStored;k++) {
+    f = (float *) &(td->tdac[ col->file.iCh[k]-1 ]); /* struct DAPstruct is RA_COL_NPERCH consecutive floats */
+    for (j=0;j<RA_COL_NPERCH;j++) {
+      col->val[ (k*RA_COL_NPERCH+j)*nMax + n ] = f[j];
+      }
+    }
+
+  col->nRec++;
+  if (col->nRec>=nMax) { return ra_col_flush(col,fp); }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_col_free() ============================================*/
+/*==============================================================*/
+
+void ra_col_free( struct ra_col_struct *col ) {
+  free(col->base); col->base = NULL;
+  free(col->val);  col->val  = NULL;
+  col->bStarted = 0;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_columns.c: 2026 Oct 19
+// -- initial version
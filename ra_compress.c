@@ -0,0 +1,380 @@
+/*===============================================================
+ra_compress.c: 2026 Oct 19
+compression of the report stream (OUTFORMAT 1)
+---
+A compressed report stream is a sequence of independently decodable "frames" (struct ra_frame_struct,
+see ra_format.c), optionally followed by a frame index.  Each frame holds up to RA_FRAME_MAX_REPORTS
+consecutive reports.  Before compression the reports of a frame are transformed so that the redundancy
+between successive reports is exposed to the compressor:
+  -- headers are delta-encoded: each header is XOR'd with the previous header in the frame, so that only
+     the bytes that change (typically iSeqNo and fStart) are non-zero
+  -- each body is XOR'd with the previous body of the same eType in the frame, and then byte-shuffled
+     (all first bytes of each 4-byte field, then all second bytes, etc.).  Since the statistics vary
+     slowly, sign/exponent bytes become long runs of zeros.
+The transformed frame is then compressed with ra_lz_compress(), a small LZ77-class codec bundled here
+so that frsc continues to need nothing beyond standard C libraries.
+Decoding reverses these steps and yields exactly the bytes that would have been written in OUTFORMAT 0.
+================================================================*/
+
+#define RA_LZ_HASH_LOG   16 /* log2 of number of entries in compressor hash table */
+#define RA_LZ_MIN_MATCH   4 /* shortest match encoded */
+#define RA_LZ_MAX_OFFSET 65535
+#define RA_LZ_LAST_LITERALS 8 /* last bytes of input are always coded as literals */
+
+/*==============================================================*/
+/*=== ra_body_size() ===========================================*/
+/*==============================================================*/
+/* Returns the number of bytes in the "new information" section which follows the given header, */
+/* or -1 if eType is not one that can be written to a file */
+
+long int ra_body_size( struct ra_header_struct *h ) {
+  switch (h->eType) {
+    case RA_H_ETYPE_NULL: return 0;
+    case RA_H_ETYPE_TF0:
+    case RA_H_ETYPE_TF1:  return sizeof(struct ra_td);
+    case RA_H_ETYPE_TM0:  return sizeof(struct ra_tm) + ra_tm_nch(h)*sizeof(struct MAPstruct);
+    case RA_H_ETYPE_TH0:  return sizeof(struct ra_th) + ra_tm_nch(h)*sizeof(struct HPstruct);
+    default:              return -1;
+    }
+  }
+
+/*==============================================================*/
+/*=== ra_lz_bound() ============================================*/
+/*==============================================================*/
+/* worst-case size of ra_lz_compress() output for n bytes of input */
+
+long int ra_lz_bound( long int n ) {
+  return n + n/255 + 16;
+  }
+
+/*==============================================================*/
+/*=== ra_lz_read32() ===========================================*/
+/*==============================================================*/
+
+static unsigned int ra_lz_read32( unsigned char *p ) {
+  unsigned int u;
+  memcpy(&u,p,4);
+  return u;
+  }
+
+/*==============================================================*/
+/*=== ra_lz_hash() =============================================*/
+/*==============================================================*/
+
+static unsigned int ra_lz_hash( unsigned int u ) {
+  return (u * 2654435761U) >> (32-RA_LZ_HASH_LOG);
+  }
+
+/*==============================================================*/
+/*=== ra_lz_putlen() ===========================================*/
+/*==============================================================*/
+/* writes the part of a length that didn't fit into a token nibble, as a run of 255's */
+
+static unsigned char *ra_lz_putlen( unsigned char *op, long int len ) {
+  while (len>=255) { *op++ = 255; len -= 255; }
+  *op++ = (unsigned char) len;
+  return op;
+  }
+
+/*==============================================================*/
+/*=== ra_lz_compress() =========================================*/
+/*==============================================================*/
+/* LZ77-class compressor.  Output is a sequence of "sequences", each of which is: */
+/*   token:    1 byte; high nibble = literal length, low nibble = match length - RA_LZ_MIN_MATCH (15 means "more follows") */
+/*   [literal length continuation bytes], literals, */
+/*   offset:   2 bytes, little-endian, 1..RA_LZ_MAX_OFFSET */
+/*   [match length continuation bytes] */
+/* The final sequence has literals only (no offset). */
+/* Returns number of bytes written to dst, which must have room for ra_lz_bound(n) bytes */
+
+long int ra_lz_compress(
+                         unsigned char *src, /* [in] data to be compressed */
+                         long int n,         /* [in] number of bytes in src */
+                         unsigned char *dst  /* [out] compressed data */
+                         ) {
+
+  static int table[1<<RA_LZ_HASH_LOG]; /* most recent position at which each hash was seen */
+  unsigned char *ip = src;
+  unsigned char *anchor = src;         /* start of pending literals */
+  unsigned char *iend = src + n;
+  unsigned char *ilimit = src + n - RA_LZ_LAST_LITERALS;
+  unsigned char *op = dst;
+  unsigned char *ref;
+  unsigned char *token;
+  unsigned int h;
+  long int nLit;
+  long int nMatch;
+  long int step;
+
+  for (h=0;h<(1<<RA_LZ_HASH_LOG);h++) { table[h] = -1; }
+
+  while ( (n>RA_LZ_LAST_LITERALS+RA_LZ_MIN_MATCH) && (ip<ilimit) ) {
+
+    /* look for a match */
+    h = ra_lz_hash(ra_lz_read32(ip));
+    ref = (table[h]<0) ? NULL : src + table[h];
+    table[h] = ip - src;
+    if ( (ref==NULL) || (ip-ref>RA_LZ_MAX_OFFSET) || (ra_lz_read32(ref)!=ra_lz_read32(ip)) ) {
+      step = 1 + ((ip-anchor)>>6); /* skip faster through incompressible data */
+      ip += step;
+      continue;
+      }
+
+    /* extend the match forward */
+    nMatch = RA_LZ_MIN_MATCH;
+    while ( (ip+nMatch<ilimit) && (ip[nMatch]==ref[nMatch]) ) { nMatch++; }
+
+    /* emit sequence */
+    nLit = ip - anchor;
+    token = op++;
+    *token = ( (nLit>=15) ? 15 : nLit ) << 4;
+    if (nLit>=15) { op = ra_lz_putlen(op,nLit-15); }
+    memcpy(op,anchor,nLit); op += nLit;
+    *op++ = (ip-ref) & 0xFF;
+    *op++ = (ip-ref) >> 8;
+    if (nMatch-RA_LZ_MIN_MATCH>=15) {
+        *token |= 15;
+        op = ra_lz_putlen(op,nMatch-RA_LZ_MIN_MATCH-15);
+      } else {
+        *token |= nMatch-RA_LZ_MIN_MATCH;
+      }
+
+    ip += nMatch;
+    anchor = ip;
+    }
+
+  /* last literals */
+  nLit = iend - anchor;
+  token = op++;
+  *token = ( (nLit>=15) ? 15 : nLit ) << 4;
+  if (nLit>=15) { op = ra_lz_putlen(op,nLit-15); }
+  memcpy(op,anchor,nLit); op += nLit;
+
+  return op - dst;
+  }
+
+/*==============================================================*/
+/*=== ra_lz_decompress() =======================================*/
+/*==============================================================*/
+/* Inverse of ra_lz_compress().  Returns number of bytes written to dst, or -1 if src is corrupt or dst is too small */
+
+long int ra_lz_decompress(
+                           unsigned char *src, /* [in] compressed data */
+                           long int n,         /* [in] number of bytes in src */
+                           unsigned char *dst, /* [out] decompressed data */
+                           long int nMax       /* [in] capacity of dst in bytes */
+                           ) {
+
+  unsigned char *ip = src;
+  unsigned char *iend = src + n;
+  unsigned char *op = dst;
+  unsigned char *oend = dst + nMax;
+  unsigned char *ref;
+  unsigned char token;
+  long int len;
+  long int offset;
+
+  while (ip<iend) {
+
+    token = *ip++;
+
+    /* literals */
+    len = token >> 4;
+    if (len==15) {
+      do { if (ip>=iend) return -1; len += *ip; } while (*ip++==255);
+      }
+    if ( (len>iend-ip) || (len>oend-op) ) return -1;
+    memcpy(op,ip,len); op += len; ip += len;
+    if (ip>=iend) break; /* last sequence has no match */
+
+    /* match */
+    if (iend-ip<2) return -1;
+    offset = ip[0] | (ip[1]<<8); ip += 2;
+    if ( (offset==0) || (offset>op-dst) ) return -1;
+    len = token & 15;
+    if (len==15) {
+      do { if (ip>=iend) return -1; len += *ip; } while (*ip++==255);
+      }
+    len += RA_LZ_MIN_MATCH;
+    if (len>oend-op) return -1;
+    ref = op - offset;
+    if (offset>=len) {
+        memcpy(op,ref,len); op += len;
+      } else {
+        while (len-->0) { *op++ = *ref++; } /* overlapping copy (runs) */
+      }
+    }
+
+  return op - dst;
+  }
+
+/*==============================================================*/
+/*=== ra_shuffle() =============================================*/
+/*==============================================================*/
+/* byte-shuffle with 4-byte element size: dst = all byte 0's, then all byte 1's, etc. */
+/* any trailing bytes (n not a multiple of 4) are copied unchanged */
+
+void ra_shuffle( unsigned char *src, unsigned char *dst, long int n ) {
+  long int ne = n/4;
+  long int i;
+  int b;
+  for (b=0;b<4;b++) {
+    for (i=0;i<ne;i++) { dst[b*ne+i] = src[4*i+b]; }
+    }
+  memcpy(&(dst[4*ne]),&(src[4*ne]),n-4*ne);
+  }
+
+/*==============================================================*/
+/*=== ra_unshuffle() ===========================================*/
+/*==============================================================*/
+/* inverse of ra_shuffle() */
+
+void ra_unshuffle( unsigned char *src, unsigned char *dst, long int n ) {
+  long int ne = n/4;
+  long int i;
+  int b;
+  for (b=0;b<4;b++) {
+    for (i=0;i<ne;i++) { dst[4*i+b] = src[b*ne+i]; }
+    }
+  memcpy(&(dst[4*ne]),&(src[4*ne]),n-4*ne);
+  }
+
+/*==============================================================*/
+/*=== ra_xor() =================================================*/
+/*==============================================================*/
+/* dst[i] ^= ref[i] */
+
+void ra_xor( unsigned char *dst, unsigned char *ref, long int n ) {
+  long int i;
+  for (i=0;i<n;i++) { dst[i] ^= ref[i]; }
+  }
+
+/*==============================================================*/
+/*=== ra_frame_encode() ========================================*/
+/*==============================================================*/
+/* Transforms and compresses nReports consecutive reports, presented as they would appear in an OUTFORMAT 0 stream. */
+/* Transformed layout: all (delta-encoded) headers, followed by all (delta-encoded, shuffled) bodies. */
+/* Returns number of compressed bytes written to dst (which must have room for ra_lz_bound(nPlain) bytes), or -1 on error */
+
+long int ra_frame_encode(
+                          unsigned char *plain, /* [in] reports, OUTFORMAT 0 layout */
+                          long int nPlain,      /* [in] number of bytes in plain */
+                          int nReports,         /* [in] number of reports in plain */
+                          unsigned char *raw,   /* [scratch] nPlain bytes */
+                          unsigned char *dst    /* [out] compressed frame payload */
+                          ) {
+
+  struct ra_header_struct *h;
+  long int lastBody[RA_FRAME_MAX_ETYPE]; /* offset within plain of last body of each eType; -1 if none yet */
+  long int lastSize[RA_FRAME_MAX_ETYPE]; /* and its length, since for some eTypes this depends on the header */
+  long int pos = 0;        /* position within plain */
+  long int posb;           /* position within raw at which bodies go */
+  long int nBody;
+  int i;
+
+  for (i=0;i<RA_FRAME_MAX_ETYPE;i++) { lastBody[i] = -1; }
+  posb = nReports*sizeof(struct ra_header_struct);
+
+  for (i=0;i<nReports;i++) {
+
+    /* header: copied here, delta-encoded below */
+    h = (struct ra_header_struct *) &(plain[pos]);
+    memcpy( &(raw[i*sizeof(struct ra_header_struct)]), h, sizeof(struct ra_header_struct) );
+    pos += sizeof(struct ra_header_struct);
+
+    /* body: XOR with previous body of same eType, then shuffle */
+    nBody = ra_body_size(h);
+    if ( (nBody<0) || (h->eType>=RA_FRAME_MAX_ETYPE) || (pos+nBody>nPlain) ) {
+      printf("ERROR: ra_frame_encode(): can't encode report with eType=%d\n",h->eType);
+      return -1;
+      }
+    if (nBody>0) {
+      if ( (lastBody[h->eType]>=0) && (lastSize[h->eType]==nBody) ) {
+          memcpy( &(raw[posb]), &(plain[pos]), nBody );
+          ra_xor( &(raw[posb]), &(plain[lastBody[h->eType]]), nBody );
+          ra_shuffle( &(raw[posb]), dst, nBody );  /* use dst as scratch */
+          memcpy( &(raw[posb]), dst, nBody );
+        } else {
+          ra_shuffle( &(plain[pos]), &(raw[posb]), nBody );
+        }
+      lastBody[h->eType] = pos;
+      lastSize[h->eType] = nBody;
+      posb += nBody;
+      pos  += nBody;
+      }
+
+    } /* for i */
+
+  /* header deltas are done last, from the back, so each is taken relative to the untransformed previous header */
+  for (i=nReports-1;i>0;i--) {
+    ra_xor( &(raw[i*sizeof(struct ra_header_struct)]), &(raw[(i-1)*sizeof(struct ra_header_struct)]), sizeof(struct ra_header_struct) );
+    }
+
+  return ra_lz_compress( raw, nPlain, dst );
+  }
+
+/*==============================================================*/
+/*=== ra_frame_decode() ========================================*/
+/*==============================================================*/
+/* Inverse of ra_frame_encode(). */
+/* Returns number of bytes written to plain (OUTFORMAT 0 layout), or -1 if the frame is corrupt */
+
+long int ra_frame_decode(
+                          unsigned char *src,   /* [in] compressed frame payload */
+                          long int nComp,       /* [in] number of bytes in src */
+                          long int nRaw,        /* [in] number of bytes after decompression */
+                          int nReports,         /* [in] number of reports in frame */
+                          unsigned char *raw,   /* [scratch] nRaw bytes */
+                          unsigned char *plain  /* [out] reports, OUTFORMAT 0 layout; room for nRaw bytes */
+                          ) {
+
+  struct ra_header_struct *h;
+  long int lastBody[RA_FRAME_MAX_ETYPE]; /* offset within plain of last body of each eType; -1 if none yet */
+  long int lastSize[RA_FRAME_MAX_ETYPE]; /* and its length, since for some eTypes this depends on the header */
+  long int pos = 0;        /* position within plain */
+  long int posb;           /* position within raw of next body */
+  long int nBody;
+  int i;
+
+  if (ra_lz_decompress( src, nComp, raw, nRaw ) != nRaw) { return -1; }
+  if (nReports*sizeof(struct ra_header_struct) > nRaw) { return -1; }
+
+  /* undo header deltas, front to back */
+  for (i=1;i<nReports;i++) {
+    ra_xor( &(raw[i*sizeof(struct ra_header_struct)]), &(raw[(i-1)*sizeof(struct ra_header_struct)]), sizeof(struct ra_header_struct) );
+    }
+
+  for (i=0;i<RA_FRAME_MAX_ETYPE;i++) { lastBody[i] = -1; }
+  posb = nReports*sizeof(struct ra_header_struct);
+
+  for (i=0;i<nReports;i++) {
+
+    memcpy( &(plain[pos]), &(raw[i*sizeof(struct ra_header_struct)]), sizeof(struct ra_header_struct) );
+    h = (struct ra_header_struct *) &(plain[pos]);
+    pos += sizeof(struct ra_header_struct);
+
+    nBody = ra_body_size(h);
+    if ( (nBody<0) || (h->eType>=RA_FRAME_MAX_ETYPE) || (posb+nBody>nRaw) ) { return -1; }
+    if (nBody>0) {
+      ra_unshuffle( &(raw[posb]), &(plain[pos]), nBody );
+      if ( (lastBody[h->eType]>=0) && (lastSize[h->eType]==nBody) ) { ra_xor( &(plain[pos]), &(plain[lastBody[h->eType]]), nBody ); }
+      lastBody[h->eType] = pos;
+      lastSize[h->eType] = nBody;
+      posb += nBody;
+      pos  += nBody;
+      }
+
+    } /* for i */
+
+  return pos;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_compress.c: 2026 Oct 19
+// -- eType 8 (ADC health)
+// ra_compress.c: 2026 Oct 19
+// -- ra_body_size() takes the header, since eType 7 body length depends on it
+// ra_compress.c: 2026 Oct 19
+// -- initial version
@@ -0,0 +1,238 @@
+/*===============================================================
+ra_fan.c: 2026 Oct 19
+several jobs in one pass over a GUPPI raw data file (fan-out)
+---
+"$ ./frsc <job_file> <job_file2> ..." runs several jobs on the same file (e.g. different T0s, channels, or
+STATS) for the cost of reading it once.  main() reads each block, as usual, for the first job, and then hands
+the same block to each of the others ("chains"), in the order given on the command line.  Each chain is
+set up from its own job file as main() sets up the first, and has its own:
+  header    prototype report header, so its own T0, T1, TFLAGS, channels, sInfo, and iSeqNo
+  plan      channel plan, kernel, sliding windows (HOP), tiles (MAX_MEMORY), and LAG_BUDGET monitor
+  memory    working memory (ra_arena.c): T0 buffer, slide, and analysis scratch; ra_work_thread() is
+            switched to it while it swallows the block
+  output    OUTFILE (which must not be another job's), OUTFORMAT, STREAM, SHM, and SUPPRESS
+so its reports are the same, to the bit, as those of a run of its job file alone.  All the job files must
+name the same INFILE.  The block is shared, so it's read whole: MAX_MEMORY doesn't read blocks in pieces
+(tiles still apply).  WORKERS, CHECKPOINT, and --resume apply only to runs of one job, and are ignored
+otherwise.  PROFILE, PROFILE_FILE, CPUS, and NUMA_NODE are the first job's, for the run; PROFILE reports go
+only to its OUTFILE (plan.bNoProf), though a chain's time counts toward them.
+================================================================*/
+
+#define RA_FAN_MAX_JOBS 16  /* job files per run */
+
+struct ra_fan_struct {              /* one chain: a job after the first */
+  char jobfile[RA_MAX_FILENAME_LENGTH];
+  struct ra_header_struct header0;  /* prototype report header */
+  struct ra_opt_struct opt;         /* operating options from jobfile */
+  struct ra_out_struct out;         /* where reports go */
+  struct ra_plan_struct plan;       /* channels to be analyzed */
+  struct ra_slide_struct slide;     /* sliding windows, if HOP (or tiles) */
+  struct ra_lag_struct lag;         /* real-time deadline monitor, if LAG_BUDGET */
+  struct ra_mem_struct mem;         /* RAM budget; tiles, if MAX_MEMORY */
+  struct ra_work_struct work;       /* working memory (see ra_arena.c) */
+  long int nT0;                     /* samples per channel per window (or hop, or tile) */
+  long int nWin;                    /* hops (or tiles) per T0, if HOP (or tiles); else 0 */
+  signed char *blk0;                /* T0 buffer */
+  long int blk0_ptr;
+  double fstart0;
+  double time;                      /* [s] spent in ra_swallow() */
+  };
+
+/*==============================================================*/
+/*=== ra_fan_open() ============================================*/
+/*==============================================================*/
+/* reads job file jobfile into chain fan[iFan], and opens its output.  infile and opt0 are the first job's. */
+/* returns 0 if OK, 1 otherwise */
+
+int ra_fan_open(
+                 struct ra_fan_struct *fan,     /* [in/out] chains; fan[iFan] is [out] */
+                 int iFan,                      /* [in] */
+                 char *jobfile,                 /* [in] */
+                 char *infile,                  /* [in] INFILE */
+                 struct ra_opt_struct *opt0     /* [in] */
+                ) {
+  struct ra_fan_struct *f = &(fan[iFan]);
+  char infile1[RA_MAX_FILENAME_LENGTH];
+  int i, eStatus;
+
+  memset( f, 0, sizeof(struct ra_fan_struct) );
+  strcpy( f->jobfile, jobfile );
+  printf("<jobfile>='%s'\n",jobfile);
+  if ( eStatus = ra_read_jobfile( jobfile, &(f->header0), infile1, &(f->opt) ) ) {
+    printf("FATAL: ra_fan_open(): ra_read_jobfile() failed with code %d\n",eStatus);
+    return 1;
+    }
+  if (strcmp(infile1,infile)) {
+    printf("FATAL: ra_fan_open(): '%s' has INFILE '%s'; the first job's is '%s'\n",jobfile,infile1,infile);
+    return 1;
+    }
+  for (i=-1;i<iFan;i++) {
+    if (strcmp( f->opt.outfile, (i<0) ? opt0->outfile : fan[i].opt.outfile )==0) {
+      printf("FATAL: ra_fan_open(): '%s' has the same OUTFILE ('%s') as another job\n",jobfile,f->opt.outfile);
+      return 1;
+      }
+    }
+  if ( (f->opt.nWorkers>1) || (f->opt.checkpoint>0) || (f->opt.profile>0) || f->opt.profileFile[0] ) {
+    printf("WARNING: ra_fan_open(): '%s': WORKERS, CHECKPOINT, PROFILE, and PROFILE_FILE are ignored for jobs after the first\n",jobfile);
+    }
+
+  if (ra_out_open( &(f->out), f->opt.outfile, f->opt.eOutFormat, f->opt.nColChunk, -1 )) {
+    printf("FATAL: ra_fan_open(): ra_out_open() failed\n");
+    return 1;
+    }
+  if ( f->opt.stream[0] && ra_out_stream( &(f->out), f->opt.stream, f->opt.nStreamQueue, f->opt.eStreamPolicy ) ) {
+    printf("FATAL: ra_fan_open(): ra_out_stream() failed\n");
+    return 1;
+    }
+  if ( f->opt.shm[0] && ra_out_shm( &(f->out), f->opt.shm, f->opt.nShmSize ) ) {
+    printf("FATAL: ra_fan_open(): ra_out_shm() failed\n");
+    return 1;
+    }
+  if ( f->opt.bSuppress && ra_out_suppress( &(f->out), f->opt.rSuppressPower, f->opt.dSuppressKurt,
+                                            f->opt.dSuppressClips, f->opt.heartbeat ) ) {
+    printf("FATAL: ra_fan_open(): ra_out_suppress() failed\n");
+    return 1;
+    }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_fan_whole() ===========================================*/
+/*==============================================================*/
+/* with chains, the first job's blocks are read whole, since they're shared; call after ra_mem_plan() */
+
+void ra_fan_whole( struct ra_mem_struct *mem ) {
+  if (!mem->nPiece) return;
+  mem->nPiece = 0;
+  mem->nBlk   = RG_BLK_SIZE;
+  mem->nTotal = mem->nBlk + mem->nT0buf + mem->nSlide + mem->nScratch + mem->nOut;
+  ra_mem_print( mem, "ra_fan_whole(): blocks are read whole, for all jobs" );
+  }
+
+/*==============================================================*/
+/*=== ra_fan_init() ============================================*/
+/*==============================================================*/
+/* sets up a chain, as main() does the first job, given what's in the GUPPI header.  returns 0 if OK, 1 otherwise */
+
+int ra_fan_init(
+                 struct ra_fan_struct *f,       /* [in/out] */
+                 int overlap,                   /* [in] OVERLAP */
+                 float obsfreq,                 /* [in] OBSFREQ */
+                 float obsbw,                   /* [in] OBSBW */
+                 int obsnchan,                  /* [in] OBSNCHAN */
+                 double fs                      /* [in] 1/TBIN */
+                ) {
+  struct ra_header_struct *header0 = &(f->header0);
+  struct ra_place_struct place;
+  long int nAvail;
+
+  printf("ra_fan_init(): '%s'\n",f->jobfile);
+  header0->tvStart.tv_sec  = 0;
+  header0->tvStart.tv_usec = 0;
+  header0->nCh = obsnchan;
+  header0->bw  = obsbw*(1.0e+6);
+  header0->fc  = obsfreq*(1.0e+6);
+  header0->fs  = fs;
+  ra_out_write( &(f->out), header0, NULL );
+
+  f->nT0 = ( header0->T0 * header0->fs );
+  header0->T0 = (((double) f->nT0)) / header0->fs;
+  if ( (f->opt.hop>0) && (f->opt.hop<header0->T0) ) {
+    f->nT0 = ( f->opt.hop * header0->fs );
+    f->nWin = floor( header0->T0 * header0->fs / f->nT0 + 0.5 );
+    header0->T0 = (((double) f->nT0*f->nWin)) / header0->fs;
+    printf("HOP %le: %ld samples/channel; T0 recomputed, now %le (%ld hops)\n",f->opt.hop,f->nT0,header0->T0,f->nWin);
+    }
+  if (ra_plan_compile( &(f->plan), header0, f->nT0, f->opt.eStats, f->opt.bExact )) return 1;
+
+  /* RAM budget; the block is the first job's, so only tiles apply (see ra_mem.c) */
+  nAvail = ra_swallow_avail( obsnchan, overlap );
+  if (ra_mem_plan( &(f->mem), f->opt.maxMemory, f->plan.nCh, nAvail, f->nT0, f->nWin,
+                   ra_out_mem( &(f->out), obsnchan ) )) return 1;
+  if (f->mem.nTiles) {
+    f->nWin = f->mem.nTiles;
+    f->nT0  = f->mem.nTile;
+    header0->T0 = (((double) f->nT0*f->nWin)) / header0->fs;
+    printf("MAX_MEMORY: %ld samples/channel per tile; T0 recomputed, now %le (%ld tiles)\n",f->nT0,header0->T0,f->nWin);
+    if (ra_plan_compile( &(f->plan), header0, f->nT0, f->opt.eStats, f->opt.bExact )) return 1;
+    }
+  f->mem.nPiece = 0;
+  f->mem.nBlk   = 0;
+  f->plan.bNoProf = 1; /* PROFILE reports are the first job's */
+
+  /* working memory; the thread is the first job's to place, so only HUGEPAGES applies */
+  memcpy( &place, &(f->opt.place), sizeof(struct ra_place_struct) );
+  place.cpus[0] = '\0';
+  place.node    = -1;
+  if (ra_work_init( &(f->work), ra_mem_arena( &(f->mem) ), &place )) return 1;
+
+  if (f->nWin>1) {
+    if (ra_slide_init( &(f->slide), f->nWin, f->plan.nCh, f->mem.nTiles>0, &(f->work.arena) )) return 1;
+    f->plan.slide = &(f->slide);
+    }
+  if (f->opt.lagBudget>0) {
+    if (f->plan.slide) {
+      printf("WARNING: ra_fan_init(): LAG_BUDGET is ignored with HOP, or T0 in tiles (MAX_MEMORY)\n");
+      } else {
+      if (ra_lag_init( &(f->lag), &(f->plan), header0, f->opt.bExact, f->opt.lagBudget, f->opt.lagLadder, f->opt.nLagSub,
+                       f->opt.bLagPriority ? f->opt.bChLagPriority : NULL )) return 1;
+      f->plan.lag = &(f->lag);
+      }
+    }
+
+  printf("nT0 = %ld; header0.T0 recomputed, now %le. blk0 (buffer) is %f MB\n",f->nT0,header0->T0,((double)f->nT0*f->plan.nCh*RG_NPOL)/(1024.0*1024.0));
+  if ( (f->blk0 = ra_arena_alloc( &(f->work.arena), f->nT0 * f->plan.nCh * RG_NPOL * sizeof(*(f->blk0)), "blk0" ) ) == NULL ) return 1;
+  f->blk0_ptr = 0;
+  f->fstart0  = 0;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_fan_swallow() =========================================*/
+/*==============================================================*/
+/* each chain swallows the block, with its own working memory; then work0 is the thread's again */
+
+void ra_fan_swallow(
+                     struct ra_fan_struct *fan,    /* [in/out] chains */
+                     int nFan,                     /* [in] */
+                     signed char *blk,             /* [in] the block, as read for the first job */
+                     long int nAvail,              /* [in] samples per channel in blk, excluding overlap */
+                     float chan_bw,                /* [in] CHAN_BW */
+                     struct ra_work_struct *work0  /* [in] the first job's working memory */
+                    ) {
+  struct timeval tv;
+  int i;
+
+  for (i=0;i<nFan;i++) {
+    gettimeofday(&tv,NULL);
+    ra_work_thread( &(fan[i].work) );
+    ra_swallow( blk, &(fan[i].header0), &(fan[i].plan), fan[i].blk0, &(fan[i].blk0_ptr), fan[i].nT0, nAvail, chan_bw,
+                &(fan[i].out), &(fan[i].fstart0) );
+    fan[i].time += ra_timer(tv);
+    }
+  ra_work_thread( work0 );
+  }
+
+/*==============================================================*/
+/*=== ra_fan_close() ===========================================*/
+/*==============================================================*/
+
+void ra_fan_close( struct ra_fan_struct *fan, int nFan ) {
+  int i;
+  for (i=0;i<nFan;i++) {
+    ra_out_close( &(fan[i].out) );
+    printf("ra_fan_close(): '%s': %ld reports to '%s'; %lf s in swallow(); working memory %.1f of %.1f MB used\n",
+           fan[i].jobfile,(long int) fan[i].header0.iSeqNo,fan[i].opt.outfile,fan[i].time,
+           (double) fan[i].work.arena.high/RA_MEM_MB,(double) fan[i].work.arena.size/RA_MEM_MB);
+    if (fan[i].plan.lag) ra_lag_print( fan[i].plan.lag );
+    ra_work_free( &(fan[i].work) );
+    }
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_fan.c: 2026 Oct 19
+// -- chains don't take PROFILE ticks (plan.bNoProf)
+// ra_fan.c: 2026 Oct 19
+// -- initial version
@@ -34,9 +34,20 @@ struct ra_header_struct {
              /* =4 time domain analysis, subchannels, period-T1 update */
              /* =5 freq domain analysis for specified channel, period-T0 update */
              /* =6 freq domain analysis for specified channel, period-T2 update */
+             /* =7 time domain moments (accumulator state) for channels, period-T0 update */
+             /* =8 ADC health (clips and bit occupancy) for channels, period-T0 update */
 
   /* error/status */
   long int err; /* Bits set to identify error/status; err=0 means all OK. */
+                /* b0: eType=1 report written only because the heartbeat interval expired (see ra_suppress.c) */
+                /* b1: eType=0 report is a profiling diagnostic; sInfo says how fast frsc is going (see ra_prof.c) */
+                /* b2: frsc is behind; higher moments (rms, skewness, kurtosis) not computed (see ra_lag.c) */
+                /* b3: frsc is behind; only one window in LAG_SUBSAMPLE is analyzed (see ra_lag.c) */
+                /* b4: frsc is behind; only LAG_PRIORITY channels are analyzed (see ra_lag.c) */
+                /* b5: eType=0 report is a change of degradation level; sInfo says why (see ra_lag.c) */
+                /* b6-b31: RESERVED */
+                /* b32-b63: number of eType=1 reports suppressed (see ra_suppress.c) since the previous one written; */
+                /*   in an eType=0 report, the number suppressed at the end of a run */
 
   /*******************************************/
   /*** metadata that shouldn't be changing ***/
@@ -75,7 +86,9 @@ struct ra_header_struct {
                /*           ...applies only to Stokes-I */
                /* b4:       Do baseline cal for channels? (1=Yes). Channels flagged in bChIn[] will not be baselined. */
                /*           ...applies only to Stokes-I */
-               /* b5-b7:    RESERVED */
+               /* b5:       Also report time-domain moments for channels (eType 7)? (1=Yes). Requires b1. */
+               /* b6:       Also report ADC health for channels (eType 8)? (1=Yes). Requires b1. */
+               /* b7:       RESERVED */
   char fflags; /* b0 (LSB): RESERVED. (Some day: Do freq-domain analysis for entire available bandwidth? (1=Yes).) */
                /* b1:       Do freq-domain analysis for channels? (1=Yes). Channels flagged in bChIn[] will not be analyzed. */
                /* b2:       Do freq-domain analysis for subchannels? (1=Yes). Subchannels in channels flagged bChIn[] will not be analyzed. */
@@ -170,7 +183,7 @@ struct clips_struct {
 /****************************************************************************************************************/
 
 struct ra_td {
-  struct clips_struct clips;                 /* clip counters */
+  struct clips_struct clips;                 /* clip counters, summed over all channels analyzed */
   struct DAPstruct tda;                      /* full bandwidth (all channels as one) */
   struct DAPstruct tdac[RA_MAX_CH_DIV64*64]; /* per channel */
   }; 
@@ -200,6 +213,179 @@ struct ra_fd {
   struct DAPstruct *fda; /* statistics. Needs to be allocated [1..nfch] */ 
   }; 
 
+/***********************************************************************************************************/
+/***********************************************************************************************************/
+/*** "New Information" section for eType=7: time domain moments for channels, period-T0 update          ***/
+/***********************************************************************************************************/
+/***********************************************************************************************************/
+
+/*
+The statistics in eType=1 reports are finished quantities; e.g., the kurtosis of two intervals can't be 
+determined from the kurtosis of each.  eType=7 reports instead carry the state of the accumulators from 
+which the statistics are computed: the number of samples, the sums of the first four powers of each 
+quantity, and its maximum and minimum.  Since the samples are integers, these sums are exact integers, 
+and the reports for any number of consecutive intervals can be combined (by adding the sums, and taking 
+the max of the maxima and min of the minima) into exactly the state that analysis of the combined interval 
+would have produced.  See ra_moments.c.
+An eType=7 report follows the eType=1 report for the same interval, and has the same fStart.
+The quantities are those of struct DAPstruct: xi, xq, yi, yq, xm2 = xi^2+xq^2, ym2 = yi^2+yq^2, 
+u = 2(xi*yi+xq*yq), v = -2(xq*yi-xi*yq).  
+Only the channels analyzed (those not flagged in bChIn[]) are included, in increasing order, so the 
+length of the report depends on the header.
+*/
+
+struct ra_int128 {   /* 128-bit two's complement integer, = hi*2^64 + lo */
+  unsigned long lo;
+  long hi;
+  };
+
+struct MAstruct {
+  long s1;               /* sum of x */
+  struct ra_int128 s2;   /* sum of x^2 */
+  struct ra_int128 s3;   /* sum of x^3 */
+  struct ra_int128 s4;   /* sum of x^4 */
+  float max;             /* maximum value over interval */
+  float min;             /* minimum value over interval */
+  };
+
+struct MAPstruct {
+  long n;                    /* number of samples */
+  struct clips_struct clips; /* clip counters, for this channel */
+  struct MAstruct xi;
+  struct MAstruct xq;
+  struct MAstruct yi;
+  struct MAstruct yq;
+  struct MAstruct xm2;
+  struct MAstruct ym2;
+  struct MAstruct u;
+  struct MAstruct v;
+  };
+
+struct ra_tm {
+  struct clips_struct clips; /* clip counters, all channels */
+  long nChStored;            /* number of channels which follow */
+  struct MAPstruct tmc[];    /* per channel; [nChStored] */
+  };
+
+/***********************************************************************************************************/
+/***********************************************************************************************************/
+/*** "New Information" section for eType=8: ADC health for channels, period-T0 update                   ***/
+/***********************************************************************************************************/
+/***********************************************************************************************************/
+
+/*
+Diagnostics for setting ADC levels, per channel: clip counters for each polarization, and, for each of
+xi, xq, yi, yq, how often each bit of the 8-bit sample is set, and the number of bits effectively in use.
+For a well-set level, the low bits and the sign bit are each set about half the time, and the bits above
+those in use are set only as often as the sign bit is (i.e., the sample is negative).  "Effective bits"
+is the entropy of the sample values, in bits; for Gaussian noise of rms r (in units of 1 LSB) it is about
+log2(4.13*r), and 8 is the most possible.
+An eType=8 report follows the eType=1 report (and eType=7 report, if any) for the same interval, and has
+the same fStart.  Only the channels analyzed (those not flagged in bChIn[]) are included, in increasing 
+order, as in eType=7 reports.
+*/
+
+struct HAstruct {
+  float bits;                /* effective bits: entropy of the sample values [bits] */
+  float occ[8];              /* fraction of samples with bit b set; b=0 is the LSB, b=7 the sign bit */
+  };
+
+struct HPstruct {
+  long n;                    /* number of samples */
+  struct clips_struct clips; /* clip counters, for this channel */
+  struct HAstruct xi;
+  struct HAstruct xq;
+  struct HAstruct yi;
+  struct HAstruct yq;
+  };
+
+struct ra_th {
+  long nChStored;            /* number of channels which follow */
+  struct HPstruct thc[];     /* per channel; [nChStored] */
+  };
+
+
+
+/**************************************************************************************************************/
+/**************************************************************************************************************/
+/*** Compressed report stream.  (Not a report format; a container for reports.)                            ***/
+/**************************************************************************************************************/
+/**************************************************************************************************************/
+
+/*
+Optionally, reports are written in compressed "frames" instead of one after another.  
+Each frame is a struct ra_frame_struct followed by nComp bytes of compressed payload.  
+A frame does not depend on any other frame; decompressing it (see ra_compress.c) yields exactly the bytes of nReports consecutive reports. 
+When the stream is closed normally, a frame index follows the last frame: one struct ra_frame_index_struct per frame, then a struct ra_frame_tail_struct.
+A reader which doesn't find the tail (e.g., the writer crashed) can simply read the frames sequentially.
+*/
+
+#define RA_FRAME_MAGIC       0x46435352 /* "RSCF"; distinguishes a compressed stream from an uncompressed one, which starts with eType */
+#define RA_FRAME_TAIL_MAGIC  0x58435352 /* "RSCX" */
+#define RA_FRAME_MAX_REPORTS 64         /* maximum number of reports in a frame */
+#define RA_FRAME_MAX_ETYPE   16         /* eType must be less than this */
+
+struct ra_frame_struct {
+  int magic;          /* =RA_FRAME_MAGIC */
+  int nReports;       /* number of reports in this frame */
+  long int nRaw;      /* number of bytes after decompression */
+  long int nComp;     /* number of bytes of compressed payload following this structure */
+  long int iSeqNo;    /* iSeqNo of first report in frame */
+  double fStart;      /* fStart of first report in frame */
+  };
+
+struct ra_frame_index_struct {
+  long int offset;    /* [bytes] position of the frame's struct ra_frame_struct, from beginning of stream */
+  long int iSeqNo;    /* iSeqNo of first report in frame */
+  double fStart;      /* fStart of first report in frame */
+  long int nReports;  /* number of reports in frame */
+  };
+
+struct ra_frame_tail_struct {
+  long int nFrames;   /* number of entries in index */
+  long int offset;    /* [bytes] position of the first struct ra_frame_index_struct, from beginning of stream */
+  int magic;          /* =RA_FRAME_TAIL_MAGIC */
+  int reserved;
+  };
+
+
+/**************************************************************************************************************/
+/**************************************************************************************************************/
+/*** Columnar statistics store.  (Not a report format; an alternative layout for eType 1 and 2 reports.)    ***/
+/**************************************************************************************************************/
+/**************************************************************************************************************/
+
+/*
+Optionally, frsc writes the contents of eType=1,2 reports "column-wise", so that the history of a single statistic can
+be read without reading everything else.  The file begins with a struct ra_col_file_struct, which holds the eType=0
+report header and the list of channels that are stored.  Chunks follow, each a struct ra_col_chunk_struct followed by
+the columns, each column being nRec consecutive values (one per report):
+  iSeqNo (long int), fStart (double), eType (long int), err (long int), clips.x (long int), clips.y (long int),
+  then for each stored channel (in the order of iCh[]), for each of the 8 members of struct DAPstruct (xi, xq, ..., v),
+  for each of the 5 members of struct DAstruct (mean, max, rms, s, k): a float column.
+New chunks are simply appended; see ra_columns.c for the arithmetic that locates a column within a chunk.
+*/
+
+#define RA_COL_MAGIC        0x4c435352 /* "RSCL" */
+#define RA_COL_CHUNK_MAGIC  0x4b435352 /* "RSCK" */
+#define RA_COL_NBASE        6          /* number of (8-byte) columns before the per-channel columns */
+#define RA_COL_NPERCH       40         /* number of float columns per channel = 8 DAstruct's x 5 floats */
+
+struct ra_col_file_struct {
+  int magic;                              /* =RA_COL_MAGIC */
+  int nChunkMax;                          /* maximum number of reports per chunk */
+  long int nChStored;                     /* number of channels stored */
+  short int iCh[RA_MAX_CH_DIV64*64];      /* channels stored, 1..nCh, in the order they appear in each chunk */
+  struct ra_header_struct header;         /* the eType=0 report header */
+  };
+
+struct ra_col_chunk_struct {
+  int magic;                              /* =RA_COL_CHUNK_MAGIC */
+  int nRec;                               /* number of reports (values per column) in this chunk */
+  long int nBytes;                        /* number of bytes of columns following this structure */
+  long int iSeqNo;                        /* iSeqNo of first report in chunk */
+  double fStart;                          /* fStart of first report in chunk */
+  };
 
 
 /*******************************/
@@ -10,6 +10,19 @@
 #define RA_H_ETYPE_TS1      4 /* time domain analysis, subchannels, period-T1 update */
 #define RA_H_ETYPE_FC0      5 /* freq domain analysis for specified channel, period-T0 update */
 #define RA_H_ETYPE_FC2      6 /* freq domain analysis for specified channel, period-T2 update */
+#define RA_H_ETYPE_TM0      7 /* time domain moments (accumulator state) for channels, period-T0 update */
+#define RA_H_ETYPE_TH0      8 /* ADC health (clips and bit occupancy) for channels, period-T0 update */
+
+/* err */
+#define RA_H_ERR_HEARTBEAT    1 /* b0:      eType 1 report written only because HEARTBEAT expired (see ra_suppress.c) */
+#define RA_H_ERR_PROFILE      2 /* b1:      eType 0 report is a profiling diagnostic; sInfo says how fast frsc is going (see ra_prof.c) */
+#define RA_H_ERR_LAG_HIGHER   4 /* b2:      frsc is behind; higher moments (rms, skewness, kurtosis) not computed (see ra_lag.c) */
+#define RA_H_ERR_LAG_SUBSAMPLE 8 /* b3:     frsc is behind; only one window in LAG_SUBSAMPLE is analyzed (see ra_lag.c) */
+#define RA_H_ERR_LAG_CHANNELS 16 /* b4:     frsc is behind; only LAG_PRIORITY channels are analyzed (see ra_lag.c) */
+#define RA_H_ERR_LAG         32 /* b5:      eType 0 report is a change of degradation level; sInfo says why (see ra_lag.c) */
+                                /* b6-b31:  RESERVED */
+#define RA_H_ERR_NSUPP_SHIFT 32 /* b32-b63: number of eType 1 reports suppressed immediately before this one (see ra_suppress.c) */
+#define RA_H_ERR_NSUPP(err) ( ((unsigned long int) (err)) >> RA_H_ERR_NSUPP_SHIFT )
 
 /* eSource */
 #define RA_H_ESOURCE_GUPPI_FILE 1 /* 1 = GUPPI raw data file */
@@ -24,7 +37,9 @@
                            /*           ...applies only to Stokes-I */
 #define RA_H_TFLAGS_TBC 16 /* b4:       Do baseline cal for channels? (1=Yes). Channels flagged in bChIn[] will not be baselined. */
                            /*           ...applies only to Stokes-I */
-                           /* b5-b7:    RESERVED */
+#define RA_H_TFLAGS_TM  32 /* b5:       Also report time-domain moments for channels (eType 7)? (1=Yes). Requires b1. */
+#define RA_H_TFLAGS_TH  64 /* b6:       Also report ADC health for channels (eType 8)? (1=Yes). Requires b1. */
+                           /* b7:       RESERVED */
 
 /* fflags */
 #define RA_H_FFLAGS_FF    1 /* b0 (LSB): RESERVED. (Some day: Do freq-domain analysis for entire available bandwidth? (1=Yes).) */
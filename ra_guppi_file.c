@@ -25,6 +25,9 @@ int rg_read_header(
   int eState=0;
   char c[2];
   long int header_len = 0;
+  long int nSkip;
+  char *pos;
+  int directio = 0;
 
   /* this makes "c" a proper string even though we only load the first byte: */
   memset(&(c[1]),'\0',1); 
@@ -56,26 +59,45 @@ int rg_read_header(
 
     } 
 
-  /* advance one position, to the beginning of the run of spaces */
-  fread( c, 1, 1, fp); /* read one character */
-  (*fpos)++;
-
-  /* Run out the spaces */
-  while (c[0]==' ') {
-    fread( c, 1, 1, fp); /* read one character */
-    (*fpos)++;
-    //printf("%1s",c);
+  /* Skip the rest of the END card (spaces), and, if DIRECTIO is set, the padding to a multiple of 512 bytes. */
+  /* (Running out the spaces instead, as this once did, also eats the first byte of the data block if it */
+  /* happens to be 0x20; i.e., if xi of the first sample of channel 1 is 32.) */
+  nSkip = (80 - header_len%80) % 80;
+  if ( (pos = strstr(header,"DIRECTIO")) && (pos = strstr(pos,"=")) && (sscanf(pos+1,"%d",&directio)==1) && directio ) {
+    nSkip += (512 - (header_len+nSkip)%512) % 512;
     }
-  //printf("Next non-space character is byte %ld\n",i);
-
-  /* back up one position */
-  fseek(fp, (*fpos)-1, SEEK_SET); 
-  (*fpos)--;
+  (*fpos) += nSkip;
+  fseek(fp, *fpos, SEEK_SET); 
 
   return 0;
   }
 
 
+/*************************************************************************/
+/*** rg_header_card() ****************************************************/
+/*************************************************************************/
+/* appends an 80-character header card to header; value is a string (quoted) if bString, otherwise a number */
+/* (used to write headers; see frsc_gen.c) */
+
+void rg_header_card( 
+                    char *header,   /* [in/out] header string */
+                    char *keyword,  /* [in] e.g. "OBSNCHAN" */
+                    char *value,    /* [in] e.g. "32" */
+                    int bString     /* [in] 1: value is a string, e.g. 'GUPPI' */
+                    ) {
+  char card[81];
+  char quoted[72];
+
+  if (bString) {
+      sprintf(quoted,"'%-8s'",value);
+      sprintf(card,"%-8.8s= %-70.70s",keyword,quoted);
+    } else {
+      sprintf(card,"%-8.8s= %20.20s%50s",keyword,value,"");
+    }
+  strcat(header,card);
+  }
+
+
 /*************************************************************************/
 /*** rg_analyze_header() *************************************************/
 /*************************************************************************/
@@ -163,6 +185,10 @@ int rg_analyze_header(
     printf("FATAL: rg_analyze_header() says OBSNCHAN=%d is greater than (RA_MAX_CH_DIV64*64)=%d\n",*obsnchan,(RA_MAX_CH_DIV64*64));
     return 1;
     }
+  if ( (*obsnchan<1) || (RG_BLK_SIZE % ((*obsnchan)*RG_NPOL)) ) {
+    printf("FATAL: rg_analyze_header() says OBSNCHAN=%d doesn't divide a block of RG_BLK_SIZE=%d bytes into whole samples\n",*obsnchan,RG_BLK_SIZE);
+    return 1;
+    }
 
   /* get OBSBW (bandwidth of bandpass) */
   pos = strstr(header,"OBSBW");
@@ -199,3 +225,12 @@ int rg_analyze_header(
   return 0;
   }
 
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_guppi_file.c: 2026 Oct 19
+// -- rg_header_card()
+// ra_guppi_file.c: 2026 Oct 19
+// -- rg_read_header() skips exactly the rest of the END card (and DIRECTIO padding), rather than all
+//    spaces; a data block beginning with byte 0x20 was misread
+// -- rg_analyze_header() checks that OBSNCHAN divides the block
@@ -0,0 +1,354 @@
+/*===============================================================
+ra_kernels.c: 2026 Oct 19
+specialized kernels for time-domain analysis of channels (eType 1 reports)
+---
+Which statistics are computed for each analyzed channel is set by STATS in the job file, as a list of
+  iq      mean and max of xi, xq, yi, yq
+  power   mean and max of xm2, ym2
+  stokes  mean and max of u, v
+  higher  also rms, skewness, and kurtosis of each of the above
+or "all" (the default, and the same as "iq,power,stokes,higher").  Statistics not computed are written as 0.
+Clip counters are always computed.  If bit 6 of TFLAGS is set, the kernels also count how often each value
+of xi, xq, yi, yq occurs, in the same pass, for the ADC health (eType 8) report; see ra_th_finish().
+
+Each combination (with or without ADC health) is a separate function, generated by RA_KERNEL() from the
+same body with the choices as constants, so the compiler drops the unused arithmetic instead of testing for it for every sample.
+ra_kernel_select() picks one, once, at startup (see ra_plan.c).  E.g., "STATS power" does none of the
+arithmetic for xi, xq, yi, yq, u, v, or the higher moments.  The order of operations for each statistic
+is the same as in every other kernel, so a statistic has the same value whatever else is computed.
+
+With "EXACT 1" in the job file, the exact kernels (RA_KERNEL_EXACT()) are used instead.  Since samples
+are integers, these accumulate sums of powers of each quantity as integers (64 bits, or 128 where 64
+could overflow), in one pass, and convert to statistics only at the end, in long double, by
+ra_tm_finalize() of ra_moments.c.  Integer sums don't depend on the order in which samples are added, so
+the results don't either: they are the same however the work is divided (among threads, SIMD lanes, or
+hops; see ra_slide.c), on any machine, and the same as frsc_read -r computes from eType 7 reports.  The
+float kernels' sums, by contrast, lose precision as T0 gets longer.
+
+A kernel sees a channel's T0 window as one or two spans (struct ra_span_struct): usually a single span
+in the GUPPI block, where samples are interleaved, and, for the window that crosses from one block to
+the next, the part saved from the previous block (as planes; see ra_swallow.c) followed by the rest.
+================================================================*/
+
+#define RA_STATS_IQ      1
+#define RA_STATS_POWER   2
+#define RA_STATS_STOKES  4
+#define RA_STATS_HIGHER  8
+#define RA_STATS_ALL    15
+
+#define RA_MAX_SPANS 2
+
+/* consecutive samples of one channel: xi, xq, yi, yq of the n'th are x[n*dS], x[n*dS+dC], x[n*dS+2*dC], x[n*dS+3*dC] */
+struct ra_span_struct {
+  signed char *x;   /* xi of the first sample */
+  long int n;       /* number of samples */
+  long int dS;      /* [bytes] from one sample to the next: RG_NPOL if interleaved, 1 if planes */
+  long int dC;      /* [bytes] from xi to xq, xq to yi, yi to yq: 1 if interleaved, length of plane if planes */
+  };
+
+typedef void (*ra_kernel_t)( struct ra_span_struct *span, int nSpan, long int mev2, struct DAPstruct *d, struct clips_struct *clips,
+                             struct HPstruct *h );
+
+/* counting the values of xi, xq, yi, yq of the sample at x (see ra_th_finish()) */
+#define RA_K_HIST(X,DC) { hist[0][(unsigned char) (X)[0]]++;      hist[1][(unsigned char) (X)[DC]]++;   \
+                          hist[2][(unsigned char) (X)[2*(DC)]]++; hist[3][(unsigned char) (X)[3*(DC)]]++; }
+
+/*==============================================================*/
+/*=== ra_th_finish() ===========================================*/
+/*==============================================================*/
+/* ADC health of one channel (struct HPstruct; see ra_format.c) from the counts of each value of xi, xq, */
+/* yi, yq (as unsigned char, so the bits of the index are those of the sample) over n samples */
+
+void ra_th_finish(
+                   long int (*hist)[256],       /* [in] [4][256] */
+                   long int n,                  /* [in] number of samples */
+                   struct clips_struct *clips,  /* [in] */
+                   struct HPstruct *h           /* [out] */
+                  ) {
+  struct HAstruct *ha = &(h->xi); /* the 4 struct HAstruct's, as an array */
+  long int nBit[8];
+  double p, e;
+  int c, i, b;
+
+  memset( h, 0, sizeof(struct HPstruct) );
+  h->n = n;
+  h->clips = *clips;
+  if (n<=0) return;
+  for (c=0;c<4;c++) {
+    memset( nBit, 0, sizeof(nBit) );
+    e = 0;
+    for (i=0;i<256;i++) {
+      if (hist[c][i]==0) continue;
+      for (b=0;b<8;b++) { if (i & (1<<b)) nBit[b] += hist[c][i]; }
+      p = ((double) hist[c][i]) / n;
+      e -= p*log2(p);
+      }
+    for (b=0;b<8;b++) { ha[c].occ[b] = ((double) nBit[b]) / n; }
+    ha[c].bits = e;
+    }
+
+  return;
+  }
+
+/* accumulating mean and max; finishing up */
+#define RA_K_MM(S,A)  { (S).mean += (A); if ( (A) > (S).max ) { (S).max = (A); } }
+/* accumulating rms, skewness, kurtosis about the mean; finishing up */
+#define RA_K_HI(S,A)  { q = (A) - (S).mean; q2 = q *q; (S).rms += q2; \
+                                            q3 = q2*q; (S).s   += q3; \
+                                            q4 = q3*q; (S).k   += q4; }
+#define RA_K_HI_DONE(S,N) { (S).rms = sqrt( (S).rms / (N) ); \
+                            (S).s   =     ( (S).s   / (N) ) / ( (S).rms * (S).rms * (S).rms ); \
+                            (S).k   =     ( (S).k   / (N) ) / ( (S).rms * (S).rms * (S).rms * (S).rms ) - 3.0; }
+
+/*==============================================================*/
+/*=== RA_KERNEL() ==============================================*/
+/*==============================================================*/
+/* Generates a kernel named NAME.  IQ, PWR, STK, HI are 0 or 1; see RA_STATS_* above.  HL is 1 for ADC health. */
+/* span[0..nSpan-1]: the samples of one channel, in order; d: [out] statistics; clips: [out] clip counters; */
+/* h: [out] ADC health, if HL (otherwise not used) */
+
+#define RA_KERNEL(NAME,IQ,PWR,STK,HI,HL)                                                                         \
+void NAME( struct ra_span_struct *span, int nSpan, long int mev2, struct DAPstruct *d, struct clips_struct *clips,\
+           struct HPstruct *h ) {                                                                                \
+  long int n, nSamples = 0;                                                                                      \
+  int j;                                                                                                         \
+  signed char *x;                                                                                                \
+  long int dS, dC;                                                                                               \
+  float xi,xq,yi,yq,xx,yy,xyi,xyq;                                                                               \
+  float q,q2,q3,q4;                                                                                              \
+  long int hist[HL?4:1][256];                                                                                    \
+  memset( d, 0, sizeof(struct DAPstruct) );                                                                      \
+  if (HL) memset( hist, 0, sizeof(hist) );                                                                       \
+  clips->x = 0;                                                                                                  \
+  clips->y = 0;                                                                                                  \
+  /* pass 1: clips, mean, max (and ADC health) */                                                                \
+  for ( j=0; j<nSpan; j++ ) {                                                                                    \
+    x = span[j].x; dS = span[j].dS; dC = span[j].dC;                                                             \
+    for ( n=0; n<span[j].n; n++, x+=dS ) {                                                                       \
+      xi = (float) x[0];                                                                                         \
+      xq = (float) x[dC];                                                                                        \
+      yi = (float) x[2*dC];                                                                                      \
+      yq = (float) x[3*dC];                                                                                      \
+      xx = xi*xi + xq*xq;                                                                                        \
+      yy = yi*yi + yq*yq;                                                                                        \
+      if (xx>=mev2) { clips->x++; }                                                                              \
+      if (yy>=mev2) { clips->y++; }                                                                              \
+      if (HL)  { RA_K_HIST(x,dC); }                                                                              \
+      if (IQ)  { RA_K_MM(d->xi,xi); RA_K_MM(d->xq,xq); RA_K_MM(d->yi,yi); RA_K_MM(d->yq,yq); }                   \
+      if (PWR) { RA_K_MM(d->xm2,xx); RA_K_MM(d->ym2,yy); }                                                       \
+      if (STK) { xyi = xi*yi + xq*yq; xyq = xq*yi - xi*yq; RA_K_MM(d->u,xyi); RA_K_MM(d->v,xyq); }               \
+      }                                                                                                          \
+    nSamples += span[j].n;                                                                                       \
+    }                                                                                                            \
+  if (HL)  { ra_th_finish( hist, nSamples, clips, h ); }                                                         \
+  if (IQ)  { d->xi.mean /= nSamples; d->xq.mean /= nSamples; d->yi.mean /= nSamples; d->yq.mean /= nSamples; }   \
+  if (PWR) { d->xm2.mean /= nSamples; d->ym2.mean /= nSamples; }                                                 \
+  if (STK) { d->u.mean /= (+0.5*nSamples); d->v.mean /= (-0.5*nSamples); d->u.max *= (+2.0); d->v.max *= (-2.0); }\
+  if (!HI) return;                                                                                               \
+  /* pass 2: rms, skewness, kurtosis */                                                                          \
+  for ( j=0; j<nSpan; j++ ) {                                                                                    \
+    x = span[j].x; dS = span[j].dS; dC = span[j].dC;                                                             \
+    for ( n=0; n<span[j].n; n++, x+=dS ) {                                                                       \
+      xi = (float) x[0];                                                                                         \
+      xq = (float) x[dC];                                                                                        \
+      yi = (float) x[2*dC];                                                                                      \
+      yq = (float) x[3*dC];                                                                                      \
+      if (IQ)  { RA_K_HI(d->xi,xi); RA_K_HI(d->xq,xq); RA_K_HI(d->yi,yi); RA_K_HI(d->yq,yq); }                   \
+      if (PWR) { xx = xi*xi + xq*xq; yy = yi*yi + yq*yq; RA_K_HI(d->xm2,xx); RA_K_HI(d->ym2,yy); }               \
+      if (STK) { xyi = xi*yi + xq*yq; xyq = xq*yi - xi*yq; RA_K_HI(d->u,2.0*xyi); RA_K_HI(d->v,-2.0*xyq); }      \
+      }                                                                                                          \
+    }                                                                                                            \
+  if (IQ)  { RA_K_HI_DONE(d->xi,nSamples); RA_K_HI_DONE(d->xq,nSamples);                                         \
+             RA_K_HI_DONE(d->yi,nSamples); RA_K_HI_DONE(d->yq,nSamples); }                                       \
+  if (PWR) { RA_K_HI_DONE(d->xm2,nSamples); RA_K_HI_DONE(d->ym2,nSamples); }                                     \
+  if (STK) { RA_K_HI_DONE(d->u,nSamples); RA_K_HI_DONE(d->v,nSamples); }                                         \
+  }
+
+/* one kernel for each nonempty combination, named P<RA_STATS_* bits>; e.g. ra_kernel_15, ra_kernel_h15 */
+#define RA_KERNEL_SET(GEN,P,HL) \
+  GEN(P##1, 1,0,0,0,HL) GEN(P##2, 0,1,0,0,HL) GEN(P##3, 1,1,0,0,HL) GEN(P##4, 0,0,1,0,HL) \
+  GEN(P##5, 1,0,1,0,HL) GEN(P##6, 0,1,1,0,HL) GEN(P##7, 1,1,1,0,HL) GEN(P##9, 1,0,0,1,HL) \
+  GEN(P##10,0,1,0,1,HL) GEN(P##11,1,1,0,1,HL) GEN(P##12,0,0,1,1,HL) GEN(P##13,1,0,1,1,HL) \
+  GEN(P##14,0,1,1,1,HL) GEN(P##15,1,1,1,1,HL)
+/* ...and a table of them, indexed by RA_STATS_* bits */
+#define RA_KERNEL_TABLE(P) { NULL,   P##1,  P##2,  P##3,  P##4,  P##5,  P##6,  P##7, \
+                             NULL,   P##9,  P##10, P##11, P##12, P##13, P##14, P##15 }
+
+RA_KERNEL_SET(RA_KERNEL,ra_kernel_,0)
+RA_KERNEL_SET(RA_KERNEL,ra_kernel_h,1)
+
+ra_kernel_t ra_kernels[2][16] = { RA_KERNEL_TABLE(ra_kernel_), RA_KERNEL_TABLE(ra_kernel_h) }; /* [HL][eStats] */
+
+/*==============================================================*/
+/*=== ra_kernel_td() ===========================================*/
+/*==============================================================*/
+/* statistics from exact accumulators, as in eType 1 reports: max of xi..u is never less than 0, and */
+/* v.max is the minimum of v if less than 0 (otherwise 0), as the float kernels compute it. */
+/* Statistics not selected by eStats are 0. */
+
+void ra_kernel_td(
+                   struct MAPstruct *m,         /* [in] */
+                   int eStats,                  /* [in] RA_STATS_* bits */
+                   struct DAPstruct *d,         /* [out] */
+                   struct clips_struct *clips   /* [out] */
+                  ) {
+  struct DAstruct *da = &(d->xi);
+  float mins[8];
+  int c;
+
+  ra_tm_finalize( m, d, mins );
+  for (c=0;c<7;c++) { if (da[c].max<0) da[c].max = 0; }
+  d->v.max = ( mins[7]<0 ? mins[7] : 0 );
+  *clips = m->clips;
+
+  if (!(eStats & RA_STATS_IQ))     { memset( &(d->xi),  0, 4*sizeof(struct DAstruct) ); }
+  if (!(eStats & RA_STATS_POWER))  { memset( &(d->xm2), 0, 2*sizeof(struct DAstruct) ); }
+  if (!(eStats & RA_STATS_STOKES)) { memset( &(d->u),   0, 2*sizeof(struct DAstruct) ); }
+  if (!(eStats & RA_STATS_HIGHER)) { for (c=0;c<8;c++) { da[c].rms = 0; da[c].s = 0; da[c].k = 0; } }
+
+  return;
+  }
+
+/*==============================================================*/
+/*=== RA_KERNEL_EXACT() ========================================*/
+/*==============================================================*/
+/* Generates an exact kernel named NAME; same arguments and conventions as RA_KERNEL().  Quantities are */
+/* numbered as in struct MAPstruct: 0-3 xi,xq,yi,yq; 4-5 xm2,ym2; 6-7 u,v.  For 0-3, all sums fit in 64 */
+/* bits; for 4-7, s2..s4 are 128 bits (as in ra_tm_channel()). */
+
+#define RA_K_X_ACC(C0,C1,HI) { for (c=C0;c<=C1;c++) {                                                 \
+                               s1[c] += v[c];                                                       \
+                               if (v[c]>vmax[c]) vmax[c] = v[c];                                    \
+                               if (v[c]<vmin[c]) vmin[c] = v[c];                                    \
+                               if (HI) { q = v[c]*v[c];                                             \
+                                         if (c<4) { s2[c] += q; s3[c] += q*v[c]; s4[c] += q*q; }    \
+                                             else { S2[c-4] += q; S3[c-4] += ((__int128) q)*v[c];   \
+                                                    S4[c-4] += ((__int128) q)*q; } } } }
+
+#define RA_KERNEL_EXACT(NAME,IQ,PWR,STK,HI,HL)                                                                   \
+void NAME( struct ra_span_struct *span, int nSpan, long int mev2, struct DAPstruct *d, struct clips_struct *clips,\
+           struct HPstruct *h ) {                                                                                \
+  struct MAPstruct m;                                                                                            \
+  struct MAstruct *ma = &(m.xi);                                                                                 \
+  long int n;                                                                                                    \
+  int j, c;                                                                                                      \
+  signed char *x;                                                                                                \
+  long int dS, dC;                                                                                               \
+  long int v[8];                                                                                                 \
+  long int s1[8] = {0}, s2[4] = {0}, s3[4] = {0}, s4[4] = {0};                                                   \
+  __int128 S2[4] = {0}, S3[4] = {0}, S4[4] = {0};                                                                \
+  long int vmax[8], vmin[8];                                                                                     \
+  long int q;                                                                                                    \
+  long int hist[HL?4:1][256];                                                                                    \
+  ra_tm_clear( &m );                                                                                             \
+  if (HL) memset( hist, 0, sizeof(hist) );                                                                       \
+  for (c=0;c<8;c++) { vmax[c] = -0x7FFFFFFFFFFFFFFFL; vmin[c] = 0x7FFFFFFFFFFFFFFFL; }                           \
+  for ( j=0; j<nSpan; j++ ) {                                                                                    \
+    x = span[j].x; dS = span[j].dS; dC = span[j].dC;                                                             \
+    for ( n=0; n<span[j].n; n++, x+=dS ) {                                                                       \
+      v[0] = x[0];                                                                                               \
+      v[1] = x[dC];                                                                                              \
+      v[2] = x[2*dC];                                                                                            \
+      v[3] = x[3*dC];                                                                                            \
+      v[4] = v[0]*v[0] + v[1]*v[1];                                                                              \
+      v[5] = v[2]*v[2] + v[3]*v[3];                                                                              \
+      if (v[4]>=mev2) { m.clips.x++; }                                                                           \
+      if (v[5]>=mev2) { m.clips.y++; }                                                                           \
+      if (HL)  { RA_K_HIST(x,dC); }                                                                              \
+      if (IQ)  { RA_K_X_ACC(0,3,HI); }                                                                           \
+      if (PWR) { RA_K_X_ACC(4,5,HI); }                                                                           \
+      if (STK) { v[6] = +2*( v[0]*v[2] + v[1]*v[3] ); v[7] = -2*( v[1]*v[2] - v[0]*v[3] ); RA_K_X_ACC(6,7,HI); } \
+      }                                                                                                          \
+    m.n += span[j].n;                                                                                            \
+    }                                                                                                            \
+  for (c=0;c<8;c++) {                                                                                            \
+    ma[c].s1 = s1[c];                                                                                            \
+    if (c<4) {                                                                                                   \
+        ra_i128_set( &(ma[c].s2), s2[c] ); ra_i128_set( &(ma[c].s3), s3[c] ); ra_i128_set( &(ma[c].s4), s4[c] ); \
+      } else {                                                                                                   \
+        ra_i128_set( &(ma[c].s2), S2[c-4] ); ra_i128_set( &(ma[c].s3), S3[c-4] ); ra_i128_set( &(ma[c].s4), S4[c-4] );\
+      }                                                                                                          \
+    if (m.n>0) { ma[c].max = vmax[c]; ma[c].min = vmin[c]; }                                                     \
+    }                                                                                                            \
+  if (HL)  { ra_th_finish( hist, m.n, &(m.clips), h ); }                                                         \
+  ra_kernel_td( &m, IQ*RA_STATS_IQ + PWR*RA_STATS_POWER + STK*RA_STATS_STOKES + HI*RA_STATS_HIGHER, d, clips );  \
+  }
+
+/* one exact kernel for each nonempty combination; e.g. ra_kernel_exact_15, ra_kernel_exact_h15 */
+RA_KERNEL_SET(RA_KERNEL_EXACT,ra_kernel_exact_,0)
+RA_KERNEL_SET(RA_KERNEL_EXACT,ra_kernel_exact_h,1)
+
+ra_kernel_t ra_kernels_exact[2][16] = { RA_KERNEL_TABLE(ra_kernel_exact_), RA_KERNEL_TABLE(ra_kernel_exact_h) }; /* [HL][eStats] */
+
+/*==============================================================*/
+/*=== ra_stats_parse() =========================================*/
+/*==============================================================*/
+/* parses the argument of STATS (e.g. "power,higher") into RA_STATS_* bits; returns -1 on error */
+
+int ra_stats_parse( char *s ) {
+  char *p = s;
+  int n;
+  int eStats = 0;
+
+  while (*p) {
+    n = strcspn(p,",");
+         if ((n==2) && (strncmp(p,"iq",2)==0))     { eStats |= RA_STATS_IQ;     }
+    else if ((n==5) && (strncmp(p,"power",5)==0))  { eStats |= RA_STATS_POWER;  }
+    else if ((n==6) && (strncmp(p,"stokes",6)==0)) { eStats |= RA_STATS_STOKES; }
+    else if ((n==6) && (strncmp(p,"higher",6)==0)) { eStats |= RA_STATS_HIGHER; }
+    else if ((n==3) && (strncmp(p,"all",3)==0))    { eStats |= RA_STATS_ALL;    }
+    else { return -1; }
+    p += n;
+    if (*p==',') p++;
+    }
+
+  return eStats;
+  }
+
+/*==============================================================*/
+/*=== ra_kernel_select() =======================================*/
+/*==============================================================*/
+/* returns the kernel for eStats (RA_STATS_* bits), exact or not, with ADC health or not, and, in *mev2, the clipping threshold for eSource */
+/* returns NULL if there is no such kernel or eSource is unknown */
+
+ra_kernel_t ra_kernel_select(
+                              int eStats,      /* [in] RA_STATS_* bits */
+                              int bExact,      /* [in] 1: exact kernels (EXACT 1) */
+                              int bHealth,     /* [in] 1: also ADC health (TFLAGS b6) */
+                              int eSource,     /* [in] header0->eSource */
+                              long int *mev2   /* [out] (max encodable value)^2 */
+                             ) {
+
+  switch (eSource) {
+    case RA_H_ESOURCE_GUPPI_FILE:
+    case RA_H_ESOURCE_GUPPI_RT:
+      *mev2 = 127*127;
+      break;
+    default:
+      printf("FATAL: ra_kernel_select(): I don't recongnize eSource=%d\n",eSource);
+      return NULL;
+      break;
+    }
+
+  if ( (eStats<1) || (eStats>RA_STATS_ALL) || (ra_kernels[0][eStats]==NULL) ) {
+    printf("FATAL: ra_kernel_select(): STATS %d selects no statistics\n",eStats);
+    return NULL;
+    }
+
+  bHealth = (bHealth!=0);
+  return ( bExact ? ra_kernels_exact[bHealth][eStats] : ra_kernels[bHealth][eStats] );
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_kernels.c: 2026 Oct 19
+// -- kernels with ADC health (eType 8; ra_th_finish()); kernel sets generated by RA_KERNEL_SET()
+// ra_kernels.c: 2026 Oct 19
+// -- exact kernels (EXACT 1; RA_KERNEL_EXACT()), and ra_kernel_td()
+// ra_kernels.c: 2026 Oct 19
+// -- kernels take the window as spans, interleaved or planes
+// ra_kernels.c: 2026 Oct 19
+// -- data are planes (see ra_plan.c)
+// ra_kernels.c: 2026 Oct 19
+// -- initial version
@@ -0,0 +1,203 @@
+/*===============================================================
+ra_lag.c: 2026 Oct 19
+real-time deadline monitor, and graceful degradation when frsc falls behind
+---
+With "LAG_BUDGET <s>" in the job file, ra_lag_check() is called before each T0 window is analyzed, and
+compares the data clock (fStart of the window, from the start of the run) with the wall clock (time since
+the first window).  The lag is how far the wall clock is ahead: how long ago the window's data arrived, for a
+live source, which delivers data in real time (6.25 MS/s per channel for GUPPI).  A lag that keeps growing
+means frsc isn't keeping up, and will eventually lose data.  (A file is read as fast as frsc can go, so its
+lag is negative as long as frsc is faster than real time; a file can stand in for a live source this way.)
+
+When the lag is more than LAG_BUDGET, frsc goes one step down a ladder of degradations, trading statistics
+for speed; when it's less than half of LAG_BUDGET (caught up), one step back up.  Each level is held for at
+least LAG_BUDGET seconds, so that its effect on the lag shows before the next change.  The steps are, in the
+order given by "LAG_LADDER <list>" (default "higher,subsample,channels"):
+  higher     rms, skewness, and kurtosis aren't computed (written as 0), as if STATS didn't include "higher"
+  subsample  only one window in LAG_SUBSAMPLE (default 2) is analyzed; the others produce no reports
+  channels   only the channels in "LAG_PRIORITY <list>" (same syntax as EXCLUDE) are analyzed; the others
+             are written as 0.  Without LAG_PRIORITY, this step is left out.
+While a step is in effect, its bit (RA_H_ERR_LAG_*) is set in err of every eType 1, 7, and 8 report.  Each
+change of level is also recorded in an eType 0 report with bit 5 of err set (RA_H_ERR_LAG) along with the
+bits of the new level, and sInfo like "LAG 2.310 s: level 2 (higher,subsample)".
+With HOP, every hop has to be analyzed for the windows to be right, so LAG_BUDGET is ignored.
+================================================================*/
+
+#define RA_LAG_MAX_STEPS 3
+#define RA_LAG_SUBSAMPLE_DEFAULT 2
+#define RA_LAG_LADDER_DEFAULT "higher,subsample,channels"
+
+/* skip the k'th channel of the plan? */
+#define RA_LAG_SKIP_CH(LAG,K) ( (LAG) && ((LAG)->err & RA_H_ERR_LAG_CHANNELS) && (LAG)->bLow[K] )
+
+struct ra_lag_struct {
+  double budget;                       /* [s] LAG_BUDGET */
+  int nSteps;                          /* steps in the ladder */
+  long int step[RA_LAG_MAX_STEPS];     /* RA_H_ERR_LAG_* bit of each, in order */
+  int level;                           /* how many steps are in effect (0 = none) */
+  long int err;                        /* their bits */
+  long int nSub;                       /* LAG_SUBSAMPLE */
+  ra_kernel_t kernelFull;              /* the plan's kernel, per STATS */
+  ra_kernel_t kernelLow;               /* the same, without "higher" */
+  char bLow[RA_MAX_CH_DIV64*64];       /* [k] 1: k'th channel of the plan isn't in LAG_PRIORITY */
+  long int iWin;                       /* windows seen */
+  long int t0;                         /* [ns] ra_prof_now() at the first window */
+  double fstart0;                      /* [s] fStart of the first window */
+  long int tChange;                    /* [ns] when the level last changed */
+  double lag;                          /* [s] as of the last window */
+  double lagMax;                       /* [s] */
+  long int nWinAt[RA_LAG_MAX_STEPS+1]; /* windows seen at each level */
+  };
+
+/*==============================================================*/
+/*=== ra_lag_names() ===========================================*/
+/*==============================================================*/
+/* names of the steps in err, e.g. "higher,subsample", into s */
+
+void ra_lag_names( long int err, char *s ) {
+  s[0] = '\0';
+  if (err & RA_H_ERR_LAG_HIGHER)    strcat(s,"higher,");
+  if (err & RA_H_ERR_LAG_SUBSAMPLE) strcat(s,"subsample,");
+  if (err & RA_H_ERR_LAG_CHANNELS)  strcat(s,"channels,");
+  if (s[0]) { s[strlen(s)-1] = '\0'; } else { strcpy(s,"none"); }
+  }
+
+/*==============================================================*/
+/*=== ra_lag_init() ============================================*/
+/*==============================================================*/
+/* returns 0 if OK, 1 if the ladder can't be parsed */
+
+int ra_lag_init(
+                 struct ra_lag_struct *lag,         /* [out] */
+                 struct ra_plan_struct *plan,       /* [in] kernel, eStats, channels */
+                 struct ra_header_struct *header0,  /* [in] tflags, eSource */
+                 int bExact,                        /* [in] EXACT */
+                 double budget,                     /* [in] [s] LAG_BUDGET */
+                 char *ladder,                      /* [in] LAG_LADDER; empty = RA_LAG_LADDER_DEFAULT */
+                 long int nSub,                     /* [in] LAG_SUBSAMPLE; 0 = RA_LAG_SUBSAMPLE_DEFAULT */
+                 unsigned long int *bChPriority     /* [in] LAG_PRIORITY channel bits; NULL if not given */
+                ) {
+  char s[RA_MAX_LINE_LENGTH];
+  char names[64];
+  char *p;
+  long int step, mev2, k;
+  int n, j;
+
+  memset( lag, 0, sizeof(struct ra_lag_struct) );
+  lag->budget = budget;
+  lag->nSub = (nSub>1) ? nSub : RA_LAG_SUBSAMPLE_DEFAULT;
+  lag->kernelFull = plan->kernel;
+  lag->kernelLow  = NULL;
+  if (plan->eStats & ~RA_STATS_HIGHER & RA_STATS_ALL) {
+    lag->kernelLow = ra_kernel_select( plan->eStats & ~RA_STATS_HIGHER, bExact, header0->tflags & RA_H_TFLAGS_TH, header0->eSource, &mev2 );
+    }
+  for (k=0;k<plan->nCh;k++) lag->bLow[k] = ( bChPriority && !ra_isChBitSet(bChPriority,plan->ch[k]) );
+
+  strcpy( s, (ladder && ladder[0]) ? ladder : RA_LAG_LADDER_DEFAULT );
+  p = s;
+  while (*p) {
+    n = strcspn(p,",");
+         if ((n==6) && (strncmp(p,"higher",6)==0))    { step = RA_H_ERR_LAG_HIGHER;    }
+    else if ((n==9) && (strncmp(p,"subsample",9)==0)) { step = RA_H_ERR_LAG_SUBSAMPLE; }
+    else if ((n==8) && (strncmp(p,"channels",8)==0))  { step = RA_H_ERR_LAG_CHANNELS;  }
+    else {
+      printf("FATAL: ra_lag_init(): LAG_LADDER '%s' not recognized\n",ladder);
+      return 1;
+      }
+    p += n;
+    if (*p==',') p++;
+
+    /* leave out steps that wouldn't do anything */
+    if ( (step==RA_H_ERR_LAG_HIGHER) && ( !(plan->eStats & RA_STATS_HIGHER) || (lag->kernelLow==NULL) ) ) continue;
+    if ( (step==RA_H_ERR_LAG_CHANNELS) && (bChPriority==NULL) ) continue;
+    for (j=0;j<lag->nSteps;j++) if (lag->step[j]==step) break;
+    if (j<lag->nSteps) continue;
+    lag->step[lag->nSteps++] = step;
+    }
+
+  printf("ra_lag_init(): LAG_BUDGET %g s; ladder:",budget);
+  for (j=0;j<lag->nSteps;j++) { ra_lag_names( lag->step[j], names ); printf(" %s",names); }
+  printf("%s; LAG_SUBSAMPLE %ld\n",(lag->nSteps>0)?"":" (empty)",lag->nSub);
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_lag_check() ===========================================*/
+/*==============================================================*/
+/* called for each window, before it's analyzed.  Updates the lag and, if called for, the level (and so */
+/* plan->kernel); if the level changed, fills header with an eType 0 report saying so, and returns 1; */
+/* otherwise returns 0 */
+
+int ra_lag_check(
+                  struct ra_lag_struct *lag,         /* [in/out] */
+                  struct ra_plan_struct *plan,       /* [in/out] kernel */
+                  struct ra_header_struct *header0,  /* [in/out] prototype report header; iSeqNo is incremented */
+                  double fstart,                     /* [in] [s] fStart of the window */
+                  struct ra_header_struct *header    /* [out] */
+                 ) {
+  long int t = ra_prof_now();
+  double held;
+  char names[64];
+  int level, j;
+
+  if (lag->iWin==0) {
+    lag->t0      = t;
+    lag->fstart0 = fstart;
+    lag->tChange = t;
+    }
+  lag->iWin++;
+  lag->nWinAt[lag->level]++;
+  lag->lag = (t - lag->t0)*1e-9 - (fstart - lag->fstart0);
+  if (lag->lag > lag->lagMax) lag->lagMax = lag->lag;
+
+  held = (t - lag->tChange)*1e-9;
+  level = lag->level;
+  if      ( (lag->lag > lag->budget)   && (level < lag->nSteps) && (held >= lag->budget) ) level++;
+  else if ( (lag->lag < lag->budget/2) && (level > 0)           && (held >= lag->budget) ) level--;
+  if (level==lag->level) return 0;
+
+  lag->level = level;
+  lag->tChange = t;
+  lag->err = 0;
+  for (j=0;j<level;j++) lag->err |= lag->step[j];
+  plan->kernel = (lag->err & RA_H_ERR_LAG_HIGHER) ? lag->kernelLow : lag->kernelFull;
+
+  (header0->iSeqNo)++;
+  memcpy( header, header0, sizeof(struct ra_header_struct) );
+  header->eType  = RA_H_ETYPE_NULL;
+  header->err    = RA_H_ERR_LAG | lag->err;
+  header->fStart = fstart;
+  ra_lag_names( lag->err, names );
+  memset( header->sInfo, 0, RA_MAX_SINFO_LENGTH );
+  snprintf( header->sInfo, RA_MAX_SINFO_LENGTH, "LAG %.3f s: level %d (%s)", lag->lag, level, names );
+  printf("ra_lag_check(): %s\n",header->sInfo);
+
+  return 1;
+  }
+
+/*==============================================================*/
+/*=== ra_lag_skip() ============================================*/
+/*==============================================================*/
+/* 1 if the window just checked isn't to be analyzed (LAG_SUBSAMPLE), 0 if it is */
+
+int ra_lag_skip( struct ra_lag_struct *lag ) {
+  return ( (lag->err & RA_H_ERR_LAG_SUBSAMPLE) && ((lag->iWin-1) % lag->nSub) );
+  }
+
+/*==============================================================*/
+/*=== ra_lag_print() ===========================================*/
+/*==============================================================*/
+/* summary, to stdout */
+
+void ra_lag_print( struct ra_lag_struct *lag ) {
+  int j;
+  printf("Lag: max %.3f s, last %.3f s (LAG_BUDGET %g s); windows at each level:",lag->lagMax,lag->lag,lag->budget);
+  for (j=0;j<=lag->nSteps;j++) printf(" %ld",lag->nWinAt[j]);
+  printf("\n");
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_lag.c: 2026 Oct 19
+// -- initial version
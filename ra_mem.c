@@ -0,0 +1,160 @@
+/*===============================================================
+ra_mem.c: 2026 Oct 19
+RAM budget planner, and bounded-memory streaming (MAX_MEMORY)
+---
+Before the main loop, ra_mem_plan() adds up the memory frsc will allocate for the job at hand, given
+the GUPPI header and the channel plan, and prints it:
+  block     the GUPPI data block, read whole (RG_BLK_SIZE)
+  T0        the T0 buffer, blk0: nT0 samples of each analyzed channel (see ra_plan.c)
+  slide     with HOP, the moments of each hop of the window, for each analyzed channel (see ra_slide.c)
+  scratch   the bodies of eType 7 and 8 reports, and per-window scratch (see ra_arena.c)
+  output    buffers for OUTFORMAT, STREAM, SHM, and SUPPRESS (see ra_out_mem())
+With "MAX_MEMORY <MB>" in the job file, if that's more than <MB>, frsc streams instead, with a working
+set that depends on neither T0 nor the size of the block:
+  pieces    The block is read a piece at a time: nPiece samples of each analyzed channel (channels not
+            analyzed aren't read at all; see ra_mem_read()), laid out as in ra_plan_pieces().  ra_swallow()
+            takes each piece as if it were a short block, so windows that cross pieces are handled as
+            windows that cross blocks always have been.
+  tiles     If the T0 buffer is still too big, T0 windows are analyzed in nTiles tiles of nTile samples.
+            The exact moment sums of the tiles (ra_moments.c) are merged into those of the window (ra_slide.c,
+            with bTumble), from which the statistics are computed; so T0 can be any length.  As with
+            HOP, T0 is rounded to a whole number of tiles, statistics are computed from exact sums (so
+            they're the same, to the bit, as with EXACT 1 and no MAX_MEMORY; fStart, which is summed
+            per tile, may differ in the last digit), eType 7 and 8 reports are per tile, and LAG_BUDGET
+            is ignored.
+A piece and a tile get the same share of what's left of the budget.  With HOP, the hop is already a tile:
+only pieces are used.  If the budget can't be met, frsc says so and exits, before reading any data.
+================================================================*/
+
+#define RA_MEM_MB (1024L*1024L)
+
+struct ra_mem_struct {
+  long int budget;         /* [bytes] MAX_MEMORY; 0 = none */
+  long int nBlk;           /* [bytes] block, or piece */
+  long int nT0buf;         /* [bytes] T0 buffer */
+  long int nSlide;         /* [bytes] ra_slide.c */
+  long int nScratch;       /* [bytes] ra_work_size() */
+  long int nOut;           /* [bytes] ra_out_mem() */
+  long int nTotal;         /* [bytes] sum of the above */
+  long int nPiece;         /* samples per channel per piece; 0 = blocks are read whole */
+  long int nTiles;         /* tiles per T0 window; 0 = windows aren't tiled */
+  long int nTile;          /* samples per channel per tile */
+  };
+
+/*==============================================================*/
+/*=== ra_mem_print() ===========================================*/
+/*==============================================================*/
+
+void ra_mem_print( struct ra_mem_struct *mem, char *s ) {
+  printf("%s: block %.1f MB, T0 buffer %.1f MB, slide %.1f MB, scratch %.1f MB, output %.1f MB; total %.1f MB",s,
+         (double) mem->nBlk/RA_MEM_MB, (double) mem->nT0buf/RA_MEM_MB, (double) mem->nSlide/RA_MEM_MB,
+         (double) mem->nScratch/RA_MEM_MB, (double) mem->nOut/RA_MEM_MB, (double) mem->nTotal/RA_MEM_MB);
+  if (mem->budget>0) printf(" (MAX_MEMORY %.1f MB)",(double) mem->budget/RA_MEM_MB);
+  printf("\n");
+  }
+
+/*==============================================================*/
+/*=== ra_mem_plan() ============================================*/
+/*==============================================================*/
+/* returns 0 if OK (mem->nPiece and mem->nTiles say what to do), 1 if MAX_MEMORY can't be met */
+
+int ra_mem_plan(
+                 struct ra_mem_struct *mem,   /* [out] */
+                 double maxMB,                /* [in] [MB] MAX_MEMORY; 0 = no limit */
+                 long int nCh,                /* [in] analyzed channels (plan) */
+                 long int nAvail,             /* [in] samples per channel in a block (ra_swallow_avail()) */
+                 long int nT0,                /* [in] samples per channel in the T0 buffer */
+                 long int nWin,               /* [in] hops per window, if HOP; else 0 */
+                 long int nOut                /* [in] [bytes] ra_out_mem() */
+                ) {
+  long int perSample = nCh*RG_NPOL; /* [bytes] per sample, all analyzed channels */
+  long int nLeft, n, nNeed;
+
+  memset( mem, 0, sizeof(struct ra_mem_struct) );
+  mem->budget   = maxMB*RA_MEM_MB;
+  mem->nBlk     = RG_BLK_SIZE;
+  mem->nT0buf   = nT0*perSample;
+  mem->nSlide   = (nWin>1) ? (nWin+1)*nCh*sizeof(struct MAPstruct) + nWin*sizeof(double) : 0;
+  mem->nScratch = ra_work_size();
+  mem->nOut     = nOut;
+  mem->nTotal   = mem->nBlk + mem->nT0buf + mem->nSlide + mem->nScratch + mem->nOut;
+  ra_mem_print( mem, "ra_mem_plan()" );
+  if ( (mem->budget<=0) || (mem->nTotal<=mem->budget) ) return 0;
+
+  /* what's left for the piece, and the T0 buffer or tile */
+  if (nWin<=1) mem->nSlide = nCh*sizeof(struct MAPstruct) + sizeof(double); /* tiles, if any, tumble */
+  nLeft = mem->budget - mem->nSlide - mem->nScratch - mem->nOut;
+
+  if (nWin>1) { /* HOP: the T0 buffer is one hop; the piece gets the rest */
+      mem->nPiece = (nLeft - mem->nT0buf)/perSample;
+    } else {
+      n = nLeft/(2*perSample);
+      if (n<1) {    /* nothing fits */
+          mem->nPiece = 0;
+        } else if (nT0<=n) { /* T0 fits; the piece gets the rest */
+          mem->nPiece = (nLeft - mem->nT0buf)/perSample;
+        } else {    /* tiles; preferably a whole number of them in T0, so that T0 needn't change */
+          nNeed = (nT0+n-1)/n;
+          for (mem->nTiles=nNeed; (mem->nTiles<=2*nNeed) && (nT0%mem->nTiles); mem->nTiles++);
+          if (nT0%mem->nTiles) mem->nTiles = nNeed;
+          mem->nTile = nT0/mem->nTiles;
+          mem->nT0buf = mem->nTile*perSample;
+          mem->nPiece = n;
+        }
+    }
+  if (mem->nPiece>nAvail) mem->nPiece = nAvail;
+  if ( (mem->nPiece<1) || ( mem->nTiles && (mem->nTile<1) ) ) {
+    printf("FATAL: ra_mem_plan(): MAX_MEMORY %.1f MB is too small; this job needs at least %.1f MB\n",
+           maxMB, (double) (mem->budget - nLeft + ((nWin>1) ? mem->nT0buf+perSample : 2*perSample))/RA_MEM_MB);
+    return 1;
+    }
+  mem->nBlk   = mem->nPiece*perSample;
+  mem->nTotal = mem->nBlk + mem->nT0buf + mem->nSlide + mem->nScratch + mem->nOut;
+
+  printf("ra_mem_plan(): reading blocks in pieces of %ld samples/channel",mem->nPiece);
+  if (mem->nTiles) printf("; T0 windows in %ld tiles of %ld samples/channel",mem->nTiles,mem->nTile);
+  printf("\n");
+  ra_mem_print( mem, "ra_mem_plan()" );
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_mem_arena() ===========================================*/
+/*==============================================================*/
+/* [bytes] of arena for all of the above but output (see ra_arena.c); the block (or piece), T0 buffer, */
+/* and the three slices of ra_slide_init() are each rounded up to RA_ARENA_ALIGN */
+
+long int ra_mem_arena( struct ra_mem_struct *mem ) {
+  return mem->nBlk + mem->nT0buf + mem->nSlide + mem->nScratch + 5*RA_ARENA_ALIGN;
+  }
+
+/*==============================================================*/
+/*=== ra_mem_read() ============================================*/
+/*==============================================================*/
+/* reads samples n0..n0+n-1 of each analyzed channel of the block beginning at pos0 into piece, laid out */
+/* per ra_plan_pieces(); returns the number of bytes read */
+
+long int ra_mem_read(
+                      FILE *fp,                     /* [in] GUPPI raw data file */
+                      long int pos0,                /* [in] ftell() at the start of the block's data */
+                      struct ra_plan_struct *plan,  /* [in] ch[], nPiece */
+                      int obsnchan,                 /* [in] OBSNCHAN */
+                      long int n0,                  /* [in] */
+                      long int n,                   /* [in] <= plan->nPiece */
+                      signed char *piece            /* [out] */
+                     ) {
+  long int k, nRead = 0;
+  for (k=0;k<plan->nCh;k++) {
+    fseek( fp, pos0 + (plan->ch[k]-1)*(RG_BLK_SIZE/obsnchan) + n0*RG_NPOL, SEEK_SET );
+    nRead += fread( &(piece[plan->offBlk[k]]), 1, n*RG_NPOL, fp );
+    }
+  return nRead;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_mem.c: 2026 Oct 19
+// -- ra_mem_arena(); scratch is ra_work_size() (ra_arena.c)
+// ra_mem.c: 2026 Oct 19
+// -- initial version
@@ -0,0 +1,241 @@
+/*===============================================================
+ra_moments.c: 2026 Oct 19
+exact, mergeable moment accumulators (eType 7 reports); see ra_format.c
+---
+Used by ra_analyze.c (to fill eType 7 reports) and frsc_read.c (to merge them into longer intervals).
+Samples are integers, so sums of their powers are kept as exact integers: 64 bits where that can't
+overflow, 128 bits (struct ra_int128 in reports, __int128 in arithmetic) where it might.  Merging is
+then exact, and the only rounding is in ra_tm_finalize(), which is done in long double.
+================================================================*/
+
+
+/*==============================================================*/
+/*=== ra_i128_get(), ra_i128_set() =============================*/
+/*==============================================================*/
+
+__int128 ra_i128_get( struct ra_int128 *a ) {
+  return ( ((__int128) a->hi) << 64 ) | ((__int128) a->lo);
+  }
+
+void ra_i128_set( struct ra_int128 *a, __int128 x ) {
+  a->lo = (unsigned long) x;
+  a->hi = (long) (x >> 64);
+  }
+
+/*==============================================================*/
+/*=== ra_tm_nch() ==============================================*/
+/*==============================================================*/
+/* number of channels in an eType 7 report with this header; i.e., channels not flagged in bChIn[] */
+
+long int ra_tm_nch( struct ra_header_struct *header ) {
+  long int l;
+  long int n = 0;
+  for (l=1;l<=header->nCh;l++) { /* note..starting from 1 here! */
+    if (!ra_isChBitSet(header->bChIn,l)) n++;
+    }
+  return n;
+  }
+
+/*==============================================================*/
+/*=== ra_tm_find() =============================================*/
+/*==============================================================*/
+/* position (0-based) of channel ch in tmc[] of an eType 7 report with this header, or -1 if not there */
+
+long int ra_tm_find( struct ra_header_struct *header, long int ch ) {
+  long int l;
+  long int k = 0;
+  if ( (ch<1) || (ch>header->nCh) || ra_isChBitSet(header->bChIn,ch) ) return -1;
+  for (l=1;l<ch;l++) {
+    if (!ra_isChBitSet(header->bChIn,l)) k++;
+    }
+  return k;
+  }
+
+/*==============================================================*/
+/*=== ra_tm_clear() ============================================*/
+/*==============================================================*/
+/* empty accumulator */
+
+void ra_tm_clear( struct MAPstruct *m ) {
+  struct MAstruct *ma = &(m->xi); /* the 8 struct MAstruct's, as an array */
+  int c;
+  memset( m, 0, sizeof(struct MAPstruct) );
+  for (c=0;c<8;c++) {
+    ma[c].max = -FLT_MAX;
+    ma[c].min = +FLT_MAX;
+    }
+  }
+
+/*==============================================================*/
+/*=== ra_tm_channel() ==========================================*/
+/*==============================================================*/
+/* accumulates the samples of one channel into m; and, if hist isn't NULL, counts each value of xi, xq, yi, yq */
+/* (as unsigned char) in hist[0..3][] (see ra_th_finish()) */
+
+void ra_tm_channel(
+                    signed char *x,          /* [in] samples; x[n*dS], x[n*dS+dC], x[n*dS+2*dC], x[n*dS+3*dC] = xi,xq,yi,yq of n'th sample */
+                    long int nSamples,       /* [in] */
+                    long int dS,             /* [in] bytes from one sample to the next */
+                    long int dC,             /* [in] bytes from xi to xq, xq to yi, yi to yq */
+                    long int mev2,           /* [in] |x|^2 >= this is counted as a clip */
+                    struct MAPstruct *m,     /* [in/out] */
+                    long int (*hist)[256]    /* [in/out] [4][256], or NULL */
+                    ) {
+
+  struct MAstruct *ma = &(m->xi); /* the 8 struct MAstruct's, as an array */
+  long int v[8];                  /* xi, xq, yi, yq, xm2, ym2, u, v of a sample */
+  long int s1[8] = {0}, s2[4] = {0}, s3[4] = {0}, s4[4] = {0}; /* exact in 64 bits for xi..yq (|x|<=128) */
+  __int128 S2[4] = {0}, S3[4] = {0}, S4[4] = {0};           /* xm2..v need 128 bits */
+  long int vmax[8], vmin[8];
+  long int q;
+  long int n;
+  int c;
+
+  for (c=0;c<8;c++) { vmax[c] = -0x7FFFFFFFFFFFFFFFL; vmin[c] = 0x7FFFFFFFFFFFFFFFL; }
+
+  for (n=0;n<nSamples;n++,x+=dS) {
+    v[0] = x[0];
+    v[1] = x[dC];
+    v[2] = x[2*dC];
+    v[3] = x[3*dC];
+    v[4] = v[0]*v[0] + v[1]*v[1];
+    v[5] = v[2]*v[2] + v[3]*v[3];
+    v[6] = +2*( v[0]*v[2] + v[1]*v[3] );
+    v[7] = -2*( v[1]*v[2] - v[0]*v[3] );
+    if (v[4]>=mev2) m->clips.x++;
+    if (v[5]>=mev2) m->clips.y++;
+    if (hist) {
+      hist[0][(unsigned char) x[0]]++;    hist[1][(unsigned char) x[dC]]++;
+      hist[2][(unsigned char) x[2*dC]]++; hist[3][(unsigned char) x[3*dC]]++;
+      }
+    for (c=0;c<4;c++) {
+      q = v[c]*v[c];
+      s1[c] += v[c]; s2[c] += q; s3[c] += q*v[c]; s4[c] += q*q;
+      }
+    for (c=4;c<8;c++) {
+      q = v[c]*v[c];
+      s1[c] += v[c]; S2[c-4] += q; S3[c-4] += ((__int128) q)*v[c]; S4[c-4] += ((__int128) q)*q;
+      }
+    for (c=0;c<8;c++) {
+      if (v[c]>vmax[c]) vmax[c] = v[c];
+      if (v[c]<vmin[c]) vmin[c] = v[c];
+      }
+    }
+
+  m->n += nSamples;
+  for (c=0;c<8;c++) {
+    ma[c].s1 += s1[c];
+    if (c<4) {
+        ra_i128_set( &(ma[c].s2), ra_i128_get(&(ma[c].s2)) + s2[c] );
+        ra_i128_set( &(ma[c].s3), ra_i128_get(&(ma[c].s3)) + s3[c] );
+        ra_i128_set( &(ma[c].s4), ra_i128_get(&(ma[c].s4)) + s4[c] );
+      } else {
+        ra_i128_set( &(ma[c].s2), ra_i128_get(&(ma[c].s2)) + S2[c-4] );
+        ra_i128_set( &(ma[c].s3), ra_i128_get(&(ma[c].s3)) + S3[c-4] );
+        ra_i128_set( &(ma[c].s4), ra_i128_get(&(ma[c].s4)) + S4[c-4] );
+      }
+    if (nSamples>0) {
+      if (vmax[c]>ma[c].max) ma[c].max = vmax[c];
+      if (vmin[c]<ma[c].min) ma[c].min = vmin[c];
+      }
+    }
+
+  }
+
+/*==============================================================*/
+/*=== ra_tm_merge() ============================================*/
+/*==============================================================*/
+/* a = a combined with b.  Exact. */
+
+void ra_tm_merge( struct MAPstruct *a, struct MAPstruct *b ) {
+  struct MAstruct *ma = &(a->xi);
+  struct MAstruct *mb = &(b->xi);
+  int c;
+  a->n       += b->n;
+  a->clips.x += b->clips.x;
+  a->clips.y += b->clips.y;
+  for (c=0;c<8;c++) {
+    ma[c].s1 += mb[c].s1;
+    ra_i128_set( &(ma[c].s2), ra_i128_get(&(ma[c].s2)) + ra_i128_get(&(mb[c].s2)) );
+    ra_i128_set( &(ma[c].s3), ra_i128_get(&(ma[c].s3)) + ra_i128_get(&(mb[c].s3)) );
+    ra_i128_set( &(ma[c].s4), ra_i128_get(&(ma[c].s4)) + ra_i128_get(&(mb[c].s4)) );
+    if (mb[c].max>ma[c].max) ma[c].max = mb[c].max;
+    if (mb[c].min<ma[c].min) ma[c].min = mb[c].min;
+    }
+  }
+
+/*==============================================================*/
+/*=== ra_tm_subtract() =========================================*/
+/*==============================================================*/
+/* a = a with b taken out, where b was merged into a earlier.  Exact, except that max and min are */
+/* left alone (they can't be undone); see ra_slide.c */
+
+void ra_tm_subtract( struct MAPstruct *a, struct MAPstruct *b ) {
+  struct MAstruct *ma = &(a->xi);
+  struct MAstruct *mb = &(b->xi);
+  int c;
+  a->n       -= b->n;
+  a->clips.x -= b->clips.x;
+  a->clips.y -= b->clips.y;
+  for (c=0;c<8;c++) {
+    ma[c].s1 -= mb[c].s1;
+    ra_i128_set( &(ma[c].s2), ra_i128_get(&(ma[c].s2)) - ra_i128_get(&(mb[c].s2)) );
+    ra_i128_set( &(ma[c].s3), ra_i128_get(&(ma[c].s3)) - ra_i128_get(&(mb[c].s3)) );
+    ra_i128_set( &(ma[c].s4), ra_i128_get(&(ma[c].s4)) - ra_i128_get(&(mb[c].s4)) );
+    }
+  }
+
+/*==============================================================*/
+/*=== ra_tm_finalize() =========================================*/
+/*==============================================================*/
+/* computes the statistics of struct DAPstruct (as in eType 1 reports) from accumulator state. */
+/* Note max is the true maximum of each quantity (for v, eType 1 reports give -2*max(xq*yi-xi*yq) instead). */
+
+void ra_tm_finalize(
+                     struct MAPstruct *m,  /* [in] */
+                     struct DAPstruct *d,  /* [out] */
+                     float *mins           /* [out] minimum of each of the 8 quantities; may be NULL */
+                     ) {
+
+  struct MAstruct *ma = &(m->xi);
+  struct DAstruct *da = &(d->xi); /* the 8 struct DAstruct's, as an array */
+  long double n = m->n;
+  long double mean, e2, e3, e4; /* mean, and means of x^2, x^3, x^4 */
+  long double m2, m3, m4;       /* central moments */
+  int c;
+
+  memset( d, 0, sizeof(struct DAPstruct) );
+  if (mins!=NULL) { for (c=0;c<8;c++) mins[c] = 0; }
+  if (m->n<=0) return;
+
+  for (c=0;c<8;c++) {
+    mean = ma[c].s1 / n;
+    e2   = ra_i128_get(&(ma[c].s2)) / n;
+    e3   = ra_i128_get(&(ma[c].s3)) / n;
+    e4   = ra_i128_get(&(ma[c].s4)) / n;
+    m2   = e2 - mean*mean;
+    m3   = e3 - 3*mean*e2 + 2*mean*mean*mean;
+    m4   = e4 - 4*mean*e3 + 6*mean*mean*e2 - 3*mean*mean*mean*mean;
+    da[c].mean = mean;
+    da[c].max  = ma[c].max;
+    da[c].rms  = sqrtl(m2);
+    da[c].s    = m3 / ( m2*sqrtl(m2) );
+    da[c].k    = m4 / ( m2*m2 ) - 3.0;
+    if (mins!=NULL) { mins[c] = ma[c].min; }
+    }
+
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_moments.c: 2026 Oct 19
+// -- ra_tm_channel() optionally counts sample values (for eType 8 reports)
+// ra_moments.c: 2026 Oct 19
+// -- added ra_tm_subtract()
+// ra_moments.c: 2026 Oct 19
+// -- ra_tm_channel() reads interleaved samples or planes (dS, dC)
+// ra_moments.c: 2026 Oct 19
+// -- ra_tm_channel() reads planes (see ra_plan.c)
+// ra_moments.c: 2026 Oct 19
+// -- initial version
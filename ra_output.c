@@ -0,0 +1,370 @@
+/*===============================================================
+ra_output.c: 2026 Oct 19
+where reports go
+---
+All reports pass through ra_out_write().  Depending on OUTFORMAT in the job file, they are either written
+to OUTFILE as-is (one after another, as frsc always has), collected into frames which are compressed
+and written as a unit (see ra_compress.c), or rearranged into a columnar store (see ra_columns.c).
+Independently of OUTFORMAT, reports can also be published to subscribers over a socket (see ra_stream.c),
+and to consumers on the same host through shared memory (see ra_shm.c).  eType 1 reports which aren't
+much different from the last one can be suppressed (see ra_suppress.c); this applies to all of the above.
+================================================================*/
+
+#define RA_OUTFORMAT_PLAIN  0 /* reports written one after another, uncompressed */
+#define RA_OUTFORMAT_FRAMED 1 /* reports written in compressed frames; see ra_compress.c */
+#define RA_OUTFORMAT_COLUMNS 2 /* eType 1,2 statistics written column-wise; see ra_columns.c */
+
+struct ra_out_struct {
+  int eFormat;                          /* RA_OUTFORMAT_... */
+  FILE *fp;                             /* output file */
+  long int offset;                      /* [bytes] written to fp so far */
+  long int nBytesIn;                    /* [bytes] of reports submitted so far (before compression) */
+  int bMute;                            /* 1: reports are dropped (a worker's warm-up; see ra_par.c) */
+
+  /* used only for eFormat = RA_OUTFORMAT_FRAMED */
+  unsigned char *plain;                 /* reports waiting to be compressed */
+  unsigned char *raw;                   /* scratch for ra_frame_encode() */
+  unsigned char *comp;                  /* compressed frame */
+  long int nPlain;                      /* [bytes] used in plain */
+  long int nPlainMax;                   /* [bytes] allocated for plain, raw; comp is ra_lz_bound() of this */
+  int nReports;                         /* number of reports in plain */
+  struct ra_frame_index_struct *index;  /* one entry per frame written */
+  long int nFrames;
+  long int nFramesMax;
+
+  /* used only for eFormat = RA_OUTFORMAT_COLUMNS */
+  struct ra_col_struct col;             /* columnar store */
+  int nColChunk;                        /* reports per chunk */
+
+  /* used only if STREAM is given in the job file; see ra_out_stream() */
+  struct ra_stream_struct stream;       /* subscribers */
+
+  /* used only if SHM is given in the job file; see ra_out_shm() */
+  struct ra_shm_struct shm;             /* shared memory ring */
+
+  /* used only if SUPPRESS is given in the job file; see ra_out_suppress() */
+  struct ra_supp_struct supp;           /* change-triggered suppression */
+  };
+
+/*==============================================================*/
+/*=== ra_out_open() ============================================*/
+/*==============================================================*/
+/* returns 0 if OK, 1 otherwise */
+
+int ra_out_open(
+                 struct ra_out_struct *out, /* [out] */
+                 char *outfile,             /* [in] name of output file; existing file is overwritten */
+                 int eFormat,               /* [in] RA_OUTFORMAT_... */
+                 int nColChunk,             /* [in] reports per chunk; used only for RA_OUTFORMAT_COLUMNS */
+                 long int offset            /* [in] -1: new file; else the existing file is truncated to this many */
+                                            /*      bytes, and written after that (resuming; see ra_ckpt.c) */
+                 ) {
+
+  memset(out,0,sizeof(struct ra_out_struct));
+  out->eFormat = eFormat;
+  out->nColChunk = nColChunk;
+
+  if ( (eFormat!=RA_OUTFORMAT_PLAIN) && (eFormat!=RA_OUTFORMAT_FRAMED) && (eFormat!=RA_OUTFORMAT_COLUMNS) ) {
+    printf("FATAL: ra_out_open(): OUTFORMAT %d not recognized\n",eFormat);
+    return 1;
+    }
+
+  if (!(out->fp = fopen(outfile,(offset<0)?"wb":"r+b"))) {
+    printf("FATAL: ra_out_open(): couldn't open '%s'\n",outfile);
+    return 1;
+    }
+  if ( (offset>=0) && ( ftruncate( fileno(out->fp), offset ) || fseek( out->fp, offset, SEEK_SET ) ) ) {
+    printf("FATAL: ra_out_open(): couldn't truncate '%s' to %ld bytes\n",outfile,offset);
+    return 1;
+    }
+
+  if (eFormat==RA_OUTFORMAT_FRAMED) {
+    out->nPlainMax = RA_FRAME_MAX_REPORTS * ( sizeof(struct ra_header_struct) + sizeof(struct ra_td) );
+    out->nFramesMax = 1024;
+    out->plain = malloc( out->nPlainMax );
+    out->raw   = malloc( out->nPlainMax );
+    out->comp  = malloc( ra_lz_bound(out->nPlainMax) );
+    out->index = malloc( out->nFramesMax * sizeof(struct ra_frame_index_struct) );
+    if ( (out->plain==NULL) || (out->raw==NULL) || (out->comp==NULL) || (out->index==NULL) ) {
+      printf("FATAL: ra_out_open(): malloc() of frame buffers failed\n");
+      return 1;
+      }
+    }
+
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_out_stream() ==========================================*/
+/*==============================================================*/
+/* in addition to the file, publish reports on a socket.  Call after ra_out_open().  returns 0 if OK, 1 otherwise */
+
+int ra_out_stream(
+                   struct ra_out_struct *out, /* [in/out] */
+                   char *addr,                /* [in] see ra_stream_open() */
+                   long int nQueueMax,        /* [in] [bytes] per-subscriber queue limit */
+                   int ePolicy                /* [in] RA_STREAM_POLICY_... */
+                   ) {
+  return ra_stream_open( &(out->stream), addr, nQueueMax, ePolicy );
+  }
+
+/*==============================================================*/
+/*=== ra_out_shm() =============================================*/
+/*==============================================================*/
+/* in addition to the file, publish reports in shared memory.  Call after ra_out_open().  returns 0 if OK, 1 otherwise */
+
+int ra_out_shm(
+                struct ra_out_struct *out, /* [in/out] */
+                char *name,                /* [in] see ra_shm_create() */
+                long int size              /* [in] [bytes] of ring */
+                ) {
+  return ra_shm_create( &(out->shm), name, size );
+  }
+
+/*==============================================================*/
+/*=== ra_out_suppress() ========================================*/
+/*==============================================================*/
+/* write eType 1 reports only when they change; see ra_suppress.c.  Call after ra_out_open().  returns 0 if OK, 1 otherwise */
+
+int ra_out_suppress(
+                     struct ra_out_struct *out, /* [in/out] */
+                     float rPower,              /* [in] relative change in power that triggers a report; 0 = don't test */
+                     float dKurt,               /* [in] change in kurtosis that triggers a report; 0 = don't test */
+                     long int dClips,           /* [in] change in clip count that triggers a report; 0 = don't test */
+                     double heartbeat           /* [in] [s] max time between reports */
+                     ) {
+  return ra_supp_init( &(out->supp), rPower, dKurt, dClips, heartbeat );
+  }
+
+/*==============================================================*/
+/*=== ra_out_flush_frame() =====================================*/
+/*==============================================================*/
+/* compresses and writes the reports waiting in out->plain.  returns 0 if OK, 1 otherwise */
+
+int ra_out_flush_frame( struct ra_out_struct *out ) {
+
+  struct ra_frame_struct frame;
+  struct ra_header_struct *h;
+
+  if (out->nReports==0) return 0;
+
+  h = (struct ra_header_struct *) out->plain;
+  frame.magic    = RA_FRAME_MAGIC;
+  frame.nReports = out->nReports;
+  frame.nRaw     = out->nPlain;
+  frame.iSeqNo   = h->iSeqNo;
+  frame.fStart   = h->fStart;
+  frame.nComp    = ra_frame_encode( out->plain, out->nPlain, out->nReports, out->raw, out->comp );
+  if (frame.nComp<0) {
+    printf("ERROR: ra_out_flush_frame(): ra_frame_encode() failed\n");
+    return 1;
+    }
+
+  /* remember where this frame went */
+  if (out->nFrames>=out->nFramesMax) {
+    out->nFramesMax *= 2;
+    if ( (out->index = realloc( out->index, out->nFramesMax * sizeof(struct ra_frame_index_struct) ) ) == NULL ) {
+      printf("ERROR: ra_out_flush_frame(): realloc() of index failed\n");
+      return 1;
+      }
+    }
+  out->index[out->nFrames].offset   = out->offset;
+  out->index[out->nFrames].iSeqNo   = frame.iSeqNo;
+  out->index[out->nFrames].fStart   = frame.fStart;
+  out->index[out->nFrames].nReports = frame.nReports;
+  out->nFrames++;
+
+  fwrite( &frame,    sizeof(struct ra_frame_struct), 1, out->fp );
+  fwrite( out->comp, frame.nComp,                    1, out->fp );
+  fflush(out->fp); /* a frame is the unit that survives a crash */
+  out->offset += sizeof(struct ra_frame_struct) + frame.nComp;
+
+  out->nPlain = 0;
+  out->nReports = 0;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_out_put() =============================================*/
+/*==============================================================*/
+/* does the work of ra_out_write() */
+
+int ra_out_put(
+                  struct ra_out_struct *out,       /* [in/out] */
+                  struct ra_header_struct *header, /* [in] report header */
+                  void *body                       /* [in] report body; ignored if header->eType has no body */
+                  ) {
+
+  struct ra_header_struct hw; /* header as written, if it has to be changed */
+  long int nBody;
+  long int n;
+  long int t;
+
+  ra_supp_seen( &(out->supp), header );
+  if ( (header->eType==RA_H_ETYPE_TF0) && out->supp.bOn ) {
+    memcpy( &hw, header, sizeof(struct ra_header_struct) );
+    if (ra_supp_check( &(out->supp), &hw, (struct ra_td *) body )) return 0;
+    header = &hw;
+    }
+
+  nBody = ra_body_size(header);
+  if (nBody<0) {
+    printf("ERROR: ra_out_write(): don't know how to write eType=%d\n",header->eType);
+    return 1;
+    }
+  n = sizeof(struct ra_header_struct) + nBody;
+  out->nBytesIn += n;
+
+  t = ra_prof_now();
+  ra_stream_write( &(out->stream), header, body, nBody ); /* does nothing if not streaming */
+  ra_shm_write( &(out->shm), header, body, nBody );       /* ditto */
+  RA_PROF_ADD(RA_PROF_PUBLISH,t);
+
+  switch (out->eFormat) {
+
+    case RA_OUTFORMAT_PLAIN:
+      fwrite( header, sizeof(struct ra_header_struct), 1, out->fp );
+      if (nBody>0) { fwrite( body, nBody, 1, out->fp ); }
+      fflush(out->fp); /* make sure this doesn't get stalled in buffer somewhere (useful especially if there is a crash...) */
+      out->offset += n;
+      break;
+
+    case RA_OUTFORMAT_FRAMED:
+      if ( (out->nReports>=RA_FRAME_MAX_REPORTS) || (out->nPlain+n>out->nPlainMax) ) {
+        if (ra_out_flush_frame(out)) return 1;
+        }
+      memcpy( &(out->plain[out->nPlain]), header, sizeof(struct ra_header_struct) );
+      if (nBody>0) { memcpy( &(out->plain[out->nPlain+sizeof(struct ra_header_struct)]), body, nBody ); }
+      out->nPlain += n;
+      out->nReports++;
+      break;
+
+    case RA_OUTFORMAT_COLUMNS:
+      if (header->eType==RA_H_ETYPE_NULL) {
+        if (!out->col.bStarted) { /* the first eType=0 report defines the store */
+          if (ra_col_start( &(out->col), header, out->nColChunk, out->fp )) return 1;
+          out->offset += sizeof(struct ra_col_file_struct);
+          }
+        break;
+        }
+      if ( ( (header->eType==RA_H_ETYPE_TF0) || (header->eType==RA_H_ETYPE_TF1) ) && out->col.bStarted ) {
+        out->offset += ra_col_add( &(out->col), header, (struct ra_td *) body, out->fp );
+        }
+      break; /* other eTypes have no place in a columnar store */
+
+    } /* switch (out->eFormat) */
+
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_out_write() ===========================================*/
+/*==============================================================*/
+/* writes one report: header followed by the body implied by header->eType.  returns 0 if OK, 1 otherwise */
+
+int ra_out_write(
+                  struct ra_out_struct *out,       /* [in/out] */
+                  struct ra_header_struct *header, /* [in] report header */
+                  void *body                       /* [in] report body; ignored if header->eType has no body */
+                  ) {
+  long int t = ra_prof_now();
+  int eStatus;
+
+  if (out->bMute) return 0;
+  eStatus = ra_out_put( out, header, body );
+  RA_PROF_ADD(RA_PROF_WRITE,t);
+
+  return eStatus;
+  }
+
+/*==============================================================*/
+/*=== ra_out_mem() =============================================*/
+/*==============================================================*/
+/* [bytes] of memory the output will use, for nCh channels (see ra_mem.c); a STREAM queue is counted once, */
+/* though each subscriber gets one */
+
+long int ra_out_mem(
+                     struct ra_out_struct *out, /* [in] after ra_out_open(), ra_out_stream(), etc. */
+                     long int nCh               /* [in] OBSNCHAN */
+                    ) {
+  long int n = 0;
+  if (out->eFormat==RA_OUTFORMAT_FRAMED)  n += 2*out->nPlainMax + ra_lz_bound(out->nPlainMax) + out->nFramesMax*sizeof(struct ra_frame_index_struct);
+  if (out->eFormat==RA_OUTFORMAT_COLUMNS) n += ( RA_COL_NBASE*sizeof(long int) + nCh*RA_COL_NPERCH*sizeof(float) ) * out->nColChunk;
+  if (out->stream.bOpen) n += out->stream.nQueueMax;
+  n += out->shm.nMap;
+  if (out->supp.bOn) n += sizeof(struct ra_td);
+  return n;
+  }
+
+/*==============================================================*/
+/*=== ra_out_close() ===========================================*/
+/*==============================================================*/
+/* flushes anything pending, writes frame index (if applicable), closes file, frees memory */
+
+void ra_out_close( struct ra_out_struct *out ) {
+
+  struct ra_frame_tail_struct tail;
+  struct ra_header_struct h;
+  long int t;
+
+  if (out->fp==NULL) return;
+
+  if (ra_supp_close( &(out->supp), &h )) { ra_out_write( out, &h, NULL ); } /* count of reports suppressed at the end */
+
+  t = ra_prof_now();
+  ra_stream_close( &(out->stream) ); /* (waits for subscribers' queues to drain) */
+  ra_shm_close( &(out->shm) );
+  RA_PROF_ADD(RA_PROF_PUBLISH,t);
+
+  if (out->eFormat==RA_OUTFORMAT_FRAMED) {
+
+    ra_out_flush_frame(out);
+
+    tail.nFrames  = out->nFrames;
+    tail.offset   = out->offset;
+    tail.magic    = RA_FRAME_TAIL_MAGIC;
+    tail.reserved = 0;
+    fwrite( out->index, sizeof(struct ra_frame_index_struct), out->nFrames, out->fp );
+    fwrite( &tail,      sizeof(struct ra_frame_tail_struct),  1,            out->fp );
+    out->offset += out->nFrames*sizeof(struct ra_frame_index_struct) + sizeof(struct ra_frame_tail_struct);
+
+    printf("ra_out_close(): %ld frames; %f MB of reports written as %f MB\n",out->nFrames,out->nBytesIn/(1024.0*1024.0),out->offset/(1024.0*1024.0));
+
+    free(out->plain); out->plain = NULL;
+    free(out->raw);   out->raw   = NULL;
+    free(out->comp);  out->comp  = NULL;
+    free(out->index); out->index = NULL;
+    }
+
+  if (out->eFormat==RA_OUTFORMAT_COLUMNS) {
+    out->offset += ra_col_flush( &(out->col), out->fp );
+    printf("ra_out_close(): %f MB of reports written as %f MB of columns\n",out->nBytesIn/(1024.0*1024.0),out->offset/(1024.0*1024.0));
+    ra_col_free( &(out->col) );
+    }
+
+  fclose(out->fp);
+  out->fp = NULL;
+  RA_PROF_ADD(RA_PROF_WRITE,t);
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_output.c: 2026 Oct 19
+// -- ra_out_open() can truncate and continue an existing file (--resume; ra_ckpt.c)
+// ra_output.c: 2026 Oct 19
+// -- bMute (WORKERS; ra_par.c)
+// ra_output.c: 2026 Oct 19
+// -- ra_out_mem() (MAX_MEMORY; ra_mem.c)
+// ra_output.c: 2026 Oct 19
+// -- profiling (ra_prof.c); the work of ra_out_write() is now in ra_out_put()
+// ra_output.c: 2026 Oct 19
+// -- ra_out_suppress(): change-triggered suppression of eType 1 reports (ra_suppress.c)
+// ra_output.c: 2026 Oct 19
+// -- ra_out_shm(): reports can also be published in shared memory (ra_shm.c)
+// ra_output.c: 2026 Oct 19
+// -- ra_out_stream(): reports can also be published on a socket (ra_stream.c)
+// ra_output.c: 2026 Oct 19
+// -- added RA_OUTFORMAT_COLUMNS
+// ra_output.c: 2026 Oct 19
+// -- initial version
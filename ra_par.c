@@ -0,0 +1,460 @@
+/*===============================================================
+ra_par.c: 2026 Oct 19
+parallel processing of one GUPPI raw data file, with the reports merged in order (WORKERS)
+---
+With "WORKERS <n>" in the job file (n > 1), a file is processed by n threads instead of one, for reprocessing
+archived observations on machines with many cores.  The reports are the same, to the bit, and in the same
+order, as those of a sequential run (with the exceptions noted below):
+  index     The block headers are read first (ra_par_index()), for where each block's data begins; that's
+            one header per GB.  The data, excluding overlap, is then a stream of samples, as ra_swallow() sees it.
+  ranges    The stream is divided into ranges, each a whole number of windows (ra_par_ranges()): about a
+            block, or less, so that there are at least RA_PAR_RANGES per worker.  A range is a unit of work.
+  workers   Each worker takes the next range, and analyzes its windows, reading a piece at a time (as with
+            MAX_MEMORY; see ra_mem.c), only the analyzed channels, up to the end of the range; no window
+            straddles two ranges.  A window may straddle the edge of a block, inside a range, and is then
+            read from both blocks.  Each worker has its own working memory (ra_arena.c; placed per HUGEPAGES,
+            CPUS, NUMA_NODE), and writes its reports to "<OUTFILE>.part<range>", in OUTFORMAT 0.
+  state     Nothing is carried from one window to the next but fStart, and, with HOP, the sliding windows.
+            fStart is summed over the windows before each range beforehand, the same way ra_swallow_window()
+            does, so it's the same double.  With HOP, a worker first analyzes the nWin-1 hops before its range,
+            with the output muted, to fill the ring; the moment sums are exact, so the windows are the same.
+            With tiles (MAX_MEMORY), ranges are whole T0 windows, so no tile of a window is in another range.
+  merge     main() takes the part files in order of range as they're done, gives each report its iSeqNo
+            (as it would have been, sequentially), and writes it through ra_out_write(): so OUTFORMAT, STREAM,
+            SHM, and SUPPRESS see the same reports, in the same order, as in a sequential run.  Each part file
+            is removed once merged.  A worker waits rather than run more than RA_PAR_AHEAD ranges per worker
+            ahead of the merge, which bounds the disk used by part files.
+MAX_MEMORY is divided among the workers; so if T0 is in tiles, they're those of a sequential run with
+MAX_MEMORY of one worker's share (eType 7 and 8 reports are per tile; see ra_mem.c).  LAG_BUDGET is ignored,
+and PROFILE reports aren't written (what they report isn't reproducible anyway); PROFILE_FILE is, summed over
+the workers, with the time workers and the merge spend waiting for each other as stage "wait".  A truncated
+last block, whose missing bytes a sequential run takes from the block before it, isn't the same.
+================================================================*/
+
+#define RA_PAR_RANGES 4  /* ranges per worker, at least, if the file is long enough */
+#define RA_PAR_AHEAD  2  /* ranges per worker that workers may run ahead of the merge */
+
+struct ra_par_struct {            /* shared by main() and the workers; lock protects the last four */
+  int nWorkers;                   /* WORKERS */
+  char *infile;                   /* INFILE */
+  char *outfile;                  /* OUTFILE; part files are named after it */
+  struct ra_header_struct header0; /* prototype report header; a copy, since main()'s iSeqNo changes in the merge */
+  struct ra_plan_struct *plan;    /* channel plan, for pieces (ra_plan_pieces()) */
+  struct ra_place_struct *place;  /* HUGEPAGES, CPUS, NUMA_NODE, for each worker */
+  int obsnchan;                   /* OBSNCHAN */
+  float chan_bw;                  /* CHAN_BW */
+  long int nAvail;                /* samples per channel in a block, excluding overlap */
+  long int nT0;                   /* samples per channel per window (or hop, or tile) */
+  long int nWin;                  /* hops (or tiles) per T0, if HOP (or tiles); else 0 */
+  int bTumble;                    /* 1: tiles (MAX_MEMORY); 0: hops, if nWin>1 */
+  long int nPiece;                /* samples per channel per piece */
+  long int nArena;                /* [bytes] working memory per worker (ra_mem_arena()) */
+  long int nBlocks;               /* blocks in the file */
+  long int *pos0;                 /* [nBlocks] offset of each block's data */
+  long int nRanges;
+  long int nRange;                /* samples per channel per range (but the last, which goes to the end) */
+  long int nWarm;                 /* samples per channel analyzed, muted, before each range; HOP */
+  double *fstart;                 /* [nRanges] fStart of the first window each range's worker analyzes */
+  pthread_mutex_t lock;
+  pthread_cond_t cond;            /* signaled when a range is done or merged, or on failure */
+  long int iNext;                 /* next range to be taken by a worker */
+  long int nMerged;               /* ranges merged so far */
+  char *bDone;                    /* [nRanges] 1: range's part file is complete */
+  int bFail;                      /* 1: a worker failed; everyone stops */
+  };
+
+struct ra_par_worker_struct {     /* one worker */
+  struct ra_par_struct *par;
+  int id;                         /* 1..nWorkers (0 is main(); see ra_prof_thread()) */
+  pthread_t thread;
+  struct ra_work_struct work;     /* working memory */
+  struct ra_plan_struct plan;     /* copy of par->plan, with its own slide */
+  struct ra_slide_struct slide;   /* HOP, tiles */
+  long int nRanges;               /* ranges done */
+  };
+
+/*==============================================================*/
+/*=== ra_par_part() ============================================*/
+/*==============================================================*/
+/* name of range j's part file, into s (RA_MAX_FILENAME_LENGTH+32 bytes) */
+
+void ra_par_part( struct ra_par_struct *par, long int j, char *s ) {
+  sprintf(s,"%s.part%ld",par->outfile,j);
+  }
+
+/*==============================================================*/
+/*=== ra_par_mem() =============================================*/
+/*==============================================================*/
+/* workers always read in pieces (only the analyzed channels), at most a block's worth; call after ra_mem_plan() */
+
+void ra_par_mem( struct ra_mem_struct *mem, long int nCh, long int nAvail ) {
+  if (mem->nPiece) return;
+  mem->nPiece = nAvail;
+  mem->nBlk   = mem->nPiece*nCh*RG_NPOL;
+  mem->nTotal = mem->nBlk + mem->nT0buf + mem->nSlide + mem->nScratch + mem->nOut;
+  ra_mem_print( mem, "ra_par_mem(): per worker" );
+  }
+
+/*==============================================================*/
+/*=== ra_par_index() ===========================================*/
+/*==============================================================*/
+/* finds where each block's data begins, reading the headers as main() would; fp is at the data of the */
+/* first block (fpos as returned by rg_read_header()).  returns 0 if OK, 1 otherwise */
+
+int ra_par_index( struct ra_par_struct *par, FILE *fp, long int fpos ) {
+  char *rg_header;
+  long int nMax = 1024;
+  long int *p;
+
+  if ( ((rg_header = malloc(RG_MAX_HEADER_LENGTH))==NULL) || ((par->pos0 = malloc(nMax*sizeof(long int)))==NULL) ) {
+    printf("FATAL: ra_par_index(): malloc() failed\n");
+    return 1;
+    }
+  par->nBlocks = 0;
+  do {
+    if (par->nBlocks>=nMax) {
+      if ((p = realloc( par->pos0, 2*nMax*sizeof(long int) ))==NULL) {
+        printf("FATAL: ra_par_index(): realloc() failed\n");
+        return 1;
+        }
+      par->pos0 = p;
+      nMax *= 2;
+      }
+    par->pos0[par->nBlocks++] = ftell(fp);
+    fseek( fp, RG_BLK_SIZE, SEEK_CUR );
+    fpos += RG_BLK_SIZE;
+    } while ( !rg_read_header(fp,&fpos,rg_header) && !feof(fp) );
+  free(rg_header);
+
+  printf("ra_par_index(): %ld blocks\n",par->nBlocks);
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_par_ranges() ==========================================*/
+/*==============================================================*/
+/* divides the file into ranges, and finds fStart at the start of each.  returns 0 if OK, 1 otherwise */
+
+int ra_par_ranges( struct ra_par_struct *par ) {
+  long int nUnit = par->bTumble ? par->nT0*par->nWin : par->nT0; /* samples per channel that a range must be a multiple of */
+  long int nTotal = par->nBlocks*par->nAvail;                    /* samples per channel in the file */
+  long int nUnits = nTotal/nUnit;
+  long int n, j, i, i0;
+  double fstart = 0;
+
+  n = par->nAvail/nUnit;
+  if (n>nUnits/(RA_PAR_RANGES*par->nWorkers)) n = nUnits/(RA_PAR_RANGES*par->nWorkers);
+  if (n<1) n = 1;
+  par->nRange  = n*nUnit;
+  par->nRanges = (nUnits/n>0) ? nUnits/n : 1;
+  par->nWarm   = ( (par->nWin>1) && !par->bTumble ) ? (par->nWin-1)*par->nT0 : 0;
+
+  par->fstart = malloc( par->nRanges*sizeof(double) );
+  par->bDone  = calloc( par->nRanges, 1 );
+  if ( (par->fstart==NULL) || (par->bDone==NULL) ) {
+    printf("FATAL: ra_par_ranges(): malloc() failed\n");
+    return 1;
+    }
+
+  /* as in ra_swallow_window(), window by window */
+  for (i=0,j=0;j<par->nRanges;j++) {
+    i0 = (j*par->nRange - par->nWarm)/par->nT0;
+    if (i0<0) i0 = 0;
+    for (;i<i0;i++) fstart += ( par->nT0 * (1.0e-6) / fabs(par->chan_bw) );
+    par->fstart[j] = fstart;
+    }
+
+  printf("ra_par_ranges(): %ld ranges of %ld samples/channel (%ld windows), for %d workers\n",
+         par->nRanges,par->nRange,par->nRange/par->nT0,par->nWorkers);
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_par_range() ===========================================*/
+/*==============================================================*/
+/* a worker's analysis of range j, into its part file.  returns 0 if OK, 1 otherwise */
+
+int ra_par_range(
+                  struct ra_par_worker_struct *w, /* [in/out] */
+                  FILE *fp,                       /* [in] INFILE, the worker's own */
+                  signed char *blk,               /* [in] piece */
+                  signed char *blk0,              /* [in] T0 buffer */
+                  long int j                      /* [in] range */
+                 ) {
+  struct ra_par_struct *par = w->par;
+  struct ra_header_struct header0; /* the worker's; iSeqNo is redone in the merge */
+  struct ra_out_struct out;
+  char part[RA_MAX_FILENAME_LENGTH+32];
+  long int s0 = j*par->nRange;                                                  /* first sample of the range */
+  long int s1 = (j<par->nRanges-1) ? (j+1)*par->nRange : par->nBlocks*par->nAvail; /* first sample after it */
+  long int s  = (s0>par->nWarm) ? s0-par->nWarm : 0;                            /* first sample read */
+  long int blk0_ptr = 0;
+  double fstart = par->fstart[j];
+  long int mark, b, n0, n, e, tp;
+  int eStatus = 0;
+
+  memcpy( &header0, &(par->header0), sizeof(struct ra_header_struct) );
+  ra_par_part( par, j, part );
+  if (ra_out_open( &out, part, RA_OUTFORMAT_PLAIN, 0, -1 )) return 1;
+
+  /* sliding windows (or tiles) start empty */
+  mark = ra_arena_mark( &(w->work.arena) );
+  if ( (par->nWin>1) && ra_slide_init( &(w->slide), par->nWin, w->plan.nCh, par->bTumble, &(w->work.arena) ) ) eStatus = 1;
+
+  out.bMute = (s<s0);
+  while ( (s<s1) && !eStatus ) {
+    if (s==s0) out.bMute = 0;
+    b  = s/par->nAvail;
+    n0 = s%par->nAvail;
+    e  = (s<s0) ? s0 : s1;
+    n  = par->nAvail-n0;
+    if (n>par->nPiece) n = par->nPiece;
+    if (n>e-s) n = e-s;
+    tp = ra_prof_now();
+    ra_prof_thr[ra_prof_id].nBytes += ra_mem_read( fp, par->pos0[b], &(w->plan), par->obsnchan, n0, n, blk );
+    RA_PROF_ADD(RA_PROF_READ,tp);
+    ra_swallow( blk, &header0, &(w->plan), blk0, &blk0_ptr, par->nT0, n, par->chan_bw, &out, &fstart );
+    s += n;
+    }
+
+  ra_arena_reset( &(w->work.arena), mark );
+  ra_out_close( &out );
+  return eStatus;
+  }
+
+/*==============================================================*/
+/*=== ra_par_worker() ==========================================*/
+/*==============================================================*/
+/* a worker thread: takes ranges, in order, until there are none left */
+
+void *ra_par_worker( void *arg ) {
+  struct ra_par_worker_struct *w = arg;
+  struct ra_par_struct *par = w->par;
+  signed char *blk, *blk0;
+  FILE *fp = NULL;
+  long int j, tp;
+  int bFail = 0;
+
+  ra_prof_thread( w->id );
+  if ( ra_work_init( &(w->work), par->nArena, par->place ) ||
+       ((blk  = ra_arena_alloc( &(w->work.arena), par->nPiece * w->plan.nCh * RG_NPOL, "blk" ))==NULL) ||
+       ((blk0 = ra_arena_alloc( &(w->work.arena), par->nT0 * w->plan.nCh * RG_NPOL, "blk0" ))==NULL) ) {
+      bFail = 1;
+    } else if (!(fp = fopen(par->infile,"rb"))) {
+      printf("FATAL: ra_par_worker(): couldn't open '%s'\n",par->infile);
+      bFail = 1;
+    }
+  ra_work_thread( &(w->work) );
+  w->plan.slide = (par->nWin>1) ? &(w->slide) : NULL;
+
+  while (!bFail) {
+
+    tp = ra_prof_now();
+    pthread_mutex_lock( &(par->lock) );
+    while ( !par->bFail && (par->iNext<par->nRanges) && (par->iNext>=par->nMerged+RA_PAR_AHEAD*par->nWorkers) ) {
+      pthread_cond_wait( &(par->cond), &(par->lock) );
+      }
+    RA_PROF_ADD(RA_PROF_WAIT,tp);
+    j = (par->bFail) ? par->nRanges : par->iNext++;
+    pthread_mutex_unlock( &(par->lock) );
+    if (j>=par->nRanges) break;
+
+    bFail = ra_par_range( w, fp, blk, blk0, j );
+    w->nRanges++;
+
+    pthread_mutex_lock( &(par->lock) );
+    par->bDone[j] = 1;
+    pthread_cond_broadcast( &(par->cond) );
+    pthread_mutex_unlock( &(par->lock) );
+    }
+
+  if (bFail) {
+    pthread_mutex_lock( &(par->lock) );
+    par->bFail = 1;
+    pthread_cond_broadcast( &(par->cond) );
+    pthread_mutex_unlock( &(par->lock) );
+    }
+  if (fp) fclose(fp);
+  return NULL;
+  }
+
+/*==============================================================*/
+/*=== ra_par_merge() ===========================================*/
+/*==============================================================*/
+/* writes the reports in range j's part file to out, numbering them from header0->iSeqNo, and removes */
+/* the part file.  returns 0 if OK, 1 otherwise */
+
+int ra_par_merge(
+                  struct ra_par_struct *par,         /* [in] */
+                  long int j,                        /* [in] range */
+                  struct ra_header_struct *header0,  /* [in/out] iSeqNo is incremented for each report */
+                  struct ra_out_struct *out,         /* [in/out] */
+                  void *body                         /* [in] scratch; as big as the biggest body */
+                 ) {
+  struct ra_header_struct h;
+  char part[RA_MAX_FILENAME_LENGTH+32];
+  FILE *fp;
+  long int nBody, nReports = 0;
+
+  ra_par_part( par, j, part );
+  if (!(fp = fopen(part,"rb"))) {
+    printf("FATAL: ra_par_merge(): couldn't open '%s'\n",part);
+    return 1;
+    }
+  while (fread( &h, sizeof(struct ra_header_struct), 1, fp )==1) {
+    nBody = ra_body_size(&h);
+    if ( (nBody<0) || ( (nBody>0) && (fread( body, nBody, 1, fp )!=1) ) ) {
+      printf("FATAL: ra_par_merge(): '%s' is corrupt\n",part);
+      fclose(fp);
+      return 1;
+      }
+    h.iSeqNo = ++(header0->iSeqNo);
+    if (ra_out_write( out, &h, body )) { fclose(fp); return 1; }
+    nReports++;
+    }
+  fclose(fp);
+  remove(part);
+
+  printf("ra_par_merge(): range %ld of %ld: %ld reports\n",j+1,par->nRanges,nReports);
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_par_run() =============================================*/
+/*==============================================================*/
+/* processes the file with nWorkers threads, and merges their reports into out.  Call with fp at the data */
+/* of the first block, in place of main()'s loop.  returns 0 if OK, 1 otherwise */
+
+int ra_par_run(
+                int nWorkers,                      /* [in] WORKERS */
+                char *infile,                      /* [in] INFILE */
+                FILE *fp,                          /* [in] INFILE, at the first block's data */
+                long int fpos,                     /* [in] as returned by rg_read_header() */
+                struct ra_header_struct *header0,  /* [in/out] prototype report header; iSeqNo is incremented */
+                struct ra_plan_struct *plan,       /* [in] channel plan, for pieces (ra_plan_pieces()) */
+                struct ra_mem_struct *mem,         /* [in] per worker; nPiece, nTiles (ra_mem_plan(), ra_par_mem()) */
+                struct ra_place_struct *place,     /* [in] HUGEPAGES, CPUS, NUMA_NODE */
+                int obsnchan,                      /* [in] OBSNCHAN */
+                float chan_bw,                     /* [in] CHAN_BW */
+                long int nAvail,                   /* [in] samples per channel in a block, excluding overlap */
+                long int nT0,                      /* [in] samples per channel per window (or hop, or tile) */
+                long int nWin,                     /* [in] hops (or tiles) per T0; 0 if neither */
+                char *outfile,                     /* [in] OUTFILE */
+                struct ra_out_struct *out,         /* [in/out] */
+                double checkpoint,                 /* [in] [s] CHECKPOINT; 0 = none (see ra_ckpt.c) */
+                char *ckptFile,                    /* [in] CHECKPOINT_FILE */
+                struct ra_ckpt_struct *resume      /* [in] checkpoint to resume from (ra_ckpt_restore()'d); NULL if not */
+               ) {
+  struct ra_par_struct par;
+  struct ra_par_worker_struct *w;
+  struct ra_ckpt_struct ckpt;
+  char part[RA_MAX_FILENAME_LENGTH+32];
+  long int tCkpt = 0;
+  void *body;
+  long int j, nBody, tp;
+  int t, nStarted = 0;
+  int eStatus = 0;
+
+  memset( &par, 0, sizeof(struct ra_par_struct) );
+  par.nWorkers = nWorkers;
+  par.infile   = infile;
+  par.outfile  = outfile;
+  memcpy( &(par.header0), header0, sizeof(struct ra_header_struct) );
+  par.plan     = plan;
+  par.place    = place;
+  par.obsnchan = obsnchan;
+  par.chan_bw  = chan_bw;
+  par.nAvail   = nAvail;
+  par.nT0      = nT0;
+  par.nWin     = nWin;
+  par.bTumble  = (mem->nTiles>0);
+  par.nPiece   = mem->nPiece;
+  par.nArena   = ra_mem_arena( mem );
+  if (ra_par_index( &par, fp, fpos )) return 1;
+  if (ra_par_ranges( &par )) return 1;
+  if (resume) { /* the ranges merged before the checkpoint aren't done again */
+    if (resume->nRange!=par.nRange) {
+      printf("FATAL: ra_par_run(): the checkpoint has ranges of %ld samples/channel, not %ld\n",resume->nRange,par.nRange);
+      return 1;
+      }
+    par.iNext = par.nMerged = resume->nMerged;
+    printf("ra_par_run(): resuming at range %ld of %ld\n",par.nMerged+1,par.nRanges);
+    }
+
+  /* a buffer for the biggest report body, for the merge */
+  nBody = sizeof(struct ra_td);
+  if (nBody<sizeof(struct ra_tm) + RA_MAX_CH_DIV64*64*sizeof(struct MAPstruct)) nBody = sizeof(struct ra_tm) + RA_MAX_CH_DIV64*64*sizeof(struct MAPstruct);
+  if (nBody<sizeof(struct ra_th) + RA_MAX_CH_DIV64*64*sizeof(struct HPstruct))  nBody = sizeof(struct ra_th) + RA_MAX_CH_DIV64*64*sizeof(struct HPstruct);
+  if ( ((w = calloc( nWorkers, sizeof(struct ra_par_worker_struct) ))==NULL) || ((body = malloc(nBody))==NULL) ) {
+    printf("FATAL: ra_par_run(): malloc() failed\n");
+    return 1;
+    }
+
+  pthread_mutex_init( &(par.lock), NULL );
+  pthread_cond_init( &(par.cond), NULL );
+  for (t=0;t<nWorkers;t++) {
+    w[t].par = &par;
+    w[t].id  = t+1;
+    memcpy( &(w[t].plan), plan, sizeof(struct ra_plan_struct) );
+    if (pthread_create( &(w[t].thread), NULL, ra_par_worker, &(w[t]) )) {
+      printf("FATAL: ra_par_run(): couldn't start worker %d\n",t+1);
+      eStatus = 1;
+      break;
+      }
+    nStarted++;
+    }
+
+  /* merge, in order, as ranges are done */
+  for (j=par.nMerged;(j<par.nRanges)&&!eStatus;j++) {
+    tp = ra_prof_now();
+    pthread_mutex_lock( &(par.lock) );
+    while ( !par.bDone[j] && !par.bFail ) pthread_cond_wait( &(par.cond), &(par.lock) );
+    RA_PROF_ADD(RA_PROF_WAIT,tp);
+    eStatus = par.bFail;
+    pthread_mutex_unlock( &(par.lock) );
+    if (!eStatus) eStatus = ra_par_merge( &par, j, header0, out, body );
+    pthread_mutex_lock( &(par.lock) );
+    if (eStatus) par.bFail = 1; else par.nMerged++;
+    pthread_cond_broadcast( &(par.cond) );
+    pthread_mutex_unlock( &(par.lock) );
+
+    /* every CHECKPOINT seconds, save how many ranges have been merged */
+    if ( !eStatus && (j<par.nRanges-1) && ra_ckpt_due( checkpoint, &tCkpt ) ) {
+      ra_ckpt_init( &ckpt, header0, nT0, plan->nCh, nWin, out, nWorkers );
+      ckpt.nRange  = par.nRange;
+      ckpt.nMerged = par.nMerged;
+      ckpt.fstart0 = par.fstart[j+1];
+      ra_ckpt_write( ckptFile, &ckpt, out, NULL, NULL, NULL );
+      }
+    }
+
+  for (t=0;t<nStarted;t++) {
+    pthread_join( w[t].thread, NULL );
+    printf("ra_par_run(): worker %d: %ld ranges; working memory %.1f of %.1f MB used\n",w[t].id,w[t].nRanges,
+           (double) w[t].work.arena.high/RA_MEM_MB,(double) w[t].work.arena.size/RA_MEM_MB);
+    ra_work_free( &(w[t].work) );
+    }
+  if (eStatus) {
+    printf("FATAL: ra_par_run(): stopped after %ld of %ld ranges\n",par.nMerged,par.nRanges);
+    for (j=par.nMerged;j<par.iNext;j++) { ra_par_part( &par, j, part ); remove(part); }
+    }
+
+  pthread_mutex_destroy( &(par.lock) );
+  pthread_cond_destroy( &(par.cond) );
+  free(w);
+  free(body);
+  free(par.pos0);
+  free(par.fstart);
+  free(par.bDone);
+  return eStatus;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_par.c: 2026 Oct 19
+// -- waits are profiled (RA_PROF_WAIT)
+// ra_par.c: 2026 Oct 19
+// -- checkpoints between merged ranges, and resuming (ra_ckpt.c)
+// ra_par.c: 2026 Oct 19
+// -- initial version
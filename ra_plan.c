@@ -0,0 +1,156 @@
+/*===============================================================
+ra_plan.c: 2026 Oct 19
+which channels get analyzed, and where their data are
+---
+The channels to be analyzed are those not flagged in header0.bChIn.  Rather than testing those bits for
+every channel every time data are moved or analyzed, ra_plan_compile() makes a list of the analyzed
+channels once, at startup, along with where each one's data are in the raw data block and in the T0
+buffer.  ra_swallow() and ra_analyze() loop over this list.  Since the k'th channel in the list is
+independent of the others (its data are contiguous in the T0 buffer, and nothing else is written there),
+the list can also be divided among threads.  The analysis kernel (which depends on STATS and EXACT in the
+job file, on whether ADC health is reported, and on eSource; see ra_kernels.c) is chosen here as well.
+
+T0 windows are analyzed where they are: a window that lies within one GUPPI block is one span of that
+block for each channel.  Only the start of a window that crosses into the next block is kept, in the
+T0 buffer ("blk0"); that window is then two spans, the part in the T0 buffer and the rest in the next
+block.  struct ra_win_struct describes a window for all channels at once; ra_win_spans() gives the
+spans for the k'th channel.
+
+T0 buffer layout: the k'th analyzed channel occupies bytes k*nBytesPerCh .. (k+1)*nBytesPerCh-1,
+where nBytesPerCh = nT0*RG_NPOL.  Within it are four planes of nT0 bytes each: all the xi's, then all
+the xq's, then the yi's, then the yq's (ra_swallow() deinterleaves them).  Channels not analyzed take
+no space.
+
+When memory is bounded (MAX_MEMORY; see ra_mem.c), the block is read a piece at a time, only the
+analyzed channels; ra_plan_pieces() then points offBlk[] into the piece, where the k'th channel's
+nPiece samples begin at k*nPiece*RG_NPOL (still interleaved, as in the block).
+================================================================*/
+
+struct ra_plan_struct {
+  long int nCh;                           /* number of channels to be analyzed */
+  long int ch[RA_MAX_CH_DIV64*64];        /* their channel numbers (1..nCh of the data), ascending */
+  long int offBlk[RA_MAX_CH_DIV64*64];    /* [bytes] where each one begins in the raw data block (or piece) */
+  long int offBlk0[RA_MAX_CH_DIV64*64];   /* [bytes] where each one begins in the T0 buffer */
+  long int nBytesPerCh;                   /* [bytes] per channel in the T0 buffer */
+  long int nT0;                           /* samples per channel in the T0 buffer; length of each plane */
+  long int nPiece;                        /* samples per channel in a piece (see ra_plan_pieces()); 0 = whole blocks */
+  ra_kernel_t kernel;                     /* analysis kernel, per STATS */
+  int eStats;                             /* STATS */
+  long int mev2;                          /* (max encodable value)^2; for clip counting */
+  struct ra_slide_struct *slide;          /* sliding windows (see ra_slide.c); NULL if windows are disjoint */
+  struct ra_lag_struct *lag;              /* real-time deadline monitor (see ra_lag.c); NULL if no LAG_BUDGET */
+  int bNoProf;                            /* 1: no PROFILE reports (a chain; see ra_fan.c) */
+  };
+
+/* a T0 window: one or two segments, each either in the GUPPI block or in the T0 buffer, at the */
+/* same place for every channel */
+struct ra_win_struct {
+  int nSeg;                      /* 1 or 2 (<= RA_MAX_SPANS) */
+  struct {
+    signed char *blk;            /* the GUPPI block, or NULL for the T0 buffer */
+    long int n0;                 /* first sample (within the channel) */
+    long int n;                  /* number of samples */
+    } seg[RA_MAX_SPANS];
+  signed char *blk0;             /* the T0 buffer */
+  };
+
+/*==============================================================*/
+/*=== ra_plan_compile() ========================================*/
+/*==============================================================*/
+/* returns 0 if OK, 1 if there's nothing to analyze or no kernel for eStats */
+
+int ra_plan_compile(
+                     struct ra_plan_struct *plan,      /* [out] */
+                     struct ra_header_struct *header0, /* [in] bChIn, nCh, tflags, eSource */
+                     long int nT0,                     /* [in] samples per channel in the T0 buffer */
+                     int eStats,                       /* [in] STATS; RA_STATS_* bits (see ra_kernels.c) */
+                     int bExact                        /* [in] EXACT */
+                     ) {
+  long int l;
+
+  memset(plan,0,sizeof(struct ra_plan_struct));
+  plan->nBytesPerCh = nT0*RG_NPOL;
+  plan->nT0 = nT0;
+  plan->eStats = eStats;
+  for (l=1;l<=header0->nCh;l++) { /* note..starting from 1 here! */
+    if (!ra_isChBitSet(header0->bChIn,l)) {
+      plan->ch[plan->nCh]      = l;
+      plan->offBlk[plan->nCh]  = (l-1)*(RG_BLK_SIZE/header0->nCh); /* = (l-1)*RG_NDIM*RG_NPOL for 32 channels */
+      plan->offBlk0[plan->nCh] = plan->nCh*plan->nBytesPerCh;
+      plan->nCh++;
+      }
+    }
+
+  if (plan->nCh==0) {
+    printf("FATAL: ra_plan_compile(): all %ld channels are EXCLUDE'd\n",header0->nCh);
+    return 1;
+    }
+  if ( (plan->kernel = ra_kernel_select( eStats, bExact, header0->tflags & RA_H_TFLAGS_TH, header0->eSource, &(plan->mev2) )) == NULL ) return 1;
+  printf("ra_plan_compile(): analyzing %ld of %ld channels, STATS %d, EXACT %d\n",plan->nCh,header0->nCh,eStats,bExact);
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_plan_pieces() =========================================*/
+/*==============================================================*/
+/* the block will be read in pieces of nPiece samples per channel, analyzed channels only (see ra_mem_read()) */
+
+void ra_plan_pieces(
+                     struct ra_plan_struct *plan,      /* [in/out] */
+                     long int nPiece                   /* [in] */
+                     ) {
+  long int k;
+  plan->nPiece = nPiece;
+  for (k=0;k<plan->nCh;k++) plan->offBlk[k] = k*nPiece*RG_NPOL;
+  }
+
+/*==============================================================*/
+/*=== ra_win_spans() ===========================================*/
+/*==============================================================*/
+/* fills span[] for the k'th channel of the plan; returns the number of spans */
+
+int ra_win_spans(
+                  struct ra_win_struct *win,     /* [in] */
+                  struct ra_plan_struct *plan,   /* [in] */
+                  long int k,                    /* [in] index into plan->ch[] */
+                  struct ra_span_struct *span    /* [out] win->nSeg of them */
+                 ) {
+  int j;
+
+  for (j=0;j<win->nSeg;j++) {
+    span[j].n = win->seg[j].n;
+    if (win->seg[j].blk) { /* in the GUPPI block: interleaved */
+        span[j].x  = win->seg[j].blk + plan->offBlk[k] + win->seg[j].n0*RG_NPOL;
+        span[j].dS = RG_NPOL;
+        span[j].dC = 1;
+      } else {             /* in the T0 buffer: planes */
+        span[j].x  = win->blk0 + plan->offBlk0[k] + win->seg[j].n0;
+        span[j].dS = 1;
+        span[j].dC = plan->nT0;
+      }
+    }
+
+  return win->nSeg;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_plan.c: 2026 Oct 19
+// -- bNoProf
+// ra_plan.c: 2026 Oct 19
+// -- blocks read in pieces (ra_plan_pieces(); MAX_MEMORY, ra_mem.c)
+// ra_plan.c: 2026 Oct 19
+// -- lag (LAG_BUDGET; ra_lag.c)
+// ra_plan.c: 2026 Oct 19
+// -- offBlk[] from OBSNCHAN; was right only for 32 channels
+// ra_plan.c: 2026 Oct 19
+// -- kernel with ADC health if tflags b6 is set
+// ra_plan.c: 2026 Oct 19
+// -- EXACT
+// ra_plan.c: 2026 Oct 19
+// -- T0 windows (struct ra_win_struct, ra_win_spans())
+// ra_plan.c: 2026 Oct 19
+// -- also selects the analysis kernel
+// ra_plan.c: 2026 Oct 19
+// -- initial version
@@ -0,0 +1,250 @@
+/*===============================================================
+ra_prof.c: 2026 Oct 19
+per-stage profiling and throughput telemetry
+---
+Time spent in each stage of processing is accumulated, per thread, from a monotonic clock
+(clock_gettime(CLOCK_MONOTONIC), which on Linux is read from the TSC without a system call):
+  header    reading and parsing GUPPI block headers
+  read      reading GUPPI data blocks
+  copy      ra_swallow(): saving the start of a window that crosses into the next block (ra_deinterleave())
+  kernel    eType 1 statistics (ra_kernels.c), all channels of a window
+  moments   eType 7 moments, and ADC health with HOP (ra_analyze_tm())
+  slide     sliding windows (ra_slide.c)
+  write     ra_out_write() and ra_out_close(): suppression, compression, writing the file, and publishing
+  publish   ...of which, STREAM and SHM; including, at close, waiting for subscribers' queues to drain
+  wait      WORKERS: a worker held back from running too far ahead of the merge, and main() waiting for
+            the next range to be done (see ra_par.c); which of the two is the bottleneck
+A stage is timed once per block, window, or report (not per sample or channel), so the cost is a few
+clock reads per window.  Each thread adds to its own struct ra_prof_struct (ra_prof_thread() says
+which), and the threads' counters are summed only when reported, so there is no locking.
+
+The counters are always kept, and summarized when frsc exits.  With "PROFILE <s>" in the job file, every
+<s> seconds (of wall-clock time; checked after each window) frsc also writes an eType 0 report with bit 1
+of err set (RA_H_ERR_PROFILE), whose sInfo gives throughput since the last such report, e.g.
+  "PROF 412.3 MB/s 1.05e+08 S/s RT 16.51 kernel 61%"
+that is: MB/s of GUPPI data read; samples/s analyzed (summed over analyzed channels); the real-time
+factor (seconds of data per second of wall-clock time; less than 1 means frsc is falling behind); and
+the stage which took the largest share of the time.  With "PROFILE_FILE <path>", the cumulative counters
+and rates are also written to <path> as JSON, each time and at exit (replaced atomically, via rename()).
+================================================================*/
+
+#define RA_PROF_HEADER   0
+#define RA_PROF_READ     1
+#define RA_PROF_COPY     2
+#define RA_PROF_KERNEL   3
+#define RA_PROF_MOMENTS  4
+#define RA_PROF_SLIDE    5
+#define RA_PROF_WRITE    6
+#define RA_PROF_PUBLISH  7
+#define RA_PROF_WAIT     8
+#define RA_PROF_N        9
+
+#define RA_PROF_MAX_THREADS 256
+
+char *ra_prof_names[RA_PROF_N] = { "header", "read", "copy", "kernel", "moments", "slide", "write", "publish", "wait" };
+
+struct ra_prof_struct {           /* one thread's counters */
+  long int ns[RA_PROF_N];         /* [ns] time spent in each stage */
+  long int n[RA_PROF_N];          /* number of times */
+  long int nBytes;                /* [bytes] of GUPPI data read */
+  long int nSamples;              /* samples analyzed, summed over analyzed channels */
+  long int nSamplesCh;            /* samples analyzed, per channel; i.e., amount of data in samples */
+  };
+
+struct ra_prof_struct ra_prof_thr[RA_PROF_MAX_THREADS]; /* [thread] */
+__thread int ra_prof_id = 0;                            /* this thread's slot; see ra_prof_thread() */
+
+struct ra_prof_tel_struct {       /* periodic reporting */
+  double period;                  /* [s] PROFILE; 0 = don't */
+  char file[RA_MAX_FILENAME_LENGTH]; /* PROFILE_FILE; empty = don't */
+  long int t0;                    /* [ns] when ra_prof_start() was called */
+  long int tNext;                 /* [ns] when to report next */
+  long int tLast;                 /* [ns] when last reported */
+  struct ra_prof_struct last;     /* sums, when last reported */
+  };
+
+struct ra_prof_tel_struct ra_prof_tel;
+
+/*==============================================================*/
+/*=== ra_prof_now() ============================================*/
+/*==============================================================*/
+/* [ns] monotonic */
+
+long int ra_prof_now( void ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec*1000000000L + ts.tv_nsec;
+  }
+
+/* "long int t = ra_prof_now(); ...stage...; RA_PROF_ADD(RA_PROF_READ,t);" */
+#define RA_PROF_ADD(STAGE,T) { ra_prof_thr[ra_prof_id].ns[STAGE] += ra_prof_now() - (T); ra_prof_thr[ra_prof_id].n[STAGE]++; }
+
+/*==============================================================*/
+/*=== ra_prof_thread() =========================================*/
+/*==============================================================*/
+/* called by a thread, before it does anything that is timed, to say which slot is its own (0 for main()) */
+
+void ra_prof_thread( int id ) {
+  ra_prof_id = id % RA_PROF_MAX_THREADS;
+  }
+
+/*==============================================================*/
+/*=== ra_prof_sum() ============================================*/
+/*==============================================================*/
+/* the counters, summed over threads */
+
+void ra_prof_sum( struct ra_prof_struct *s ) {
+  int t, j;
+  memset( s, 0, sizeof(struct ra_prof_struct) );
+  for (t=0;t<RA_PROF_MAX_THREADS;t++) {
+    for (j=0;j<RA_PROF_N;j++) { s->ns[j] += ra_prof_thr[t].ns[j]; s->n[j] += ra_prof_thr[t].n[j]; }
+    s->nBytes     += ra_prof_thr[t].nBytes;
+    s->nSamples   += ra_prof_thr[t].nSamples;
+    s->nSamplesCh += ra_prof_thr[t].nSamplesCh;
+    }
+  }
+
+/*==============================================================*/
+/*=== ra_prof_start() ==========================================*/
+/*==============================================================*/
+
+void ra_prof_start(
+                    double period,   /* [in] [s] PROFILE; 0 = don't report periodically */
+                    char *file       /* [in] PROFILE_FILE; empty = don't */
+                   ) {
+  memset( ra_prof_thr, 0, sizeof(ra_prof_thr) );
+  memset( &ra_prof_tel, 0, sizeof(ra_prof_tel) );
+  ra_prof_tel.period = period;
+  strcpy( ra_prof_tel.file, file );
+  ra_prof_tel.t0 = ra_prof_now();
+  ra_prof_tel.tLast = ra_prof_tel.t0;
+  ra_prof_tel.tNext = ra_prof_tel.t0 + (long int) (period*1e+9);
+  }
+
+/*==============================================================*/
+/*=== ra_prof_file() ===========================================*/
+/*==============================================================*/
+/* writes PROFILE_FILE, if any; returns 0 if OK (or nothing to do), 1 otherwise */
+
+int ra_prof_file(
+                  double fs       /* [in] [Hz] sample rate per channel */
+                 ) {
+  struct ra_prof_struct s;
+  char tmp[RA_MAX_FILENAME_LENGTH+8];
+  FILE *fp;
+  double dt;
+  int j;
+
+  if (!ra_prof_tel.file[0]) return 0;
+  ra_prof_sum( &s );
+  dt = (ra_prof_now() - ra_prof_tel.t0)*1e-9;
+  sprintf(tmp,"%s.tmp",ra_prof_tel.file);
+  if (!(fp = fopen(tmp,"w"))) {
+    printf("WARNING: ra_prof_file(): couldn't write '%s'\n",tmp);
+    return 1;
+    }
+  fprintf(fp,"{\n");
+  fprintf(fp,"  \"wall_s\": %.6f,\n",dt);
+  fprintf(fp,"  \"bytes\": %ld,\n",s.nBytes);
+  fprintf(fp,"  \"samples\": %ld,\n",s.nSamples);
+  fprintf(fp,"  \"data_s\": %.6f,\n",s.nSamplesCh/fs);
+  fprintf(fp,"  \"mb_per_s\": %.3f,\n",(dt>0) ? s.nBytes/dt/1.0e+6 : 0.0);
+  fprintf(fp,"  \"samples_per_s\": %.6e,\n",(dt>0) ? s.nSamples/dt : 0.0);
+  fprintf(fp,"  \"realtime_factor\": %.4f,\n",(dt>0) ? s.nSamplesCh/fs/dt : 0.0);
+  fprintf(fp,"  \"stages\": {\n");
+  for (j=0;j<RA_PROF_N;j++) {
+    fprintf(fp,"    \"%s\": { \"s\": %.6f, \"calls\": %ld }%s\n",ra_prof_names[j],s.ns[j]*1e-9,s.n[j],(j<RA_PROF_N-1)?",":"");
+    }
+  fprintf(fp,"  }\n");
+  fprintf(fp,"}\n");
+  fclose(fp);
+  if (rename(tmp,ra_prof_tel.file)) {
+    printf("WARNING: ra_prof_file(): couldn't rename '%s' to '%s'\n",tmp,ra_prof_tel.file);
+    return 1;
+    }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_prof_tick() ===========================================*/
+/*==============================================================*/
+/* if PROFILE seconds have passed since the last time, fills header with an eType 0 (profiling) report */
+/* and returns 1 (and writes PROFILE_FILE, if any); otherwise returns 0 */
+
+int ra_prof_tick(
+                  struct ra_header_struct *header0, /* [in/out] prototype report header; iSeqNo is incremented */
+                  double fstart,                    /* [in] fStart of the report */
+                  struct ra_header_struct *header   /* [out] */
+                 ) {
+  struct ra_prof_struct s;
+  long int t, dns;
+  long int dMax = -1;
+  double dt;
+  int j, jMax = 0;
+
+  if (ra_prof_tel.period<=0) return 0;
+  t = ra_prof_now();
+  if (t<ra_prof_tel.tNext) return 0;
+
+  ra_prof_sum( &s );
+  dt = (t - ra_prof_tel.tLast)*1e-9;
+  for (j=0;j<RA_PROF_N;j++) {
+    if (j==RA_PROF_PUBLISH) continue; /* part of write */
+    dns = s.ns[j] - ra_prof_tel.last.ns[j];
+    if (dns>dMax) { dMax = dns; jMax = j; }
+    }
+
+  (header0->iSeqNo)++;
+  memcpy( header, header0, sizeof(struct ra_header_struct) );
+  header->eType  = RA_H_ETYPE_NULL;
+  header->err    = RA_H_ERR_PROFILE;
+  header->fStart = fstart;
+  memset( header->sInfo, 0, RA_MAX_SINFO_LENGTH );
+  snprintf( header->sInfo, RA_MAX_SINFO_LENGTH, "PROF %.1f MB/s %.2e S/s RT %.2f %s %.0f%%",
+            (s.nBytes - ra_prof_tel.last.nBytes)/dt/1.0e+6,
+            (s.nSamples - ra_prof_tel.last.nSamples)/dt,
+            (s.nSamplesCh - ra_prof_tel.last.nSamplesCh)/header0->fs/dt,
+            ra_prof_names[jMax], 100.0*dMax*1e-9/dt );
+  printf("ra_prof_tick(): %s\n",header->sInfo);
+
+  memcpy( &(ra_prof_tel.last), &s, sizeof(struct ra_prof_struct) );
+  ra_prof_tel.tLast = t;
+  while (ra_prof_tel.tNext<=t) ra_prof_tel.tNext += (long int) (ra_prof_tel.period*1e+9);
+  ra_prof_file( header0->fs );
+
+  return 1;
+  }
+
+/*==============================================================*/
+/*=== ra_prof_print() ==========================================*/
+/*==============================================================*/
+/* summary, to stdout; and PROFILE_FILE, if any */
+
+void ra_prof_print(
+                    double fs       /* [in] [Hz] sample rate per channel */
+                   ) {
+  struct ra_prof_struct s;
+  double dt;
+  int j;
+
+  ra_prof_sum( &s );
+  dt = (ra_prof_now() - ra_prof_tel.t0)*1e-9;
+  printf("Profile (%.3f s):\n",dt);
+  printf("  stage           time [s]   share      calls   us/call\n");
+  for (j=0;j<RA_PROF_N;j++) {
+    printf("  %-10s %13.6f %6.1f%% %10ld %9.1f\n",ra_prof_names[j],s.ns[j]*1e-9,(dt>0)?100.0*s.ns[j]*1e-9/dt:0.0,
+           s.n[j],(s.n[j]>0)?s.ns[j]*1e-3/s.n[j]:0.0);
+    }
+  if (dt>0) {
+    printf("  %.1f MB/s, %.3e samples/s, real-time factor %.3f\n",s.nBytes/dt/1.0e+6,s.nSamples/dt,s.nSamplesCh/fs/dt);
+    }
+  ra_prof_file( fs );
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_prof.c: 2026 Oct 19
+// -- wait stage (RA_PROF_WAIT), for WORKERS
+// ra_prof.c: 2026 Oct 19
+// -- initial version
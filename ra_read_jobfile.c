@@ -5,6 +5,38 @@ reads jobfile
 
 #define RA_MAX_LINE_LENGTH 4096  /* for text files read in */
 
+/* Operating options from the jobfile that are not part of the report header */
+struct ra_opt_struct {
+  char outfile[RA_MAX_FILENAME_LENGTH]; /* OUTFILE: name of output file */
+  int eOutFormat;                       /* OUTFORMAT: RA_OUTFORMAT_PLAIN, _FRAMED, _COLUMNS (see ra_output.c) */
+  int nColChunk;                        /* COL_CHUNK: reports per chunk when OUTFORMAT is RA_OUTFORMAT_COLUMNS */
+  char stream[RA_MAX_FILENAME_LENGTH];  /* STREAM: address on which to publish reports (see ra_stream.c); empty = don't */
+  long int nStreamQueue;                /* STREAM_QUEUE: [bytes] per-subscriber queue limit */
+  int eStreamPolicy;                    /* STREAM_POLICY: RA_STREAM_POLICY_DROP or _DISCONNECT */
+  char shm[RA_MAX_FILENAME_LENGTH];     /* SHM: name of shared memory in which to publish reports (see ra_shm.c); empty = don't */
+  long int nShmSize;                    /* SHM_SIZE: [bytes] of ring */
+  int bSuppress;                        /* SUPPRESS given? (see ra_suppress.c) */
+  float rSuppressPower;                 /* SUPPRESS <power> <kurtosis> [<clips>] */
+  float dSuppressKurt;
+  long int dSuppressClips;
+  double heartbeat;                     /* HEARTBEAT: [s] */
+  int eStats;                           /* STATS: RA_STATS_* bits (see ra_kernels.c) */
+  int bExact;                           /* EXACT: 1 = exact integer accumulation (see ra_kernels.c) */
+  double hop;                           /* HOP: [s] sliding windows (see ra_slide.c); 0 = windows are disjoint */
+  double profile;                       /* PROFILE: [s] period of profiling reports (see ra_prof.c); 0 = don't */
+  char profileFile[RA_MAX_FILENAME_LENGTH]; /* PROFILE_FILE: where profiling counters go, as JSON; empty = don't */
+  double lagBudget;                     /* LAG_BUDGET: [s] lag that triggers degradation (see ra_lag.c); 0 = no monitor */
+  char lagLadder[RA_MAX_LINE_LENGTH];   /* LAG_LADDER: order of degradation steps; empty = default */
+  long int nLagSub;                     /* LAG_SUBSAMPLE: one window in this many is analyzed, when subsampling */
+  int bLagPriority;                     /* LAG_PRIORITY given? */
+  unsigned long int bChLagPriority[RA_MAX_CH_DIV64]; /* LAG_PRIORITY: channels still analyzed at the "channels" step */
+  double maxMemory;                     /* MAX_MEMORY: [MB] budget (see ra_mem.c); 0 = no limit */
+  struct ra_place_struct place;         /* HUGEPAGES, CPUS, NUMA_NODE: placement of working memory and threads (see ra_arena.c) */
+  int nWorkers;                         /* WORKERS: threads processing the file in parallel (see ra_par.c); 0 or 1 = sequential */
+  double checkpoint;                    /* CHECKPOINT: [s] between checkpoints (see ra_ckpt.c); 0 = none */
+  char ckptFile[RA_MAX_FILENAME_LENGTH]; /* CHECKPOINT_FILE: where; default "<OUTFILE>.ckpt" */
+  };
+
 /*==============================================================*/
 /*=== iswhitespace() ===========================================*/
 /*==============================================================*/
@@ -20,13 +52,57 @@ int iswhitespace( char c ) {
   return bResult;
   }
 
+/*==============================================================*/
+/*=== ra_jobfile_chlist() ======================================*/
+/*==============================================================*/
+/* parses a channel list such as "5", "1-29,31-32", or "3,7,9-12" and sets (bSet=1) or clears (bSet=0) */
+/* the corresponding bits in b[]; channel l is bit (l-1)%64 of b[(l-1)/64]. */
+/* returns 0 if OK, 1 on error */
+
+int ra_jobfile_chlist( char *s,                /* [in] channel list */
+                       unsigned long int *b,   /* [in/out] channel bits */
+                       int bSet                /* [in] 1 = set, 0 = clear */
+                      ) {
+  char *p = s;
+  char *q;
+  long int l1, l2, l;
+  unsigned long int uli = 1;
+
+  while (1) {
+    l1 = strtol(p,&q,10);
+    if (q==p) break;
+    l2 = l1;
+    p = q;
+    if (*p=='-') {
+      p++;
+      l2 = strtol(p,&q,10);
+      if (q==p) break;
+      p = q;
+      }
+    if ((l1<1) || (l2<l1) || (l2>RA_MAX_CH_DIV64*64)) {
+      printf("FATAL: ra_jobfile_chlist(): channel range %ld-%ld is not within 1-%d\n",l1,l2,RA_MAX_CH_DIV64*64);
+      return 1;
+      }
+    for (l=l1;l<=l2;l++) {
+      if (bSet) { b[(l-1)/64] |=  ( uli << ((l-1)%64) ); }
+           else { b[(l-1)/64] &= ~( uli << ((l-1)%64) ); }
+      }
+    if (*p!=',') return 0;
+    p++;
+    }
+
+  printf("FATAL: ra_jobfile_chlist(): can't parse channel list \"%s\"\n",s);
+  return 1;
+  }
+
 /*==============================================================*/
 /*=== ra_read_jobfile() ======================================*/
 /*==============================================================*/
 
 int ra_read_jobfile( char* jobfile,                    /* [in] name of job file */
                      struct ra_header_struct *header,  /* [out] report output header */
-                     char* infile                      /* [out] name of data file */   
+                     char* infile,                     /* [out] name of data file */   
+                     struct ra_opt_struct *opt         /* [out] operating options */
                     ) {
 
   FILE *fp;
@@ -35,17 +111,14 @@ int ra_read_jobfile( char* jobfile,                    /* [in] name of job file
   char keyword[RA_MAX_LINE_LENGTH];
   int bFoundKeyword=0;
   char scratch_string[RA_MAX_LINE_LENGTH];
-  int iCh;
 
   int string_length;
 
-  int index_arr;
-  int index_bit;
-  unsigned long int uli;
 
   int temp_char;
 
   /* initialize the header */
+  memset(header,0,sizeof(struct ra_header_struct)); /* includes padding, so headers are reproducible */
   header->eType = RA_H_ETYPE_NULL;
   header->err = 0;
   header->iReportVersion = RA_H_REPORT_VERSION; 
@@ -85,6 +158,18 @@ int ra_read_jobfile( char* jobfile,                    /* [in] name of job file
   header->iSeqNo = 0;
   header->fStart = 0.0;
 
+  /* initialize the options */
+  memset(opt,0,sizeof(struct ra_opt_struct));
+  sprintf(opt->outfile,"out.dat");
+  opt->eOutFormat = RA_OUTFORMAT_PLAIN;
+  opt->nColChunk = RA_COL_CHUNK_DEFAULT;
+  opt->nStreamQueue = RA_STREAM_QUEUE_DEFAULT;
+  opt->eStreamPolicy = RA_STREAM_POLICY_DROP;
+  opt->nShmSize = RA_SHM_SIZE_DEFAULT;
+  opt->heartbeat = RA_SUPP_HEARTBEAT_DEFAULT;
+  opt->eStats = RA_STATS_ALL;
+  opt->place.node = -1;
+
   /* open the jobfile */
   if (!(fp=fopen(jobfile,"r"))) {
       printf("FATAL: In ra_read_jobfile(), unable to open '%s'\n",jobfile);
@@ -147,31 +232,19 @@ int ra_read_jobfile( char* jobfile,                    /* [in] name of job file
         sscanf(&(line[i]),"%s %lf",keyword,&(header->T2));
         } 
 
-      if (strncmp(keyword,"EXCLUDE",7)==0) {
+      if (strncmp(keyword,"EXCLUDE",7)==0) { /* EXCLUDE <list>; e.g. "EXCLUDE 1-29,31-32" */
         bFoundKeyword=1;
-        sscanf(&(line[i]),"%s %d",keyword,&iCh);
-        if (iCh>(RA_MAX_CH_DIV64*64)) {
-          printf("FATAL: In ra_read_jobfile(), iCh=%d is > RA_MAX_CH_DIV64*64 = %d\n",iCh,RA_MAX_CH_DIV64*64);
-          return 1;        
-          }
-        index_arr = (iCh-1)/64;                          /* this is the 0-based array index containing bit to be set */
-        index_bit = (iCh-1) - index_arr*64;              /* this is the 0-based bit index to be set (0=LSB) */
-        uli = 1;
-        header->bChIn  [index_arr] += ( uli << index_bit); /* set the bit */
-        header->bChInCh[index_arr] += ( uli << index_bit); /* set the bit */
-        } 
-    
-      if (strncmp(keyword,"INCLUDE",7)==0) {
-        bFoundKeyword=1;
-        sscanf(&(line[i]),"%s %d",keyword,&iCh);
-        if (iCh>(RA_MAX_CH_DIV64*64)) {
-          printf("FATAL: In ra_read_jobfile(), iCh=%d is > RA_MAX_CH_DIV64*64 = %d\n",iCh,RA_MAX_CH_DIV64*64);
-          return 1;        
-          }
-        index_arr = (iCh-1)/64;                          /* this is the 0-based array index containing bit to be set */
-        index_bit = (iCh-1) - index_arr*64;              /* this is the 0-based bit index to be set (0=LSB) */
-        uli = 1;
-        header->bChInCh[index_arr] = header->bChInCh[index_arr] ^ ( uli << index_bit); /* unset the bit */
+        scratch_string[0]='\0';
+        sscanf(&(line[i]),"%s %s",keyword,scratch_string);
+        if (ra_jobfile_chlist(scratch_string,header->bChIn,  1)) return 1;
+        if (ra_jobfile_chlist(scratch_string,header->bChInCh,1)) return 1;
+        } 
+
+      if (strncmp(keyword,"INCLUDE",7)==0) { /* INCLUDE <list>; same syntax as EXCLUDE */
+        bFoundKeyword=1;
+        scratch_string[0]='\0';
+        sscanf(&(line[i]),"%s %s",keyword,scratch_string);
+        if (ra_jobfile_chlist(scratch_string,header->bChInCh,0)) return 1;
         } 
 
       if (strncmp(keyword,"N_SUB_CH",8)==0) {
@@ -230,6 +303,171 @@ int ra_read_jobfile( char* jobfile,                    /* [in] name of job file
         header->eFBL_Units = temp_char;
         } 
 
+      if (strncmp(keyword,"OUTFILE",7)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %s",keyword,opt->outfile);
+        } 
+
+      if (strncmp(keyword,"OUTFORMAT",9)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %d",keyword,&(opt->eOutFormat));
+        } 
+
+      if (strncmp(keyword,"COL_CHUNK",9)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %d",keyword,&(opt->nColChunk));
+        if (opt->nColChunk<1) {
+          printf("FATAL: In ra_read_jobfile(), COL_CHUNK must be >= 1\n");
+          fclose(fp);
+          return 1;
+          }
+        } 
+
+      if (strncmp(keyword,"STREAM_QUEUE",12)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %ld",keyword,&(opt->nStreamQueue));
+        if (opt->nStreamQueue<(long)(sizeof(struct ra_header_struct)+sizeof(struct ra_td))) {
+          printf("FATAL: In ra_read_jobfile(), STREAM_QUEUE must be at least %ld bytes\n",(long)(sizeof(struct ra_header_struct)+sizeof(struct ra_td)));
+          fclose(fp);
+          return 1;
+          }
+        } else if (strncmp(keyword,"STREAM_POLICY",13)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %d",keyword,&(opt->eStreamPolicy));
+        } else if (strncmp(keyword,"STREAM",6)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %s",keyword,opt->stream);
+        } 
+
+      if (strncmp(keyword,"SHM_SIZE",8)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %ld",keyword,&(opt->nShmSize));
+        } else if (strncmp(keyword,"SHM",3)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %s",keyword,opt->shm);
+        if (opt->shm[0]!='/') {
+          printf("FATAL: In ra_read_jobfile(), SHM name must begin with '/'\n");
+          fclose(fp);
+          return 1;
+          }
+        } 
+
+      if (strncmp(keyword,"SUPPRESS",8)==0) {
+        bFoundKeyword=1;
+        opt->bSuppress = 1;
+        if ( ( sscanf(&(line[i]),"%s %f %f %ld",keyword,&(opt->rSuppressPower),&(opt->dSuppressKurt),&(opt->dSuppressClips)) < 3 ) ||
+             ( opt->rSuppressPower<0 ) || ( opt->dSuppressKurt<0 ) || ( opt->dSuppressClips<0 ) ) {
+          printf("FATAL: In ra_read_jobfile(), SUPPRESS needs <power> <kurtosis> [<clips>], all >= 0\n");
+          fclose(fp);
+          return 1;
+          }
+        } 
+
+      if (strncmp(keyword,"HEARTBEAT",9)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %lf",keyword,&(opt->heartbeat));
+        } 
+
+      if (strncmp(keyword,"STATS",5)==0) { /* STATS <list>; e.g. "STATS power,higher" */
+        bFoundKeyword=1;
+        scratch_string[0]='\0';
+        sscanf(&(line[i]),"%s %s",keyword,scratch_string);
+        if ( (opt->eStats = ra_stats_parse(scratch_string)) <= 0 ) {
+          printf("FATAL: In ra_read_jobfile(), STATS '%s' not understood; use a list of iq, power, stokes, higher, or all\n",scratch_string);
+          fclose(fp);
+          return 1;
+          }
+        } 
+
+      if (strncmp(keyword,"EXACT",5)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %d",keyword,&(opt->bExact));
+        } 
+
+      if (strncmp(keyword,"HOP",3)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %lf",keyword,&(opt->hop));
+        } 
+
+      if (strncmp(keyword,"LAG_BUDGET",10)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %lf",keyword,&(opt->lagBudget));
+        } 
+
+      if (strncmp(keyword,"LAG_LADDER",10)==0) { /* LAG_LADDER <list>; e.g. "higher,subsample,channels" */
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %s",keyword,opt->lagLadder);
+        } 
+
+      if (strncmp(keyword,"LAG_SUBSAMPLE",13)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %ld",keyword,&(opt->nLagSub));
+        } 
+
+      if (strncmp(keyword,"LAG_PRIORITY",12)==0) { /* LAG_PRIORITY <list>; same syntax as EXCLUDE */
+        bFoundKeyword=1;
+        scratch_string[0]='\0';
+        sscanf(&(line[i]),"%s %s",keyword,scratch_string);
+        if (ra_jobfile_chlist(scratch_string,opt->bChLagPriority,1)) return 1;
+        opt->bLagPriority = 1;
+        } 
+
+      if (strncmp(keyword,"MAX_MEMORY",10)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %lf",keyword,&(opt->maxMemory));
+        if (opt->maxMemory<0) {
+          printf("FATAL: In ra_read_jobfile(), MAX_MEMORY must be >= 0\n");
+          fclose(fp);
+          return 1;
+          }
+        } 
+
+      if (strncmp(keyword,"HUGEPAGES",9)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %d",keyword,&(opt->place.eHuge));
+        if ( (opt->place.eHuge<RA_HUGE_NONE) || (opt->place.eHuge>RA_HUGE_TLB) ) {
+          printf("FATAL: In ra_read_jobfile(), HUGEPAGES must be 0, 1, or 2\n");
+          fclose(fp);
+          return 1;
+          }
+        } 
+
+      if (strncmp(keyword,"CPUS",4)==0) { /* CPUS <list>; e.g. "0-7,16" */
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %s",keyword,opt->place.cpus);
+        } 
+
+      if (strncmp(keyword,"NUMA_NODE",9)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %d",keyword,&(opt->place.node));
+        } 
+
+      if (strncmp(keyword,"WORKERS",7)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %d",keyword,&(opt->nWorkers));
+        if ( (opt->nWorkers<0) || (opt->nWorkers>=RA_PROF_MAX_THREADS) ) {
+          printf("FATAL: In ra_read_jobfile(), WORKERS must be 0..%d\n",RA_PROF_MAX_THREADS-1);
+          fclose(fp);
+          return 1;
+          }
+        } 
+
+      if (strncmp(keyword,"CHECKPOINT_FILE",15)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %s",keyword,opt->ckptFile);
+        } else if (strncmp(keyword,"CHECKPOINT",10)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %lf",keyword,&(opt->checkpoint));
+        } 
+
+      if (strncmp(keyword,"PROFILE_FILE",12)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %s",keyword,opt->profileFile);
+        } else if (strncmp(keyword,"PROFILE",7)==0) {
+        bFoundKeyword=1;
+        sscanf(&(line[i]),"%s %lf",keyword,&(opt->profile));
+        } 
+
       if (!bFoundKeyword) {
         printf("FATAL: In ra_read_jobfile(), keyword '%s' not recognized\n",keyword);
         fclose(fp);
@@ -243,12 +481,43 @@ int ra_read_jobfile( char* jobfile,                    /* [in] name of job file
   /* close the jobfile */
   fclose(fp);
 
+  if (!opt->ckptFile[0]) snprintf(opt->ckptFile,RA_MAX_FILENAME_LENGTH,"%s.ckpt",opt->outfile);
+
   return 0;
   }
 
 //==================================================================================
 //=== HISTORY ======================================================================
 //==================================================================================
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added CHECKPOINT, CHECKPOINT_FILE
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added WORKERS
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added HUGEPAGES, CPUS, NUMA_NODE
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added MAX_MEMORY
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added LAG_BUDGET, LAG_LADDER, LAG_SUBSAMPLE, LAG_PRIORITY
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added PROFILE, PROFILE_FILE
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added EXACT
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added HOP
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added STATS
+// ra_read_jobfile.c: 2026 Oct 19
+// -- EXCLUDE and INCLUDE accept channel lists and ranges (ra_jobfile_chlist()); repeating a channel no longer
+//    corrupts bChIn, and INCLUDE of a channel that was not EXCLUDE'd no longer sets its bit
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added SUPPRESS, HEARTBEAT
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added SHM, SHM_SIZE
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added STREAM, STREAM_QUEUE, STREAM_POLICY
+// ra_read_jobfile.c: 2026 Oct 19
+// -- added struct ra_opt_struct; OUTFILE, OUTFORMAT, COL_CHUNK
 // ra_read_jobfile.c: S.W. Ellingson, Virginia Tech, 2014 Jan 19
 // -- removed oflags
 // ra_read_jobfile.c: S.W. Ellingson, Virginia Tech, 2014 Jan 18
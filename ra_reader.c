@@ -0,0 +1,380 @@
+/*===============================================================
+ra_reader.c: 2026 Oct 19
+random access to report files written by frsc (any OUTFORMAT)
+---
+The file is mmap()'ed and an index is built which locates each "unit" of the file: the smallest
+piece that can be read on its own.  A unit is a report (OUTFORMAT 0), a frame (OUTFORMAT 1) or
+a chunk (OUTFORMAT 2).  The index records the position, iSeqNo and fStart of the first report in
+each unit, so reports can be found by iSeqNo or time by binary search.
+For OUTFORMAT 0 files, building the index means reading every header, so the index is saved
+to "<file>.idx" and reused (and extended, if the file has grown) the next time.  Frames and
+chunks are few, so their index is always built on the fly.
+================================================================*/
+
+#define RF_PLAIN   0 /* report file written with OUTFORMAT 0 */
+#define RF_FRAMED  1 /* report file written with OUTFORMAT 1 */
+#define RF_COLUMNS 2 /* report file written with OUTFORMAT 2 */
+
+#define RI_MAGIC 0x49435352 /* "RSCI"; first field of a .idx file */
+
+/* an index entry */
+struct ri_entry_struct {
+  long int offset;    /* [bytes] position of unit from beginning of file */
+  long int iSeqNo;    /* iSeqNo of first report in unit */
+  double fStart;      /* fStart of first report in unit */
+  long int nReports;  /* number of reports in unit */
+  };
+
+/* beginning of a .idx file; followed by nEntries struct ri_entry_struct */
+struct ri_head_struct {
+  int magic;              /* =RI_MAGIC */
+  int eKind;              /* RF_PLAIN */
+  long int ino;           /* inode of the report file when indexed */
+  long int nBytesIndexed; /* [bytes] of the report file covered by the index */
+  long int nEntries;
+  };
+
+/* an open report file */
+struct rf_struct {
+  int eKind;                          /* RF_... */
+  int fd;
+  unsigned char *p;                   /* the file, mmap'ed */
+  long int size;                      /* [bytes] size of file when mmap'ed */
+  long int ino;                       /* inode */
+  struct ri_entry_struct *entry;      /* the index */
+  long int nEntries;
+  long int nEntriesMax;
+  long int nBytesIndexed;             /* [bytes] units wholly contained within this many bytes are indexed */
+  struct ra_header_struct header0;    /* header of first report in file */
+  struct ra_col_file_struct *colfile; /* file header; RF_COLUMNS only */
+  };
+
+/*==============================================================*/
+/*=== ri_add() =================================================*/
+/*==============================================================*/
+
+int ri_add( struct rf_struct *rf, long int offset, long int iSeqNo, double fStart, long int nReports ) {
+  if (rf->nEntries>=rf->nEntriesMax) {
+    rf->nEntriesMax = (rf->nEntriesMax<1024) ? 1024 : 2*rf->nEntriesMax;
+    if ( (rf->entry = realloc( rf->entry, rf->nEntriesMax*sizeof(struct ri_entry_struct) )) == NULL ) {
+      printf("FATAL: ri_add(): realloc() failed\n");
+      return 1;
+      }
+    }
+  rf->entry[rf->nEntries].offset   = offset;
+  rf->entry[rf->nEntries].iSeqNo   = iSeqNo;
+  rf->entry[rf->nEntries].fStart   = fStart;
+  rf->entry[rf->nEntries].nReports = nReports;
+  rf->nEntries++;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== rf_map() =================================================*/
+/*==============================================================*/
+/* (re)maps the file, e.g. after it has grown.  returns 0 if OK, 1 otherwise */
+
+int rf_map( struct rf_struct *rf ) {
+  struct stat st;
+  if (rf->p!=NULL) { munmap(rf->p,rf->size); rf->p = NULL; }
+  fstat(rf->fd,&st);
+  rf->size = st.st_size;
+  rf->ino  = st.st_ino;
+  if (rf->size==0) return 1;
+  if ( (rf->p = mmap( NULL, rf->size, PROT_READ, MAP_SHARED, rf->fd, 0 )) == MAP_FAILED ) {
+    rf->p = NULL;
+    printf("FATAL: rf_map(): mmap() failed\n");
+    return 1;
+    }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ri_scan_plain() ==========================================*/
+/*==============================================================*/
+/* indexes reports from rf->nBytesIndexed to the end of the last complete report */
+
+int ri_scan_plain( struct rf_struct *rf ) {
+  struct ra_header_struct *h;
+  long int pos = rf->nBytesIndexed;
+  long int nBody;
+  while (pos+sizeof(struct ra_header_struct)<=rf->size) {
+    h = (struct ra_header_struct *) &(rf->p[pos]);
+    nBody = ra_body_size(h);
+    if (nBody<0) {
+      printf("WARNING: ri_scan_plain(): don't know how long a report of eType=%d is; stopping at byte %ld\n",h->eType,pos);
+      break;
+      }
+    if (pos+sizeof(struct ra_header_struct)+nBody>rf->size) break; /* incomplete; e.g. still being written */
+    if (ri_add( rf, pos, h->iSeqNo, h->fStart, 1 )) return 1;
+    pos += sizeof(struct ra_header_struct) + nBody;
+    }
+  rf->nBytesIndexed = pos;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ri_scan_framed() =========================================*/
+/*==============================================================*/
+/* indexes frames from rf->nBytesIndexed; uses the frame index at the end of the file if there is one */
+
+int ri_scan_framed( struct rf_struct *rf ) {
+  struct ra_frame_struct *f;
+  struct ra_frame_tail_struct *tail;
+  struct ra_frame_index_struct *fi;
+  long int pos = rf->nBytesIndexed;
+  long int i;
+
+  /* complete file: use the frame index */
+  if ( (pos==0) && (rf->size>=sizeof(struct ra_frame_tail_struct)) ) {
+    tail = (struct ra_frame_tail_struct *) &(rf->p[rf->size-sizeof(struct ra_frame_tail_struct)]);
+    if ( (tail->magic==RA_FRAME_TAIL_MAGIC) && (tail->offset+tail->nFrames*sizeof(struct ra_frame_index_struct)+sizeof(struct ra_frame_tail_struct)==rf->size) ) {
+      fi = (struct ra_frame_index_struct *) &(rf->p[tail->offset]);
+      for (i=0;i<tail->nFrames;i++) {
+        if (ri_add( rf, fi[i].offset, fi[i].iSeqNo, fi[i].fStart, fi[i].nReports )) return 1;
+        }
+      rf->nBytesIndexed = rf->size;
+      return 0;
+      }
+    }
+
+  /* otherwise walk the frames */
+  while (pos+sizeof(struct ra_frame_struct)<=rf->size) {
+    f = (struct ra_frame_struct *) &(rf->p[pos]);
+    if (f->magic!=RA_FRAME_MAGIC) break;                                 /* frame index, or garbage */
+    if (pos+sizeof(struct ra_frame_struct)+f->nComp>rf->size) break;     /* incomplete */
+    if (ri_add( rf, pos, f->iSeqNo, f->fStart, f->nReports )) return 1;
+    pos += sizeof(struct ra_frame_struct) + f->nComp;
+    }
+  rf->nBytesIndexed = pos;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ri_scan_columns() ========================================*/
+/*==============================================================*/
+/* indexes chunks from rf->nBytesIndexed */
+
+int ri_scan_columns( struct rf_struct *rf ) {
+  struct ra_col_chunk_struct *c;
+  long int pos = rf->nBytesIndexed;
+  if (pos==0) pos = sizeof(struct ra_col_file_struct);
+  while (pos+sizeof(struct ra_col_chunk_struct)<=rf->size) {
+    c = (struct ra_col_chunk_struct *) &(rf->p[pos]);
+    if (c->magic!=RA_COL_CHUNK_MAGIC) break;
+    if (pos+sizeof(struct ra_col_chunk_struct)+c->nBytes>rf->size) break; /* incomplete */
+    if (ri_add( rf, pos, c->iSeqNo, c->fStart, c->nRec )) return 1;
+    pos += sizeof(struct ra_col_chunk_struct) + c->nBytes;
+    }
+  rf->nBytesIndexed = pos;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ri_load() ================================================*/
+/*==============================================================*/
+/* loads a saved index of an OUTFORMAT 0 file, if there is one that is consistent with the file.  */
+/* returns 1 if loaded, 0 if not */
+
+int ri_load( struct rf_struct *rf, char *idxfile ) {
+  FILE *fp;
+  struct ri_head_struct head;
+  struct ri_entry_struct *e;
+  struct ra_header_struct *h;
+
+  if (!(fp = fopen(idxfile,"rb"))) return 0;
+  if ( (fread( &head, sizeof(head), 1, fp ) != 1) || (head.magic!=RI_MAGIC) || (head.eKind!=rf->eKind) ||
+       (head.ino!=rf->ino) || (head.nBytesIndexed>rf->size) || (head.nEntries<1) ) {
+    fclose(fp);
+    return 0;
+    }
+  rf->nEntriesMax = head.nEntries;
+  rf->entry = malloc( head.nEntries*sizeof(struct ri_entry_struct) );
+  if ( (rf->entry==NULL) || (fread( rf->entry, sizeof(struct ri_entry_struct), head.nEntries, fp ) != head.nEntries) ) {
+    fclose(fp);
+    free(rf->entry); rf->entry = NULL; rf->nEntriesMax = 0;
+    return 0;
+    }
+  fclose(fp);
+
+  /* sanity check: the last report indexed must still be where the index says it is */
+  e = &(rf->entry[head.nEntries-1]);
+  h = (struct ra_header_struct *) &(rf->p[e->offset]);
+  if ( (e->offset+sizeof(struct ra_header_struct)>rf->size) || (h->iSeqNo!=e->iSeqNo) || (h->fStart!=e->fStart) ) {
+    free(rf->entry); rf->entry = NULL; rf->nEntriesMax = 0;
+    return 0;
+    }
+
+  rf->nEntries = head.nEntries;
+  rf->nBytesIndexed = head.nBytesIndexed;
+  return 1;
+  }
+
+/*==============================================================*/
+/*=== ri_save() ================================================*/
+/*==============================================================*/
+/* saves the index of an OUTFORMAT 0 file.  Failure (e.g., read-only directory) is not an error. */
+
+void ri_save( struct rf_struct *rf, char *idxfile ) {
+  FILE *fp;
+  struct ri_head_struct head;
+  if (!(fp = fopen(idxfile,"wb"))) return;
+  memset(&head,0,sizeof(head));
+  head.magic = RI_MAGIC;
+  head.eKind = rf->eKind;
+  head.ino = rf->ino;
+  head.nBytesIndexed = rf->nBytesIndexed;
+  head.nEntries = rf->nEntries;
+  fwrite( &head, sizeof(head), 1, fp );
+  fwrite( rf->entry, sizeof(struct ri_entry_struct), rf->nEntries, fp );
+  fclose(fp);
+  }
+
+/*==============================================================*/
+/*=== rf_index() ===============================================*/
+/*==============================================================*/
+/* brings the index up to date with the (possibly grown) file.  returns 0 if OK, 1 otherwise */
+
+int rf_index( struct rf_struct *rf, char *idxfile ) {
+  long int nBefore = rf->nBytesIndexed;
+  switch (rf->eKind) {
+    case RF_PLAIN:
+      if (ri_scan_plain(rf)) return 1;
+      if ( (idxfile!=NULL) && (rf->nBytesIndexed>nBefore) ) { ri_save(rf,idxfile); }
+      break;
+    case RF_FRAMED:
+      if (ri_scan_framed(rf)) return 1;
+      break;
+    case RF_COLUMNS:
+      if (ri_scan_columns(rf)) return 1;
+      break;
+    }
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== rf_decode_frame() ========================================*/
+/*==============================================================*/
+/* decompresses the frame at entry e into *plain (OUTFORMAT 0 layout), growing the buffers as needed. */
+/* buffers belong to the caller, so threads can decode frames concurrently.  returns bytes in *plain, or -1 */
+
+long int rf_decode_frame(
+                          struct rf_struct *rf,  /* [in] */
+                          long int e,            /* [in] index entry */
+                          unsigned char **plain, /* [in/out] */
+                          unsigned char **raw,   /* [in/out] scratch */
+                          long int *nMax         /* [in/out] bytes allocated for *plain, *raw */
+                          ) {
+  struct ra_frame_struct *f = (struct ra_frame_struct *) &(rf->p[rf->entry[e].offset]);
+  if (f->nRaw>*nMax) {
+    *nMax  = f->nRaw;
+    *plain = realloc( *plain, *nMax );
+    *raw   = realloc( *raw,   *nMax );
+    if ( (*plain==NULL) || (*raw==NULL) ) return -1;
+    }
+  return ra_frame_decode( ((unsigned char *) f) + sizeof(struct ra_frame_struct), f->nComp, f->nRaw, f->nReports, *raw, *plain );
+  }
+
+/*==============================================================*/
+/*=== rf_open() ================================================*/
+/*==============================================================*/
+/* opens and indexes a report file.  idxfile may be NULL (don't save/reuse index).  returns 0 if OK, 1 otherwise */
+
+int rf_open( struct rf_struct *rf, char *infile, char *idxfile ) {
+
+  unsigned char *plain = NULL;
+  unsigned char *raw = NULL;
+  long int nMax = 0;
+  int magic;
+
+  memset(rf,0,sizeof(struct rf_struct));
+  if ( (rf->fd = open(infile,O_RDONLY)) < 0 ) {
+    printf("FATAL: rf_open(): couldn't open '%s'\n",infile);
+    return 1;
+    }
+  if (rf_map(rf) || (rf->size<sizeof(int))) {
+    printf("FATAL: rf_open(): '%s' is empty or can't be mapped\n",infile);
+    return 1;
+    }
+
+  memcpy(&magic,rf->p,sizeof(int));
+  switch (magic) {
+    case RA_FRAME_MAGIC: rf->eKind = RF_FRAMED;  break;
+    case RA_COL_MAGIC:   rf->eKind = RF_COLUMNS; break;
+    default:             rf->eKind = RF_PLAIN;   break;
+    }
+
+  if ( (rf->eKind==RF_PLAIN) && (idxfile!=NULL) ) { ri_load(rf,idxfile); }
+  if (rf_index(rf,idxfile)) return 1;
+
+  /* get the first report's header */
+  switch (rf->eKind) {
+    case RF_PLAIN:
+      if (rf->size<sizeof(struct ra_header_struct)) return 1;
+      memcpy( &(rf->header0), rf->p, sizeof(struct ra_header_struct) );
+      break;
+    case RF_FRAMED:
+      if ( (rf->nEntries<1) || (rf_decode_frame(rf,0,&plain,&raw,&nMax)<(long int) sizeof(struct ra_header_struct)) ) {
+        printf("FATAL: rf_open(): couldn't decode first frame\n");
+        return 1;
+        }
+      memcpy( &(rf->header0), plain, sizeof(struct ra_header_struct) );
+      free(plain); free(raw);
+      break;
+    case RF_COLUMNS:
+      if (rf->size<sizeof(struct ra_col_file_struct)) return 1;
+      rf->colfile = (struct ra_col_file_struct *) rf->p;
+      memcpy( &(rf->header0), &(rf->colfile->header), sizeof(struct ra_header_struct) );
+      break;
+    }
+
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== rf_close() ===============================================*/
+/*==============================================================*/
+
+void rf_close( struct rf_struct *rf ) {
+  if (rf->p!=NULL) { munmap(rf->p,rf->size); rf->p = NULL; }
+  close(rf->fd);
+  free(rf->entry); rf->entry = NULL;
+  }
+
+/*==============================================================*/
+/*=== rf_lower_bound() =========================================*/
+/*==============================================================*/
+/* first entry which may contain a report with fStart >= t and iSeqNo >= s */
+
+long int rf_lower_bound( struct rf_struct *rf, double t, long int s ) {
+  long int lo = 0;
+  long int hi = rf->nEntries;
+  long int mid;
+  while (lo<hi) {
+    mid = (lo+hi)/2;
+    if ( (rf->entry[mid].fStart<t) || (rf->entry[mid].iSeqNo<s) ) { lo = mid+1; } else { hi = mid; }
+    }
+  return (lo>0) ? lo-1 : 0; /* the previous unit may extend past t, s */
+  }
+
+/*==============================================================*/
+/*=== rf_upper_bound() =========================================*/
+/*==============================================================*/
+/* first entry which contains only reports with fStart > t or iSeqNo > s */
+
+long int rf_upper_bound( struct rf_struct *rf, double t, long int s ) {
+  long int lo = 0;
+  long int hi = rf->nEntries;
+  long int mid;
+  while (lo<hi) {
+    mid = (lo+hi)/2;
+    if ( (rf->entry[mid].fStart<=t) && (rf->entry[mid].iSeqNo<=s) ) { lo = mid+1; } else { hi = mid; }
+    }
+  return lo;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_reader.c: 2026 Oct 19
+// -- initial version
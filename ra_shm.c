@@ -0,0 +1,290 @@
+/*===============================================================
+ra_shm.c: 2026 Oct 19
+report ring in shared memory, for consumers on the same host
+---
+If SHM is given in the job file (e.g. "SHM /frsc"), ra_output.c also puts every report into a ring in
+POSIX shared memory of that name (so, /dev/shm/frsc on Linux).  Any number of processes can attach and
+read the reports in place (there is one copy of each report, no matter how many consumers), and frsc
+never waits for them.  frsc_read attaches if given "shm:<name>" as <infile>.
+
+The shared memory is a struct ra_shm_head_struct, padded to RA_SHM_DATA_OFFSET, then SHM_SIZE bytes
+(default RA_SHM_SIZE_DEFAULT) of ring.  Each report in the ring is a struct ra_shm_rec_struct followed by
+the report (header, then body, as in an OUTFORMAT 0 file), padded to a multiple of RA_SHM_ALIGN so
+that the next one is aligned.  A report is never split at the end of the ring; instead a record with
+len = -1 says "continue at the start".  Positions (wpos, tail, a consumer's position) count bytes
+ever written, so they only increase; the place in the ring is position % size.
+
+The producer, before writing over old records, advances tail past them; then writes; then advances wpos.
+A consumer reads records between its position and wpos.  Since frsc doesn't wait, a consumer that falls
+more than a ring behind is overrun: its position is < tail.  A consumer detects this (1) before
+reading a record, in which case it skips ahead to tail, and knows from iSeq how many reports it missed,
+and (2) after it has finished with a record, in which case what it read may have been overwritten while
+it was reading, and it should discard whatever it made of it.  See ra_shm_next() and ra_shm_done().
+================================================================*/
+
+#define RA_SHM_MAGIC         0x4D485352L         /* "RSHM" */
+#define RA_SHM_SIZE_DEFAULT  (64*1024*1024)      /* [bytes] default SHM_SIZE */
+#define RA_SHM_DATA_OFFSET   4096                /* [bytes] ring begins here (after struct ra_shm_head_struct) */
+#define RA_SHM_ALIGN         16                  /* [bytes] records begin on multiples of this */
+
+struct ra_shm_head_struct {
+  long int magic;                    /* RA_SHM_MAGIC */
+  long int size;                     /* [bytes] of ring */
+  long int pid;                      /* of the producer (frsc) */
+  long int wpos;                     /* [bytes] end of last complete record */
+  long int tail;                     /* [bytes] start of oldest record not (being) overwritten */
+  long int nRec;                     /* number of records written; iSeq of the next one */
+  long int bClosed;                  /* =1 when the producer has finished */
+  struct ra_header_struct header0;   /* most recent eType=0 report */
+  };
+
+struct ra_shm_rec_struct {
+  long int iSeq;                     /* 0, 1, 2, ... (a gap means reports were missed) */
+  long int len;                      /* [bytes] of the report following; -1 means "continue at start of ring" */
+  };
+
+/* Producer or consumer state (not shared) */
+struct ra_shm_struct {
+  int bOpen;
+  char name[RA_MAX_FILENAME_LENGTH];
+  struct ra_shm_head_struct *head;  /* the shared memory */
+  unsigned char *ring;               /* = head + RA_SHM_DATA_OFFSET */
+  long int nMap;                     /* [bytes] mapped */
+  /* consumer only: */
+  long int pos;                      /* position of the record being read, or of the next one */
+  long int iSeq;                     /* expected iSeq of the next record */
+  long int nLost;                    /* reports missed so far */
+  };
+
+/*==============================================================*/
+/*=== ra_shm_round() ===========================================*/
+/*==============================================================*/
+/* [bytes] occupied in ring by a record holding a report of len bytes */
+
+long int ra_shm_round( long int len ) {
+  return sizeof(struct ra_shm_rec_struct) + ( (len+RA_SHM_ALIGN-1) / RA_SHM_ALIGN ) * RA_SHM_ALIGN;
+  }
+
+/*==============================================================*/
+/*=== ra_shm_create() ==========================================*/
+/*==============================================================*/
+/* producer: creates the shared memory (replacing any of the same name).  returns 0 if OK, 1 otherwise */
+
+int ra_shm_create(
+                   struct ra_shm_struct *shm, /* [out] */
+                   char *name,                /* [in] e.g. "/frsc" */
+                   long int size              /* [in] [bytes] of ring */
+                   ) {
+
+  int fd;
+
+  memset(shm,0,sizeof(struct ra_shm_struct));
+  strcpy(shm->name,name);
+  size = ( size / RA_SHM_ALIGN ) * RA_SHM_ALIGN;
+  if ( size < 2*ra_shm_round( sizeof(struct ra_header_struct) + sizeof(struct ra_td) ) ) {
+    printf("FATAL: ra_shm_create(): SHM_SIZE %ld is too small\n",size);
+    return 1;
+    }
+  shm->nMap = RA_SHM_DATA_OFFSET + size;
+
+  shm_unlink(name); /* consumers still attached to an old one keep it; new ones get this one */
+  if ( ( (fd = shm_open(name,O_RDWR|O_CREAT|O_EXCL,0644)) < 0 ) || ( ftruncate(fd,shm->nMap) < 0 ) ) {
+    printf("FATAL: ra_shm_create(): couldn't create shared memory '%s'\n",name);
+    return 1;
+    }
+  shm->head = mmap( NULL, shm->nMap, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0 );
+  close(fd);
+  if (shm->head==MAP_FAILED) {
+    printf("FATAL: ra_shm_create(): mmap() of '%s' failed\n",name);
+    return 1;
+    }
+  shm->ring = ((unsigned char *) shm->head) + RA_SHM_DATA_OFFSET;
+
+  shm->head->size = size;
+  shm->head->pid  = getpid();
+  __atomic_store_n( &(shm->head->magic), RA_SHM_MAGIC, __ATOMIC_RELEASE ); /* last: now it's ready */
+
+  printf("ra_shm_create(): publishing reports in shared memory '%s' (%f MB)\n",name,size/(1024.0*1024.0));
+  shm->bOpen = 1;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_shm_write() ===========================================*/
+/*==============================================================*/
+/* producer: puts one report in the ring */
+
+void ra_shm_write(
+                   struct ra_shm_struct *shm,       /* [in/out] */
+                   struct ra_header_struct *header, /* [in] report header */
+                   void *body,                      /* [in] report body */
+                   long int nBody                   /* [in] [bytes] in body */
+                   ) {
+
+  struct ra_shm_head_struct *h = shm->head;
+  struct ra_shm_rec_struct *rec;
+  long int len = sizeof(struct ra_header_struct) + nBody;
+  long int n = ra_shm_round(len);
+  long int w;
+  long int skip = 0;
+  long int tail;
+
+  if (!shm->bOpen) return;
+  w = h->wpos;
+  tail = h->tail;
+
+  if ( (header->eType==RA_H_ETYPE_NULL) && !(header->err & (RA_H_ERR_PROFILE|RA_H_ERR_LAG)) ) { memcpy( &(h->header0), header, sizeof(struct ra_header_struct) ); }
+
+  if ( (w%h->size) + n > h->size ) { skip = h->size - (w%h->size); } /* doesn't fit before end of ring */
+
+  /* give up the records that will be written over, before writing over them */
+  while (tail < w+skip+n-h->size) {
+    rec = (struct ra_shm_rec_struct *) &(shm->ring[tail%h->size]);
+    tail += (rec->len<0) ? h->size-(tail%h->size) : ra_shm_round(rec->len);
+    }
+  __atomic_store_n( &(h->tail), tail, __ATOMIC_RELEASE );
+  __atomic_thread_fence( __ATOMIC_SEQ_CST );
+
+  if (skip>0) {
+    rec = (struct ra_shm_rec_struct *) &(shm->ring[w%h->size]);
+    rec->iSeq = h->nRec;
+    rec->len  = -1;
+    w += skip;
+    }
+  rec = (struct ra_shm_rec_struct *) &(shm->ring[w%h->size]);
+  rec->iSeq = h->nRec;
+  rec->len  = len;
+  memcpy( ((unsigned char *) rec) + sizeof(struct ra_shm_rec_struct), header, sizeof(struct ra_header_struct) );
+  if (nBody>0) { memcpy( ((unsigned char *) rec) + sizeof(struct ra_shm_rec_struct) + sizeof(struct ra_header_struct), body, nBody ); }
+
+  h->nRec++;
+  __atomic_store_n( &(h->wpos), w+n, __ATOMIC_RELEASE ); /* publish */
+  }
+
+/*==============================================================*/
+/*=== ra_shm_close() ===========================================*/
+/*==============================================================*/
+/* producer: tells consumers there will be no more, and detaches.  Consumers still attached can finish reading. */
+
+void ra_shm_close( struct ra_shm_struct *shm ) {
+  if (!shm->bOpen) return;
+  __atomic_store_n( &(shm->head->bClosed), 1, __ATOMIC_RELEASE );
+  printf("ra_shm_close(): %ld reports published in '%s'\n",shm->head->nRec,shm->name);
+  munmap( shm->head, shm->nMap );
+  shm_unlink( shm->name );
+  shm->bOpen = 0;
+  }
+
+/*==============================================================*/
+/*=== ra_shm_attach() ==========================================*/
+/*==============================================================*/
+/* consumer: attaches to the shared memory, positioned at the oldest report still in the ring.  returns 0 if OK, 1 otherwise */
+
+int ra_shm_attach(
+                   struct ra_shm_struct *shm, /* [out] */
+                   char *name                 /* [in] */
+                   ) {
+
+  int fd;
+  struct stat st;
+
+  memset(shm,0,sizeof(struct ra_shm_struct));
+  strcpy(shm->name,name);
+  if ((fd = shm_open(name,O_RDONLY,0))<0) return 1;
+  if ( (fstat(fd,&st)<0) || (st.st_size<=RA_SHM_DATA_OFFSET) ) { close(fd); return 1; } /* not ready yet */
+  shm->nMap = st.st_size;
+  shm->head = mmap( NULL, shm->nMap, PROT_READ, MAP_SHARED, fd, 0 );
+  close(fd);
+  if (shm->head==MAP_FAILED) return 1;
+  if ( (__atomic_load_n( &(shm->head->magic), __ATOMIC_ACQUIRE ) != RA_SHM_MAGIC) ||
+       (RA_SHM_DATA_OFFSET+shm->head->size != shm->nMap) ) {
+    munmap( shm->head, shm->nMap );
+    return 1;
+    }
+  shm->ring = ((unsigned char *) shm->head) + RA_SHM_DATA_OFFSET;
+  shm->pos  = __atomic_load_n( &(shm->head->tail), __ATOMIC_ACQUIRE );
+  shm->iSeq = -1; /* don't know yet */
+  shm->bOpen = 1;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_shm_next() ============================================*/
+/*==============================================================*/
+/* consumer: finds the next report.  Returns a pointer to it in the ring (header followed by body), */
+/* or NULL if there isn't one yet.  When done with it, call ra_shm_done(). */
+
+unsigned char *ra_shm_next( struct ra_shm_struct *shm ) {
+
+  struct ra_shm_head_struct *h = shm->head;
+  struct ra_shm_rec_struct rec;
+  long int tail;
+
+  while ( shm->pos < __atomic_load_n( &(h->wpos), __ATOMIC_ACQUIRE ) ) {
+    memcpy( &rec, &(shm->ring[shm->pos%h->size]), sizeof(rec) );
+    __atomic_thread_fence( __ATOMIC_SEQ_CST );
+    tail = __atomic_load_n( &(h->tail), __ATOMIC_ACQUIRE );
+    if (shm->pos<tail) { shm->pos = tail; continue; } /* overrun; rec may be garbage */
+    if (rec.len<0) { shm->pos += h->size - (shm->pos%h->size); continue; }
+    if ( (shm->iSeq>=0) && (rec.iSeq>shm->iSeq) ) { shm->nLost += rec.iSeq - shm->iSeq; }
+    shm->iSeq = rec.iSeq;
+    return &(shm->ring[shm->pos%h->size]) + sizeof(struct ra_shm_rec_struct);
+    }
+  return NULL;
+  }
+
+/*==============================================================*/
+/*=== ra_shm_done() ============================================*/
+/*==============================================================*/
+/* consumer: finished with the report from ra_shm_next().  Returns 0 if it was intact the whole time, */
+/* or 1 if the producer may have written over it in the meantime (in which case it counts as lost). */
+
+int ra_shm_done( struct ra_shm_struct *shm ) {
+
+  struct ra_shm_head_struct *h = shm->head;
+  struct ra_shm_rec_struct *rec = (struct ra_shm_rec_struct *) &(shm->ring[shm->pos%h->size]);
+  long int len = rec->len;
+
+  __atomic_thread_fence( __ATOMIC_SEQ_CST );
+  if (shm->pos < __atomic_load_n( &(h->tail), __ATOMIC_ACQUIRE )) { /* too late; len may be garbage too */
+    shm->pos = __atomic_load_n( &(h->tail), __ATOMIC_ACQUIRE );
+    shm->nLost++;
+    shm->iSeq++;
+    return 1;
+    }
+  shm->pos += ra_shm_round(len);
+  shm->iSeq++;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_shm_finished() ========================================*/
+/*==============================================================*/
+/* consumer: returns 1 if the producer is done (or gone) and everything has been read */
+
+int ra_shm_finished( struct ra_shm_struct *shm ) {
+  struct ra_shm_head_struct *h = shm->head;
+  int bClosed = __atomic_load_n( &(h->bClosed), __ATOMIC_ACQUIRE );
+  if ( !bClosed && (kill(h->pid,0)<0) && (errno==ESRCH) ) bClosed = 1; /* frsc died */
+  return bClosed && ( shm->pos >= __atomic_load_n( &(h->wpos), __ATOMIC_ACQUIRE ) );
+  }
+
+/*==============================================================*/
+/*=== ra_shm_detach() ==========================================*/
+/*==============================================================*/
+
+void ra_shm_detach( struct ra_shm_struct *shm ) {
+  if (!shm->bOpen) return;
+  munmap( shm->head, shm->nMap );
+  shm->bOpen = 0;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_shm.c: 2026 Oct 19
+// -- nor do lag reports (RA_H_ERR_LAG)
+// ra_shm.c: 2026 Oct 19
+// -- profiling reports (eType 0, RA_H_ERR_PROFILE) don't replace header0
+// ra_shm.c: 2026 Oct 19
+// -- initial version
@@ -0,0 +1,158 @@
+/*===============================================================
+ra_slide.c: 2026 Oct 19
+sliding windows: statistics over T0, reported every HOP
+---
+With "HOP <s>" in the job file (0 < HOP < T0), each eType 1 report covers the last T0 seconds, as usual,
+but a report is written every HOP seconds instead of every T0 seconds; e.g. "T0 0.1" and "HOP 0.01" for a
+100 ms window every 10 ms.  T0 is rounded to a whole number of hops.
+
+Data are analyzed once per hop.  For each hop and channel, ra_analyze() makes the exact moment
+accumulators of ra_moments.c (struct MAPstruct), and ra_slide_push() keeps the last nWin of them in a
+ring, along with their sum.  The sum is updated by adding the new hop and subtracting the one that
+falls out of the window; since the sums are integers, this is exact however long frsc runs.  Max and min
+can't be subtracted, so they are found from the nWin hops in the ring.  ra_slide_get() turns the sum
+into statistics with ra_tm_finalize().  So a report costs about the same as with disjoint windows of
+length HOP, rather than T0/HOP times as much.
+
+Statistics are computed in long double from exact sums (as by frsc_read -r, and by the kernels if EXACT
+is 1), so they may differ from those of disjoint windows with float kernels.  max follows the eType 1
+conventions (see ra_kernel_td()).
+STATS selects which statistics are reported; the others are written as 0.
+No eType 1 reports are written until the first nWin hops have been analyzed.
+
+The same machinery analyzes long windows in tiles when memory is bounded (MAX_MEMORY; see ra_mem.c):
+then windows "tumble" rather than slide.  Each window is nWin consecutive tiles, which are merged into
+the sum as they come; once the window is reported, the next tile starts a new sum.  No ring is kept,
+so memory doesn't depend on nWin.
+================================================================*/
+
+struct ra_slide_struct {
+  long int nWin;              /* hops per window */
+  long int nHave;             /* hops in the ring, up to nWin */
+  long int iNext;             /* slot for the next hop */
+  long int nCh;               /* channels; same as the plan */
+  int bTumble;                /* 1: windows are disjoint, and there's no ring (see above) */
+  struct MAPstruct *ring;     /* [nWin*nCh]; hop i, k'th channel of the plan at ring[i*nCh+k]; NULL if bTumble */
+  struct MAPstruct *sum;      /* [nCh]; sum over the ring (except max, min) */
+  double *fStart;             /* [nWin]; fStart of each hop in the ring; if bTumble, [1], that of the first tile */
+  };
+
+/*==============================================================*/
+/*=== ra_slide_init() ==========================================*/
+/*==============================================================*/
+/* returns 0 if OK, 1 if there isn't room in the arena */
+
+int ra_slide_init(
+                   struct ra_slide_struct *s,  /* [out] */
+                   long int nWin,              /* [in] hops per window */
+                   long int nCh,               /* [in] channels in the plan */
+                   int bTumble,                /* [in] 1: tiles of disjoint windows (MAX_MEMORY), rather than hops */
+                   struct ra_arena_struct *a   /* [in/out] where the ring and sums go (see ra_arena.c) */
+                  ) {
+  long int i;
+
+  memset(s,0,sizeof(struct ra_slide_struct));
+  s->nWin = nWin;
+  s->nCh  = nCh;
+  s->bTumble = bTumble;
+  if ( ( !bTumble && ((s->ring = ra_arena_alloc( a, nWin*nCh*sizeof(struct MAPstruct), "sliding windows" )) == NULL) ) ||
+       ( (s->sum    = ra_arena_alloc( a,      nCh*sizeof(struct MAPstruct), "sliding windows" )) == NULL ) ||
+       ( (s->fStart = ra_arena_alloc( a, (bTumble ? 1 : nWin)*sizeof(double), "sliding windows" )) == NULL ) ) {
+    printf("FATAL: ra_slide_init(): no room (nWin=%ld, nCh=%ld)\n",nWin,nCh);
+    return 1;
+    }
+  if (!bTumble) for (i=0;i<nWin*nCh;i++) ra_tm_clear( &(s->ring[i]) );
+  for (i=0;i<nCh;i++)      ra_tm_clear( &(s->sum[i]) );
+
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_slide_push() ==========================================*/
+/*==============================================================*/
+/* adds a hop; m[k] is the k'th channel of the plan.  The oldest hop drops out once the ring is full. */
+/* returns 1 if the ring is full (i.e., there is a whole window to report), 0 if not */
+
+int ra_slide_push( 
+                   struct ra_slide_struct *s,  /* [in/out] */
+                   struct MAPstruct *m,        /* [in] the hop; [nCh] */
+                   double fstart               /* [in] its fStart */
+                  ) {
+  long int k;
+  struct MAPstruct *r;
+
+  if (s->bTumble) { /* the first tile of a window starts a new sum */
+    if (s->nHave==s->nWin) s->nHave = 0;
+    if (s->nHave==0) {
+      for (k=0;k<s->nCh;k++) ra_tm_clear( &(s->sum[k]) );
+      s->fStart[0] = fstart;
+      }
+    for (k=0;k<s->nCh;k++) ra_tm_merge( &(s->sum[k]), &(m[k]) );
+    s->nHave++;
+    return (s->nHave==s->nWin);
+    }
+
+  for (k=0;k<s->nCh;k++) {
+    r = &(s->ring[s->iNext*s->nCh+k]);
+    if (s->nHave==s->nWin) ra_tm_subtract( &(s->sum[k]), r );
+    ra_tm_merge( &(s->sum[k]), &(m[k]) );
+    memcpy( r, &(m[k]), sizeof(struct MAPstruct) );
+    }
+  s->fStart[s->iNext] = fstart;
+  s->iNext = (s->iNext+1) % s->nWin;
+  if (s->nHave<s->nWin) s->nHave++;
+
+  return (s->nHave==s->nWin);
+  }
+
+/*==============================================================*/
+/*=== ra_slide_fstart() ========================================*/
+/*==============================================================*/
+/* fStart of the window; i.e., of the oldest hop in the ring */
+
+double ra_slide_fstart( struct ra_slide_struct *s ) {
+  if ( s->bTumble || (s->nHave<s->nWin) ) return s->fStart[0];
+  return s->fStart[s->iNext];
+  }
+
+/*==============================================================*/
+/*=== ra_slide_get() ===========================================*/
+/*==============================================================*/
+/* statistics of the k'th channel of the plan over the window, as in eType 1 reports (see ra_kernel_td()) */
+
+void ra_slide_get(
+                   struct ra_slide_struct *s,   /* [in] */
+                   long int k,                  /* [in] */
+                   int eStats,                  /* [in] RA_STATS_* bits; statistics not selected are 0 */
+                   struct DAPstruct *d,         /* [out] */
+                   struct clips_struct *clips   /* [out] */
+                  ) {
+  struct MAPstruct m;
+  struct MAstruct *ma = &(m.xi);
+  long int i;
+  int c;
+
+  memcpy( &m, &(s->sum[k]), sizeof(struct MAPstruct) );
+  if (!s->bTumble) for (c=0;c<8;c++) { ma[c].max = -FLT_MAX; ma[c].min = +FLT_MAX; } /* (if bTumble, max and min were merged) */
+  if (!s->bTumble) for (i=0;i<s->nHave;i++) {
+    for (c=0;c<8;c++) {
+      if ( (&(s->ring[i*s->nCh+k].xi))[c].max > ma[c].max ) ma[c].max = (&(s->ring[i*s->nCh+k].xi))[c].max;
+      if ( (&(s->ring[i*s->nCh+k].xi))[c].min < ma[c].min ) ma[c].min = (&(s->ring[i*s->nCh+k].xi))[c].min;
+      }
+    }
+  ra_kernel_td( &m, eStats, d, clips );
+
+  return;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_slide.c: 2026 Oct 19
+// -- ring and sums are taken from an arena (ra_arena.c); ra_slide_free() is gone
+// ra_slide.c: 2026 Oct 19
+// -- tumbling windows, for tiles (bTumble; MAX_MEMORY, ra_mem.c)
+// ra_slide.c: 2026 Oct 19
+// -- ra_slide_get() uses ra_kernel_td()
+// ra_slide.c: 2026 Oct 19
+// -- initial version
@@ -0,0 +1,360 @@
+/*===============================================================
+ra_stream.c: 2026 Oct 19
+publishing reports to subscribers over a socket
+---
+If STREAM is given in the job file, ra_output.c also hands every report to ra_stream_write(), which
+sends it to any number of subscribers connected to a Unix-domain or TCP socket:
+  STREAM unix:<path>          e.g. "STREAM unix:/tmp/frsc.sock"
+  STREAM tcp:[<host>:]<port>  e.g. "STREAM tcp:5000" (all interfaces) or "STREAM tcp:127.0.0.1:5000"
+What a subscriber receives is the same as an OUTFORMAT 0 file (reports one after another, uncompressed),
+regardless of OUTFORMAT: the most recent eType=0 report (other than profiling reports; see ra_prof.c) first, then every report from the time it connects.
+So the received bytes can be saved and read with frsc_read.  See frsc_sub.c for a minimal subscriber.
+
+Nothing here ever blocks.  Each subscriber has its own queue of at most STREAM_QUEUE bytes, and
+sockets are written with non-blocking send().  If a subscriber can't keep up and its queue fills,
+STREAM_POLICY says what happens:
+  0 (default): the oldest whole reports in its queue are dropped (counted, and reported at close)
+  1:           the subscriber is disconnected
+A report is never dropped once sending of it has begun, so subscribers always see whole reports.
+Subscribers are accepted, and queues drained, whenever a report is written.
+================================================================*/
+
+#define RA_STREAM_MAX_SUBS       16                /* max number of simultaneous subscribers */
+#define RA_STREAM_QUEUE_DEFAULT  (8*1024*1024)     /* [bytes] default STREAM_QUEUE */
+#define RA_STREAM_POLICY_DROP        0             /* drop oldest reports of a slow subscriber */
+#define RA_STREAM_POLICY_DISCONNECT  1             /* disconnect a slow subscriber */
+#define RA_STREAM_CLOSE_WAIT_MS  1000              /* [ms] at close, max time to wait for queues to drain */
+
+struct ra_sub_struct {
+  int fd;                /* socket; -1 if this slot is free */
+  unsigned char *q;      /* queued bytes; q[0..nPartial) is the unsent remainder of a report already begun */
+  long int nq;           /* [bytes] in q */
+  long int nPartial;     /* [bytes] see above */
+  long int nDropped;     /* number of reports dropped */
+  };
+
+struct ra_stream_struct {
+  int bOpen;
+  int fdListen;                              /* listening socket */
+  char path[RA_MAX_FILENAME_LENGTH];         /* for unix: sockets, to unlink() at close; else empty */
+  long int nQueueMax;                        /* [bytes] STREAM_QUEUE */
+  int ePolicy;                               /* RA_STREAM_POLICY_... */
+  struct ra_sub_struct sub[RA_STREAM_MAX_SUBS];
+  struct ra_header_struct header0;           /* most recent eType=0 report; sent first to new subscribers */
+  int bHeader0;
+  long int nSubsTotal;                       /* subscribers accepted so far */
+  long int nDroppedTotal;                    /* reports dropped, all subscribers */
+  long int nDisconnected;                    /* subscribers disconnected for being slow */
+  };
+
+/*==============================================================*/
+/*=== ra_stream_open() =========================================*/
+/*==============================================================*/
+/* returns 0 if OK, 1 otherwise */
+
+int ra_stream_open(
+                    struct ra_stream_struct *s, /* [out] */
+                    char *addr,                 /* [in] "unix:<path>" or "tcp:[<host>:]<port>" */
+                    long int nQueueMax,         /* [in] [bytes] per-subscriber queue limit */
+                    int ePolicy                 /* [in] RA_STREAM_POLICY_... */
+                    ) {
+
+  struct sockaddr_un saun;
+  struct sockaddr_in sain;
+  struct hostent *he;
+  char host[RA_MAX_FILENAME_LENGTH];
+  char *colon;
+  int port;
+  int i;
+  int one = 1;
+
+  memset(s,0,sizeof(struct ra_stream_struct));
+  s->fdListen = -1;
+  s->nQueueMax = nQueueMax;
+  s->ePolicy = ePolicy;
+  for (i=0;i<RA_STREAM_MAX_SUBS;i++) s->sub[i].fd = -1;
+
+  if ( (ePolicy!=RA_STREAM_POLICY_DROP) && (ePolicy!=RA_STREAM_POLICY_DISCONNECT) ) {
+    printf("FATAL: ra_stream_open(): STREAM_POLICY %d not recognized\n",ePolicy);
+    return 1;
+    }
+
+  if (strncmp(addr,"unix:",5)==0) {
+
+    if (strlen(&(addr[5]))>=sizeof(saun.sun_path)) {
+      printf("FATAL: ra_stream_open(): socket path '%s' is too long\n",&(addr[5]));
+      return 1;
+      }
+    memset(&saun,0,sizeof(saun));
+    saun.sun_family = AF_UNIX;
+    strcpy(saun.sun_path,&(addr[5]));
+    unlink(saun.sun_path); /* left over from a previous run */
+    if ( ( (s->fdListen = socket(AF_UNIX,SOCK_STREAM,0)) < 0 ) ||
+         ( bind(s->fdListen,(struct sockaddr *) &saun,sizeof(saun)) < 0 ) ) {
+      printf("FATAL: ra_stream_open(): couldn't create socket '%s'\n",saun.sun_path);
+      return 1;
+      }
+    strcpy(s->path,saun.sun_path);
+
+  } else if (strncmp(addr,"tcp:",4)==0) {
+
+    memset(&sain,0,sizeof(sain));
+    sain.sin_family = AF_INET;
+    sain.sin_addr.s_addr = htonl(INADDR_ANY);
+    strcpy(host,&(addr[4]));
+    if ((colon = strrchr(host,':'))!=NULL) {
+      *colon = '\0';
+      port = atoi(colon+1);
+      if ((he = gethostbyname(host))==NULL) {
+        printf("FATAL: ra_stream_open(): couldn't resolve '%s'\n",host);
+        return 1;
+        }
+      memcpy(&(sain.sin_addr),he->h_addr_list[0],sizeof(sain.sin_addr));
+    } else {
+      port = atoi(host);
+    }
+    if ( (port<1) || (port>65535) ) {
+      printf("FATAL: ra_stream_open(): bad port in '%s'\n",addr);
+      return 1;
+      }
+    sain.sin_port = htons(port);
+    if ( ( (s->fdListen = socket(AF_INET,SOCK_STREAM,0)) < 0 ) ||
+         ( setsockopt(s->fdListen,SOL_SOCKET,SO_REUSEADDR,&one,sizeof(one)) < 0 ) ||
+         ( bind(s->fdListen,(struct sockaddr *) &sain,sizeof(sain)) < 0 ) ) {
+      printf("FATAL: ra_stream_open(): couldn't bind to '%s'\n",addr);
+      return 1;
+      }
+
+  } else {
+    printf("FATAL: ra_stream_open(): STREAM '%s' not recognized; expecting unix:<path> or tcp:[<host>:]<port>\n",addr);
+    return 1;
+  }
+
+  if ( ( listen(s->fdListen,RA_STREAM_MAX_SUBS) < 0 ) ||
+       ( fcntl(s->fdListen,F_SETFL,fcntl(s->fdListen,F_GETFL)|O_NONBLOCK) < 0 ) ) {
+    printf("FATAL: ra_stream_open(): listen() on '%s' failed\n",addr);
+    return 1;
+    }
+
+  signal(SIGPIPE,SIG_IGN); /* a subscriber going away is not our problem */
+
+  printf("ra_stream_open(): publishing reports on '%s'\n",addr);
+  s->bOpen = 1;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_stream_len() ==========================================*/
+/*==============================================================*/
+/* [bytes] of the report that begins at p */
+
+long int ra_stream_len( unsigned char *p ) {
+  struct ra_header_struct h;
+  memcpy( &h, p, sizeof(struct ra_header_struct) ); /* p isn't necessarily aligned */
+  return sizeof(struct ra_header_struct) + ra_body_size(&h);
+  }
+
+/*==============================================================*/
+/*=== ra_stream_drop() =========================================*/
+/*==============================================================*/
+/* disconnects a subscriber */
+
+void ra_stream_drop( struct ra_stream_struct *s, struct ra_sub_struct *sub ) {
+  close(sub->fd);
+  free(sub->q);
+  s->nDroppedTotal += sub->nDropped;
+  memset(sub,0,sizeof(struct ra_sub_struct));
+  sub->fd = -1;
+  }
+
+/*==============================================================*/
+/*=== ra_stream_send() =========================================*/
+/*==============================================================*/
+/* sends as much of a subscriber's queue as the socket will take without blocking */
+
+void ra_stream_send( struct ra_stream_struct *s, struct ra_sub_struct *sub ) {
+
+  long int n;
+  long int k;
+  long int len;
+
+  while (sub->nq>0) {
+    n = send( sub->fd, sub->q, sub->nq, MSG_DONTWAIT | MSG_NOSIGNAL );
+    if (n<0) {
+      if ( (errno==EAGAIN) || (errno==EWOULDBLOCK) ) return;
+      if (errno==EINTR) continue;
+      ra_stream_drop(s,sub); /* gone */
+      return;
+      }
+
+    /* work out where the next report boundary now is */
+    if (n<=sub->nPartial) {
+        sub->nPartial -= n;
+      } else {
+        k = sub->nPartial;
+        while (1) {
+          len = ra_stream_len(&(sub->q[k]));
+          if (k+len>n) { sub->nPartial = k+len-n; break; }
+          k += len;
+          if (k==n) { sub->nPartial = 0; break; }
+          }
+      }
+    memmove( sub->q, &(sub->q[n]), sub->nq-n );
+    sub->nq -= n;
+    }
+
+  }
+
+/*==============================================================*/
+/*=== ra_stream_enqueue() ======================================*/
+/*==============================================================*/
+/* adds a report to a subscriber's queue, applying the policy if there isn't room */
+
+void ra_stream_enqueue(
+                        struct ra_stream_struct *s,
+                        struct ra_sub_struct *sub,
+                        struct ra_header_struct *header, /* [in] */
+                        void *body,                      /* [in] */
+                        long int nBody                   /* [in] [bytes] */
+                        ) {
+
+  long int n = sizeof(struct ra_header_struct) + nBody;
+  long int len;
+
+  while ( (sub->nq+n>s->nQueueMax) && (sub->nq>sub->nPartial) ) {
+    if (s->ePolicy==RA_STREAM_POLICY_DISCONNECT) {
+      printf("ra_stream_enqueue(): subscriber not keeping up; disconnecting\n");
+      s->nDisconnected++;
+      ra_stream_drop(s,sub);
+      return;
+      }
+    /* drop the oldest report not yet begun */
+    len = ra_stream_len(&(sub->q[sub->nPartial]));
+    memmove( &(sub->q[sub->nPartial]), &(sub->q[sub->nPartial+len]), sub->nq-sub->nPartial-len );
+    sub->nq -= len;
+    sub->nDropped++;
+    }
+  if (sub->nq+n>s->nQueueMax) { /* only a report already begun is queued, or this one is larger than the limit */
+    if (s->ePolicy==RA_STREAM_POLICY_DISCONNECT) {
+      s->nDisconnected++;
+      ra_stream_drop(s,sub);
+      return;
+      }
+    sub->nDropped++;
+    return;
+    }
+
+  memcpy( &(sub->q[sub->nq]), header, sizeof(struct ra_header_struct) );
+  if (nBody>0) { memcpy( &(sub->q[sub->nq+sizeof(struct ra_header_struct)]), body, nBody ); }
+  sub->nq += n;
+  }
+
+/*==============================================================*/
+/*=== ra_stream_accept() =======================================*/
+/*==============================================================*/
+/* accepts any subscribers waiting to connect */
+
+void ra_stream_accept( struct ra_stream_struct *s ) {
+
+  int fd;
+  int i;
+
+  while ((fd = accept(s->fdListen,NULL,NULL))>=0) {
+    for (i=0;i<RA_STREAM_MAX_SUBS;i++) { if (s->sub[i].fd<0) break; }
+    if ( (i>=RA_STREAM_MAX_SUBS) || ((s->sub[i].q = malloc(s->nQueueMax))==NULL) ) {
+      printf("ra_stream_accept(): can't take another subscriber; refused\n");
+      close(fd);
+      continue;
+      }
+    fcntl(fd,F_SETFL,fcntl(fd,F_GETFL)|O_NONBLOCK);
+    s->sub[i].fd = fd;
+    s->nSubsTotal++;
+    if (s->bHeader0) ra_stream_enqueue( s, &(s->sub[i]), &(s->header0), NULL, 0 );
+    }
+
+  }
+
+/*==============================================================*/
+/*=== ra_stream_write() ========================================*/
+/*==============================================================*/
+/* queues one report for every subscriber, then sends what can be sent */
+
+void ra_stream_write(
+                      struct ra_stream_struct *s,      /* [in/out] */
+                      struct ra_header_struct *header, /* [in] report header */
+                      void *body,                      /* [in] report body */
+                      long int nBody                   /* [in] [bytes] in body */
+                      ) {
+
+  int i;
+
+  if (!s->bOpen) return;
+
+  ra_stream_accept(s); /* before header0 is updated, so new subscribers don't get this report twice */
+
+  if ( (header->eType==RA_H_ETYPE_NULL) && !(header->err & (RA_H_ERR_PROFILE|RA_H_ERR_LAG)) ) {
+    memcpy( &(s->header0), header, sizeof(struct ra_header_struct) );
+    s->bHeader0 = 1;
+    }
+
+  for (i=0;i<RA_STREAM_MAX_SUBS;i++) {
+    if (s->sub[i].fd<0) continue;
+    ra_stream_enqueue( s, &(s->sub[i]), header, body, nBody );
+    if (s->sub[i].fd>=0) ra_stream_send( s, &(s->sub[i]) );
+    }
+
+  }
+
+/*==============================================================*/
+/*=== ra_stream_close() ========================================*/
+/*==============================================================*/
+/* gives subscribers a moment to collect what's queued for them, then disconnects them */
+
+void ra_stream_close( struct ra_stream_struct *s ) {
+
+  struct pollfd pfd[RA_STREAM_MAX_SUBS];
+  int iSub[RA_STREAM_MAX_SUBS];
+  int nPending;
+  int i;
+  long int nWaited = 0;
+
+  if (!s->bOpen) return;
+
+  while (nWaited<RA_STREAM_CLOSE_WAIT_MS) {
+    nPending = 0;
+    for (i=0;i<RA_STREAM_MAX_SUBS;i++) {
+      if ( (s->sub[i].fd>=0) && (s->sub[i].nq>0) ) {
+        pfd[nPending].fd = s->sub[i].fd;
+        pfd[nPending].events = POLLOUT;
+        iSub[nPending] = i;
+        nPending++;
+        }
+      }
+    if (nPending==0) break;
+    poll( pfd, nPending, 100 );
+    nWaited += 100;
+    for (i=0;i<nPending;i++) {
+      if (pfd[i].revents) ra_stream_send( s, &(s->sub[iSub[i]]) );
+      }
+    }
+
+  for (i=0;i<RA_STREAM_MAX_SUBS;i++) {
+    if (s->sub[i].fd>=0) ra_stream_drop( s, &(s->sub[i]) );
+    }
+  close(s->fdListen);
+  if (s->path[0]) unlink(s->path);
+
+  printf("ra_stream_close(): %ld subscribers; %ld reports dropped; %ld disconnected for falling behind\n",
+    s->nSubsTotal,s->nDroppedTotal,s->nDisconnected);
+  s->bOpen = 0;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_stream.c: 2026 Oct 19
+// -- nor do lag reports (RA_H_ERR_LAG)
+// ra_stream.c: 2026 Oct 19
+// -- profiling reports (eType 0, RA_H_ERR_PROFILE) don't replace header0
+// ra_stream.c: 2026 Oct 19
+// -- initial version
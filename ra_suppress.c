@@ -0,0 +1,176 @@
+/*===============================================================
+ra_suppress.c: 2026 Oct 19
+change-triggered suppression of eType 1 reports
+---
+If SUPPRESS is given in the job file, an eType 1 report is written only if, for some analyzed channel,
+its statistics differ from those of the last eType 1 report written (the reference) by more than:
+  SUPPRESS <power> <kurtosis> [<clips>]
+    <power>:    relative change in xm2.mean or ym2.mean; e.g. 0.05 for 5%.  0 means don't test.
+    <kurtosis>: absolute change in the excess kurtosis of xi, xq, yi, or yq; e.g. 0.1.  0 means don't test.
+    <clips>:    change in clips.x or clips.y; e.g. 100.  0 or omitted means don't test.
+or if HEARTBEAT seconds (default 1) have passed since
+the last eType 1 report written.  Otherwise the report is suppressed.  Since the reference is the last
+report written (not a running average), a reader knows that every suppressed window was within the
+thresholds of the report preceding it.
+
+The number of windows suppressed before a report is written is in bits 32-63 of that report's err, and
+bit 0 of err is set if it was written only because HEARTBEAT expired (see ra_format_defines.h).  Windows
+suppressed at the end of a run are counted in an eType 0 report written at close.  eType 7 (moments)
+reports are never suppressed, so intervals can still be rebinned exactly (frsc_read -r).
+================================================================*/
+
+#define RA_SUPP_HEARTBEAT_DEFAULT 1.0 /* [s] */
+
+struct ra_supp_struct {
+  int bOn;
+  float rPower;                   /* SUPPRESS <power> */
+  float dKurt;                    /* SUPPRESS <kurtosis> */
+  long int dClips;                /* SUPPRESS <clips> */
+  double heartbeat;               /* [s] HEARTBEAT */
+  struct ra_td *ref;              /* last eType 1 report written */
+  double fStartRef;               /* its fStart */
+  int bRef;                       /* is there a reference yet? */
+  long int nSuppressed;           /* windows suppressed since the reference */
+  long int nSuppressedTotal;
+  long int nWritten;
+  struct ra_header_struct last;   /* header of last report seen (written or not) */
+  };
+
+/*==============================================================*/
+/*=== ra_supp_init() ===========================================*/
+/*==============================================================*/
+/* returns 0 if OK, 1 otherwise */
+
+int ra_supp_init(
+                  struct ra_supp_struct *s, /* [out] */
+                  float rPower,             /* [in] see above; 0 = don't test */
+                  float dKurt,              /* [in] see above; 0 = don't test */
+                  long int dClips,          /* [in] see above; 0 = don't test */
+                  double heartbeat          /* [in] [s] */
+                  ) {
+  memset(s,0,sizeof(struct ra_supp_struct));
+  s->rPower = rPower;
+  s->dKurt = dKurt;
+  s->dClips = dClips;
+  s->heartbeat = heartbeat;
+  if ( (s->ref = malloc(sizeof(struct ra_td))) == NULL ) {
+    printf("FATAL: ra_supp_init(): malloc() of ref failed\n");
+    return 1;
+    }
+  s->bOn = 1;
+  printf("ra_supp_init(): suppressing eType 1 reports within %f (power), %f (kurtosis), %ld (clips) of the last; heartbeat %f s\n",rPower,dKurt,dClips,heartbeat);
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_supp_changed() ========================================*/
+/*==============================================================*/
+/* returns 1 if td differs from the reference by more than the thresholds, 0 otherwise */
+
+int ra_supp_changed(
+                     struct ra_supp_struct *s,
+                     struct ra_header_struct *header, /* [in] which channels were analyzed */
+                     struct ra_td *td                 /* [in] */
+                     ) {
+  struct DAPstruct *a, *r;
+  long int l;
+
+  if (s->dClips>0) {
+    if ( labs( td->clips.x - s->ref->clips.x ) > s->dClips ) return 1;
+    if ( labs( td->clips.y - s->ref->clips.y ) > s->dClips ) return 1;
+    }
+
+  for (l=1;l<=header->nCh;l++) { /* note..starting from 1 here! */
+    if (ra_isChBitSet(header->bChIn,l)) continue;
+    a = &(td->tdac[l-1]);
+    r = &(s->ref->tdac[l-1]);
+    if (s->rPower>0) {
+      if ( fabsf( a->xm2.mean - r->xm2.mean ) > s->rPower * fabsf(r->xm2.mean) ) return 1;
+      if ( fabsf( a->ym2.mean - r->ym2.mean ) > s->rPower * fabsf(r->ym2.mean) ) return 1;
+      }
+    if (s->dKurt>0) {
+      if ( fabsf( a->xi.k - r->xi.k ) > s->dKurt ) return 1;
+      if ( fabsf( a->xq.k - r->xq.k ) > s->dKurt ) return 1;
+      if ( fabsf( a->yi.k - r->yi.k ) > s->dKurt ) return 1;
+      if ( fabsf( a->yq.k - r->yq.k ) > s->dKurt ) return 1;
+      }
+    }
+
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_supp_check() ==========================================*/
+/*==============================================================*/
+/* called for each eType 1 report.  Returns 1 if it should be suppressed.  Otherwise returns 0, having set */
+/* header->err as described above and made this report the new reference. */
+
+int ra_supp_check(
+                   struct ra_supp_struct *s,
+                   struct ra_header_struct *header, /* [in/out] */
+                   struct ra_td *td                 /* [in] */
+                   ) {
+  int bHeartbeat;
+
+  if (!s->bOn) return 0;
+
+  if (s->bRef) {
+    bHeartbeat = ( header->fStart - s->fStartRef >= s->heartbeat - 1e-6 ); /* (tolerance for fStart being a sum of T0's) */
+    if ( !ra_supp_changed( s, header, td ) ) {
+      if (!bHeartbeat) {
+        s->nSuppressed++;
+        s->nSuppressedTotal++;
+        return 1;
+        }
+      header->err |= RA_H_ERR_HEARTBEAT;
+      }
+    }
+
+  header->err |= ( s->nSuppressed << RA_H_ERR_NSUPP_SHIFT );
+  memcpy( s->ref, td, sizeof(struct ra_td) );
+  s->fStartRef = header->fStart;
+  s->bRef = 1;
+  s->nSuppressed = 0;
+  s->nWritten++;
+  return 0;
+  }
+
+/*==============================================================*/
+/*=== ra_supp_seen() ===========================================*/
+/*==============================================================*/
+/* called for every report, of any eType, before anything else */
+
+void ra_supp_seen( struct ra_supp_struct *s, struct ra_header_struct *header ) {
+  if (s->bOn) memcpy( &(s->last), header, sizeof(struct ra_header_struct) );
+  }
+
+/*==============================================================*/
+/*=== ra_supp_close() ==========================================*/
+/*==============================================================*/
+/* if windows have been suppressed since the last report, returns 1 and fills header with an eType 0 report */
+/* saying how many (as if it were the next report); otherwise returns 0.  Frees memory. */
+
+int ra_supp_close(
+                   struct ra_supp_struct *s,
+                   struct ra_header_struct *header  /* [out] */
+                   ) {
+  int bPending;
+  if (!s->bOn) return 0;
+  printf("ra_supp_close(): %ld eType 1 reports written, %ld suppressed\n",s->nWritten,s->nSuppressedTotal);
+  bPending = (s->nSuppressed>0);
+  if (bPending) {
+    memcpy( header, &(s->last), sizeof(struct ra_header_struct) );
+    header->eType = RA_H_ETYPE_NULL;
+    header->iSeqNo++;
+    header->err   = ( s->nSuppressed << RA_H_ERR_NSUPP_SHIFT );
+    }
+  free(s->ref); s->ref = NULL;
+  s->bOn = 0;
+  return bPending;
+  }
+
+//==================================================================================
+//=== HISTORY ======================================================================
+//==================================================================================
+// ra_suppress.c: 2026 Oct 19
+// -- initial version
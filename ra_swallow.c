@@ -2,127 +2,179 @@
 ra_swallow.c: S.W. Ellingson, Virginia Tech, 2013 Jan 26
 ================================================================*/
 
+/*=======================================================*/
+/*=== ra_deinterleave_scalar() ==========================*/
+/*=======================================================*/
+/* ra_deinterleave(), a sample at a time; all of it without SSE2, and what's left over with it */
+
+void ra_deinterleave_scalar(
+                      signed char *xi,   /* [out] nSamples bytes each */
+                      signed char *xq,
+                      signed char *yi,
+                      signed char *yq,
+                      signed char *src,  /* [in] nSamples*RG_NPOL bytes */
+                      long int nSamples 
+                     ) {
+  long int n;
+  for (n=0;n<nSamples;n++) {
+    xi[n] = src[RG_NPOL*n+0];
+    xq[n] = src[RG_NPOL*n+1];
+    yi[n] = src[RG_NPOL*n+2];
+    yq[n] = src[RG_NPOL*n+3];
+    }
+  return;
+  }
+
+/*=======================================================*/
+/*=== ra_deinterleave() =================================*/
+/*=======================================================*/
+/* Copies nSamples samples (xi,xq,yi,yq interleaved, RG_NPOL bytes each) from src into four planes */
+/* With SSE2, 16 samples at a time: three rounds of byte unpacking and one of 64-bit unpacking */
+/*   transpose 4 x 16 samples into 16 xi's, 16 xq's, 16 yi's, 16 yq's */
+
+void ra_deinterleave(
+                      signed char *xi,   /* [out] nSamples bytes each */
+                      signed char *xq,
+                      signed char *yi,
+                      signed char *yq,
+                      signed char *src,  /* [in] nSamples*RG_NPOL bytes */
+                      long int nSamples 
+                     ) {
+  long int n = 0;
+#ifdef __SSE2__
+  __m128i a0,a1,a2,a3,b0,b1,b2,b3;
+  int r;
+  for (n=0;n+16<=nSamples;n+=16) {
+    a0 = _mm_loadu_si128( (__m128i *) &(src[RG_NPOL*n     ]) );
+    a1 = _mm_loadu_si128( (__m128i *) &(src[RG_NPOL*n + 16]) );
+    a2 = _mm_loadu_si128( (__m128i *) &(src[RG_NPOL*n + 32]) );
+    a3 = _mm_loadu_si128( (__m128i *) &(src[RG_NPOL*n + 48]) );
+    for (r=0;r<3;r++) {
+      b0 = _mm_unpacklo_epi8(a0,a1); b1 = _mm_unpackhi_epi8(a0,a1);
+      b2 = _mm_unpacklo_epi8(a2,a3); b3 = _mm_unpackhi_epi8(a2,a3);
+      a0 = b0; a1 = b1; a2 = b2; a3 = b3;
+      }
+    _mm_storeu_si128( (__m128i *) &(xi[n]), _mm_unpacklo_epi64(a0,a2) );
+    _mm_storeu_si128( (__m128i *) &(xq[n]), _mm_unpackhi_epi64(a0,a2) );
+    _mm_storeu_si128( (__m128i *) &(yi[n]), _mm_unpacklo_epi64(a1,a3) );
+    _mm_storeu_si128( (__m128i *) &(yq[n]), _mm_unpackhi_epi64(a1,a3) );
+    }
+#endif
+  ra_deinterleave_scalar( xi+n, xq+n, yi+n, yq+n, src+RG_NPOL*n, nSamples-n ); /* what's left (or everything, without SSE2) */
+  return;
+  }
+
+/*=======================================================*/
+/*=== ra_swallow_window() ===============================*/
+/*=======================================================*/
+/* analyzes one T0 window and advances *fstart */
+
+void ra_swallow_window(
+                struct ra_header_struct *header0, /* [in] */
+                struct ra_plan_struct *plan,      /* [in] */
+                struct ra_win_struct *win,        /* [in] the window */
+                long int nT0,                     /* [in] */
+                float chan_bw,                    /* [in] CHAN_BW */
+                struct ra_out_struct *out,        /* [in] */
+                double *fstart                    /* [in/out] */
+                ) {
+
+  ra_analyze( header0, plan, win, nT0, out, *fstart );
+
+  /* advance the absolute time tracking variable */
+  (*fstart) += ( nT0 * (1.0e-6) / fabs(chan_bw) ); 
+  //printf("ra_swallow: *fstart=%f\n",*fstart);
+
+  return;
+  }
+
+/*=======================================================*/
+/*=== ra_swallow_avail() ================================*/
+/*=======================================================*/
+/* samples per channel in a GUPPI block, excluding the overlap samples at the end */
+
+long int ra_swallow_avail(
+                int obsnchan,                     /* [in] OBSNCHAN */
+                int overlap                       /* [in] OVERLAP */
+                ) {
+  return RG_BLK_SIZE/obsnchan/RG_NPOL - overlap;
+  }
+
 /*=======================================================*/
 /*=== ra_swallow() ======================================*/
 /*=======================================================*/
-/* Copies sections of raw sample block into a buffer for analysis */ 
-/* Launches analysis once buffer is filled */
-/* Note buffer is identical to raw sample block, except: */
+/* Analyzes the T0 windows in a raw sample block */ 
+/* The overlap samples at the end of each channel are skipped, so windows are consecutive in time */
+/* Windows that lie entirely within blk are analyzed in place (see ra_plan.c).  The start of a window */
+/* that doesn't fit in blk is saved in a buffer (blk0), and analyzed along with the rest of it in the */
+/* next block.  In blk0: */
 /* -- unneeded channels are not copied */
-/* -- overlap bytes are stripped off (so, each channel is represented by (RG_NDIM-overlap)*RG_NPOL bytes as opposed to RG_NDIM*RG_NPOL bytes */
+/* -- each channel is represented by nT0*RG_NPOL bytes, as opposed to RG_NDIM*RG_NPOL bytes (see ra_plan.c) */
+/* -- within a channel, samples are deinterleaved into planes of nT0 xi's, nT0 xq's, nT0 yi's, and nT0 yq's */
+/* blk may also be a piece of a block (MAX_MEMORY; see ra_mem.c); it's the same, except that nAvail is smaller */
 
 int ra_swallow( 
                 signed char *blk,                 /* [in]  data block from GUPPI raw data file (source) */
                 struct ra_header_struct *header0, /* [in] prototype report output header; defines which analyses are done */
-                signed char *blk0,                /* [in/out] buffer (destination) */
-                long int *blk0_ptr,               /* [in/out] position within buffer (where next byte should go) FIXME: Now works like ch_ptr */
+                struct ra_plan_struct *plan,      /* [in] channels to be analyzed, and where they go (see ra_plan.c) */
+                signed char *blk0,                /* [in/out] buffer for the start of a window that crosses into the next block */
+                long int *blk0_ptr,               /* [in/out] bytes per channel (RG_NPOL per sample) of that window in blk0 */
                 long int nT0,                     /* [in] the length of the T0 buffer in samples (1 sample = RG_NPOL bytes) */
-                int obsnchan,                     /* [in] OBSNCHAN */
+                long int nAvail,                  /* [in] samples per channel in blk, excluding overlap (see ra_swallow_avail()) */
                 float chan_bw,                    /* [in] CHAN_BW */
-                int overlap,                      /* [in] OVERLAP */
-                FILE *fp_out,			  /* [in] Where output should go.  This is passed to ra_analyze() */
+                struct ra_out_struct *out,        /* [in] Where output should go.  This is passed to ra_analyze() */
                 double *fstart                    /* keeping track of absolute time relative to start of run */				
                 ) {
 
-    long int nBytesPerChannel_no; /* number of bytes per channel, excluding overlap */
-    long int nBytesToMove;        /* number of bytes that will be moved from src to dest */
-    long int ch_ptr = 0;          /* keeping track of where we are within a channel; i.e. this counts 0..RG_NDIM*RG_NPOL */
-    long int blk0_n = 0;          /* total number of bytes in dest buffer */
-    int bDone = 0;           
-    int bBufferFull = 0;
+    long int ch_ptr = 0;          /* keeping track of where we are within a channel, in samples */
+    long int nSaved;              /* number of samples per channel already in blk0 */
+    struct ra_win_struct win;
  
     /* scratch */
-    long int l;
+    long int k;
+    signed char *x;
+    long int t;
 
     /* initialize */
-    nBytesPerChannel_no = (RG_NDIM-overlap)*RG_NPOL; 
-    ch_ptr = 0;
-    blk0_n = nT0 * obsnchan * RG_NPOL;  
-    bDone = 0;
+    nSaved = (*blk0_ptr)/RG_NPOL;
+    win.blk0 = blk0;
 
     //printf("ra_swallow():\n");
-    //printf("  On entry, *blk0_ptr = %ld, so buffer %f percent full\n",*blk0_ptr,100*((float)*blk0_ptr)/blk0_n);
-    // //printf("nT0                =%ld [in]; this is %f s\n",nT0,nT0/header0->fs);
-    // //printf("nBytesPerChannel_no=%ld\n",nBytesPerChannel_no);
-    // //printf("blk0_n             =%ld (RG_BLK_SIZE=%d,obsnchan*RG_NDIM*RG_NPOL=%d)\n",blk0_n,RG_BLK_SIZE,obsnchan*RG_NDIM*RG_NPOL);
-
-    /* loop 'til done */
-    while (!bDone) { /* we're going to loop until we have exhausted the input data block */
-
-      /* figure out how many bytes to move, if any. */
-      nBytesToMove = nBytesPerChannel_no;                         /* by default, we move all bytes except overlap, channel at a time, from blk to blk0 */
-      if ( ((*blk0_ptr+nBytesToMove)*obsnchan) >= blk0_n ) {    /* If this causes us to overrun the blk0 (dest) buffer, */
-        nBytesToMove = blk0_n/obsnchan - *blk0_ptr;             /* ... then we move only enough samples to fill the blk0 buffer */
-        }
-
-      if ( ((ch_ptr+overlap)*RG_NPOL+nBytesToMove) > (RG_BLK_SIZE/obsnchan) ) {   /* If this causes us to overrun the blk (source) buffer, */
-        nBytesToMove = RG_BLK_SIZE/obsnchan - (ch_ptr+overlap)*RG_NPOL ;           /* ... then we move only the remaining samples */            
-        bDone = 1;                                                                 /* ... set flag to remember */
-        }
-
-      /* now we check to see if the dest buffer will overflow. */
-      /*  We do it here because nBytesToMove may have changed in the src buffer overflow check */    
-      if ( (((*blk0_ptr)+nBytesToMove)*obsnchan) >= blk0_n ) {     /* If this causes us to overrun the blk0 (dest) buffer, */
-        bBufferFull = 1;                                          /* ... set flag to remember */
-        }
-
-      //printf("  Moving %ld S/ch (%f pct of input block) *blk0_ptr=%ld ch_ptr*RG_NPOL=%ld\n",nBytesToMove/RG_NPOL,100*((float)nBytesToMove*obsnchan)/(RG_BLK_SIZE-overlap*obsnchan*RG_NPOL),*blk0_ptr,ch_ptr*RG_NPOL);
-      //printf("  blk0[%ld]=%d blk0[ 10*RG_NDIM*RG_NPOL + 0 + RG_NPOL*0]=%d\n",*blk0_ptr, ((int) blk0[*blk0_ptr]),(int)blk0[ 10*RG_NDIM*RG_NPOL + 0 + RG_NPOL*0]);
-
-      /* Loop over channels, moving data from blk to blk0 */
-      for (l=1;l<=obsnchan;l++) { /* note..starting from 1 here! */
-        if (!ra_isChBitSet(header0->bChIn,l)) { /* if channel bit is not set, then we do this one */     
-          //printf("*blk0_ptr=%ld,ch_ptr=%ld, nBytesToMove=%ld, bBufferFull=%d, bDone=%d, l=%ld",*blk0_ptr,ch_ptr,nBytesToMove,bBufferFull,bDone,l); fflush(stdout);
-          //memcpy( &(blk0[*blk0_ptr]),                                /* (dest) pointer to current location in sample buffer */
-          //        &(blk [ (l-1)*RG_NDIM*RG_NPOL + ch_ptr*RG_NPOL ] ), /* (src)  pointer to channel start location in sample block */ 
-          //        nBytesToMove                                        /* number of samples to move */     
-          //      );
-          memcpy( &(blk0[ (l-1)*(RG_NDIM-overlap)*RG_NPOL + *blk0_ptr      ] ), /* (dest) pointer to current location in sample buffer */
-                  &(blk [ (l-1)* RG_NDIM         *RG_NPOL + ch_ptr*RG_NPOL ] ), /* (src)  pointer to channel start location in sample block */ 
-                  nBytesToMove                                        /* number of samples to move */     
-                );
-          //printf(".\n");  fflush(stdout);
-          } /* if (!ra_isChBitSet(header0->bChIn,l)) */
-        } /* for l */
-
-      //printf("  blk0[%ld]=%d blk0[ 10*RG_NDIM*RG_NPOL + 0 + RG_NPOL*0]=%d\n",*blk0_ptr, ((int) blk0[*blk0_ptr]),(int)blk0[ 10*RG_NDIM*RG_NPOL + 0 + RG_NPOL*0]);
-
-      /* advance block pointers */
-      ch_ptr   +=  (nBytesToMove/RG_NPOL); 
-      *blk0_ptr +=  nBytesToMove; 
-
-      /* If we hit the end of the buffer, time to do analysis */
-      if (bBufferFull) {
-
-        //printf("  running ra_analyze()\n");
-        // //printf("xi(0) = %f\n",(float) blk0[ 10*RG_NDIM*RG_NPOL + 0 + RG_NPOL*0]);
-        ra_analyze( header0,
-                    blk0,
-                    nT0, 
-                    fp_out,
-                    *fstart
-                    //obsnchan,                   /* [in] OBSNCHAN */
-                    //chan_bw                     /* [in] CHAN_BW */
-                  );
-
-        /* advance the absolute time tracking variable */
-        (*fstart) += ( nT0 * (1.0e-6) / fabs(chan_bw) ); 
-        //printf("ra_swallow: *fstart=%f\n",*fstart);
-
-        /* reset buffer */
-        *blk0_ptr = 0;   /* reset pointer */
-        bBufferFull = 0; /* reset flag */
-
-        } /* if (bBufferFull)  */    
-     
-      ///* figure out if we are done with blk */
-      ///* this should rarely happen, since normally bDone would be set as the result of a input block overrun (above) */
-      //if ( ch_ptr >= RG_NDIM-overlap ) {
-      //  bDone=1;  
-      //  printf("  Found ch_ptr >= RG_NDIM-overlap (?)\n");
-      //  }
-
-      } /* while (!bDone) */
+    //printf("  On entry, *blk0_ptr = %ld, so buffer %f percent full\n",*blk0_ptr,100*((float)*blk0_ptr)/plan->nBytesPerCh);
+
+    /* finish the window begun in the previous block, if any */
+    /* (if T0 is longer than what's left of a block, it won't be finished; then all of blk is saved, below) */
+    if ( (nSaved>0) && (nSaved+nAvail>=nT0) ) {
+      win.nSeg = 2;
+      win.seg[0].blk = NULL; win.seg[0].n0 = 0; win.seg[0].n = nSaved;
+      win.seg[1].blk = blk;  win.seg[1].n0 = 0; win.seg[1].n = nT0-nSaved;
+      ra_swallow_window( header0, plan, &win, nT0, chan_bw, out, fstart );
+      ch_ptr = nT0-nSaved;
+      nSaved = 0;
+      }
+
+    /* windows entirely within blk */
+    while (ch_ptr+nT0<=nAvail) {
+      win.nSeg = 1;
+      win.seg[0].blk = blk; win.seg[0].n0 = ch_ptr; win.seg[0].n = nT0;
+      ra_swallow_window( header0, plan, &win, nT0, chan_bw, out, fstart );
+      ch_ptr += nT0;
+      }
+
+    /* save the start of the next window */
+    if (ch_ptr<nAvail) {
+      t = ra_prof_now();
+      for (k=0;k<plan->nCh;k++) {
+        x = &(blk0[ plan->offBlk0[k] + nSaved ]); /* (dest) current location in the xi plane of this channel */
+        ra_deinterleave( x, x+nT0, x+2*nT0, x+3*nT0,
+                         &(blk [ plan->offBlk [k] + ch_ptr*RG_NPOL ] ), /* (src)  pointer to channel start location in sample block */ 
+                         nAvail-ch_ptr                                  /* number of samples to move */     
+                        );
+        } /* for k */
+      nSaved += nAvail-ch_ptr;
+      RA_PROF_ADD(RA_PROF_COPY,t);
+      }
+    *blk0_ptr = nSaved*RG_NPOL;
 
     return 0;
     }
@@ -130,6 +182,21 @@ int ra_swallow(
 //==================================================================================
 //=== HISTORY ======================================================================
 //==================================================================================
+// ra_swallow.c: 2026 Oct 19
+// -- ra_deinterleave_scalar(), so the SSE2 and scalar paths can be compared (frsc_bench)
+// ra_swallow.c: 2026 Oct 19
+// -- takes nAvail (ra_swallow_avail()) instead of OBSNCHAN and OVERLAP, so blk can be a piece of a block
+// ra_swallow.c: 2026 Oct 19
+// -- profiling (ra_prof.c)
+// ra_swallow.c: 2026 Oct 19
+// -- windows within a block are analyzed in place; only the start of a window that crosses into the next
+//    block is copied to blk0 (ra_swallow_window(); see ra_plan.c)
+// ra_swallow.c: 2026 Oct 19
+// -- deinterleaves samples into xi, xq, yi, yq planes while copying (ra_deinterleave())
+// ra_swallow.c: 2026 Oct 19
+// -- loops over the channel plan (ra_plan.c); fixed T0 buffer layout, which had channels written at a
+//    stride of (RG_NDIM-overlap)*RG_NPOL bytes (far past the end of the buffer) and read by ra_analyze()
+//    at a stride of RG_NDIM*RG_NPOL bytes
 // ra_swallow.c: S.W. Ellingson, Virginia Tech, 2013 Jan 26
 // -- commented out diagnostic printf's
 // ra_swallow.c: S.W. Ellingson, Virginia Tech, 2013 Dec 04